@@ -0,0 +1,317 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pljit/Pljit/Pljit.h"
+
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace jit;
+//---------------------------------------------------------------------------
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// makeLongChain            Creates a function returning 'first op operand op operand ...' with the given number of terms, i.e. an expression of depth 'terms'
+string makeLongChain(size_t terms, const string& op, const string& operand) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN a";
+
+    for (size_t i = 1; i < terms; ++i)
+        code += " " + op + " " + operand;
+
+    return code + "\nEND.\n";
+}
+
+// makeNestedParentheses    Creates a function returning '(((a + 1) + 1) ...)' with the given number of nested parentheses
+string makeNestedParentheses(size_t depth) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN " + string(depth, '(') + "a";
+
+    for (size_t i = 0; i < depth; ++i)
+        code += " + 1)";
+
+    return code + "\nEND.\n";
+}
+
+// makeDivisionChain       Creates a function returning 'a + (b + 1) / 7 + (b + 2) / 7 ...' with the given number of terms, i.e. divisions by a constant
+string makeDivisionChain(size_t terms) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN a";
+
+    for (size_t i = 1; i < terms; ++i)
+        code += " + (b + " + to_string(i) + ") / 7";
+
+    return code + "\nEND.\n";
+}
+
+// makeWideSum             Creates a function returning '(a + 1) / b + (a + 2) / b + ...' with the given number of terms, i.e. a sum of independent terms
+string makeWideSum(size_t terms) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN (a + 1) / b";
+
+    for (size_t i = 2; i <= terms; ++i)
+        code += " + (a + " + to_string(i) + ") / b";
+
+    return code + "\nEND.\n";
+}
+
+// makeAffineStatements    Creates a function with the given number of statements 'x := x * 3 + b - 2 * c + d', i.e. an affine function of its parameters
+string makeAffineStatements(size_t statements) {
+
+    string code = "PARAM a, b, c, d;\nVAR x;\nBEGIN\nx := a;\n";
+
+    for (size_t i = 0; i < statements; ++i)
+        code += "x := x * 3 + b - 2 * c + d;\n";
+
+    return code + "RETURN x\nEND.\n";
+}
+
+// makePiecewise           Creates a function with the given number of statements 'x := IF x < c THEN ... ELSE ...' clamping and reshaping x piecewise, i.e. a chain of selections
+string makePiecewise(size_t statements) {
+
+    string code = "PARAM a, b;\nVAR x;\nBEGIN\nx := a;\n";
+
+    for (size_t i = 1; i <= statements; ++i)
+        code += "x := IF x < " + to_string(i) + " THEN MAX(x, -b) + 2 ELSE MIN(x * 2, b) - ABS(x - " + to_string(i) + ") / 3;\n";
+
+    return code + "RETURN x\nEND.\n";
+}
+
+// makeRules               Creates the given number of functions sharing the subexpression 's', which is computed from their parameters in the same way
+vector<string> makeRules(size_t rules) {
+
+    vector<string> sources{};
+
+    for (size_t i = 1; i <= rules; ++i)
+        sources.push_back("PARAM a, b, c;\nVAR s;\nBEGIN\ns := (a + b) * (b + c) / (c + 1) + (a * a - b * c) / (a + 7);\nRETURN s * " + to_string(i) +
+                          " + (a - c) / " + to_string(i + 1) + "\nEND.\n");
+
+    return sources;
+}
+
+// makeOutputs             Creates a function returning the given number of values computed from the shared subexpression 's' (see makeRules)
+string makeOutputs(size_t outputs) {
+
+    string code = "PARAM a, b, c;\nVAR s;\nBEGIN\ns := (a + b) * (b + c) / (c + 1) + (a * a - b * c) / (a + 7);\nRETURN ";
+
+    for (size_t i = 1; i <= outputs; ++i)
+        code += (i > 1 ? ", s * " : "s * ") + to_string(i) + " + (a - c) / " + to_string(i + 1);
+
+    return code + "\nEND.\n";
+}
+
+// makeStages              Creates the given number of small functions of the parameters 'a', 'b' and the result 'x' of the previous stage
+vector<string> makeStages(size_t stages) {
+
+    vector<string> sources{};
+
+    for (size_t i = 1; i <= stages; ++i)
+        sources.push_back("PARAM a, b, x;\nBEGIN\nRETURN (x * " + to_string(i + 1) + " + a * b) / " + to_string(i + 2) + " - b\nEND.\n");
+
+    return sources;
+}
+
+// runBenchmark             Registers the given source code, measures the first call (which includes the compilation) and the average time of the following calls
+void runBenchmark(const string& name, const string& source, const vector<int64_t>& args, size_t iterations, size_t profileSamples = 0, bool memoised = false) {
+
+    Pljit jit{Pljit::defaultMaxNestingDepth, profileSamples};
+    auto handle = jit.registerFunction(source);
+
+    if (memoised)
+        jit.memoise(handle);
+
+    auto start = Clock::now();
+    auto result = handle(args);
+    auto compiled = Clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        result = handle(args);
+
+    auto end = Clock::now();
+
+    double compileMs = chrono::duration<double, milli>(compiled - start).count();
+    double callUs = iterations ? chrono::duration<double, micro>(end - compiled).count() / static_cast<double>(iterations) : 0.0;
+
+    cout << left << setw(36) << name << right << setw(14) << fixed << setprecision(2) << compileMs << " ms" << setw(14) << callUs << " us"
+         << "    result: " << (result ? to_string(*result) : "error") << endl;
+}
+
+// runManyBenchmark         Registers the given sources and measures the average time of calling all of them with the same arguments, one by one and with evaluateMany
+void runManyBenchmark(const string& name, const vector<string>& sources, const vector<int64_t>& args, size_t iterations) {
+
+    Pljit jit{};
+    vector<Pljit::PljitHandle> handles{};
+
+    for (const string& source : sources)
+        handles.push_back(jit.registerFunction(source));
+
+    // One by one
+    auto start = Clock::now();
+    optional<int64_t> result{};
+
+    for (auto& handle : handles)
+        result = handle(args);
+
+    auto compiled = Clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        for (auto& handle : handles)
+            result = handle(args);
+
+    auto end = Clock::now();
+
+    double compileMs = chrono::duration<double, milli>(compiled - start).count();
+    double callUs = chrono::duration<double, micro>(end - compiled).count() / static_cast<double>(iterations);
+
+    cout << left << setw(36) << name + ", one by one" << right << setw(14) << fixed << setprecision(2) << compileMs << " ms" << setw(14) << callUs << " us"
+         << "    result: " << (result ? to_string(*result) : "error") << endl;
+
+    // Fused
+    vector<optional<int64_t>> results{};
+
+    start = Clock::now();
+    jit.evaluateMany(handles, args, results);
+    compiled = Clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        jit.evaluateMany(handles, args, results);
+
+    end = Clock::now();
+
+    compileMs = chrono::duration<double, milli>(compiled - start).count();
+    callUs = chrono::duration<double, micro>(end - compiled).count() / static_cast<double>(iterations);
+    result = results.back();
+
+    cout << left << setw(36) << name + ", fused" << right << setw(14) << fixed << setprecision(2) << compileMs << " ms" << setw(14) << callUs << " us"
+         << "    result: " << (result ? to_string(*result) : "error") << endl;
+}
+
+// runResultsBenchmark      Registers the given function returning several values and measures the average time of calls writing all of them into a reused vector
+void runResultsBenchmark(const string& name, const string& source, const vector<int64_t>& args, size_t iterations) {
+
+    Pljit jit{};
+    auto handle = jit.registerFunction(source);
+    vector<int64_t> results{};
+
+    auto start = Clock::now();
+    bool valid = handle(args, results);
+    auto compiled = Clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        valid = handle(args, results);
+
+    auto end = Clock::now();
+
+    double compileMs = chrono::duration<double, milli>(compiled - start).count();
+    double callUs = chrono::duration<double, micro>(end - compiled).count() / static_cast<double>(iterations);
+
+    cout << left << setw(36) << name << right << setw(14) << fixed << setprecision(2) << compileMs << " ms" << setw(14) << callUs << " us"
+         << "    result: " << (valid ? to_string(results.back()) : "error") << endl;
+}
+
+// runPipelineBenchmark     Registers the given sources and measures the average time of passing the result of each function to the parameter 'x' (the last one) of the
+//                          next function, chained through the handles and composed into one function
+void runPipelineBenchmark(const string& name, const vector<string>& sources, const vector<int64_t>& args, size_t iterations) {
+
+    Pljit jit{};
+    vector<Pljit::PljitHandle> handles{};
+
+    for (const string& source : sources)
+        handles.push_back(jit.registerFunction(source));
+
+    // Chained through the handles
+    auto chain = [&handles, &args]() {
+
+        optional<int64_t> result = handles.front()(args);
+
+        for (size_t i = 1; i < handles.size() && result; ++i) {
+            vector<int64_t> stageargs = args;
+            stageargs.back() = *result;
+            result = handles[i](move(stageargs));
+        }
+
+        return result;
+    };
+
+    auto start = Clock::now();
+    optional<int64_t> result = chain();
+    auto compiled = Clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        result = chain();
+
+    auto end = Clock::now();
+
+    double compileMs = chrono::duration<double, milli>(compiled - start).count();
+    double callUs = chrono::duration<double, micro>(end - compiled).count() / static_cast<double>(iterations);
+
+    cout << left << setw(36) << name + ", chained" << right << setw(14) << fixed << setprecision(2) << compileMs << " ms" << setw(14) << callUs << " us"
+         << "    result: " << (result ? to_string(*result) : "error") << endl;
+
+    // Composed, the composed function takes the arguments of the first function and the other arguments of every further function
+    vector<int64_t> composedargs = args;
+
+    for (size_t i = 1; i < handles.size(); ++i)
+        composedargs.insert(composedargs.end(), args.begin(), args.end() - 1);
+
+    auto composed = jit.compose(handles, vector<size_t>(handles.size() - 1, args.size() - 1));
+
+    start = Clock::now();
+    result = composed(composedargs);
+    compiled = Clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        result = composed(composedargs);
+
+    end = Clock::now();
+
+    compileMs = chrono::duration<double, milli>(compiled - start).count();
+    callUs = chrono::duration<double, micro>(end - compiled).count() / static_cast<double>(iterations);
+
+    cout << left << setw(36) << name + ", composed" << right << setw(14) << fixed << setprecision(2) << compileMs << " ms" << setw(14) << callUs << " us"
+         << "    result: " << (result ? to_string(*result) : "error") << endl;
+}
+
+} // namespace
+
+int main() {
+
+    cout << left << setw(36) << "benchmark" << right << setw(17) << "compile + call" << setw(17) << "per call" << endl;
+
+    // Expressions of depth 100000 (the grammar is right recursive, so long chains result in deep trees)
+    runBenchmark("sum, 100k terms", makeLongChain(100000, "+", "b"), {1, 2}, 100);
+    runBenchmark("difference, 100k terms", makeLongChain(100000, "-", "b"), {1, 2}, 100);
+    runBenchmark("product, 100k terms", makeLongChain(100000, "*", "b"), {3, 1}, 100);
+    runBenchmark("mixed, 100k terms", makeLongChain(100000, "+", "b * a / b"), {3, 2}, 100);
+
+    // Divisions by constants
+    runBenchmark("division by constant, 10k terms", makeDivisionChain(10000), {1, 1000}, 1000);
+
+    // Sums of independent terms, that are not serialised by the right recursive grammar after balancing
+    runBenchmark("wide sum, 10k terms", makeWideSum(10000), {1, 3}, 1000);
+    runBenchmark("wide sum, 10k terms, profiled", makeWideSum(10000), {1, 3}, 1000, 10);
+    runBenchmark("wide sum, 10k terms, memoised", makeWideSum(10000), {1, 3}, 1000, 0, true);
+
+    // Statements computing an affine function of the parameters
+    runBenchmark("affine statements, 1k statements", makeAffineStatements(1000), {1, 2, 3, 4}, 1000);
+
+    // Piecewise functions, whose alternatives are selected without branches
+    runBenchmark("piecewise, 1k statements", makePiecewise(1000), {3, 1000}, 1000);
+
+    // Functions evaluated on the same arguments
+    runManyBenchmark("200 rules", makeRules(200), {3, 5, 7}, 1000);
+    runResultsBenchmark("200 rules, one function", makeOutputs(200), {3, 5, 7}, 1000);
+
+    // Small functions chained into a pipeline
+    runPipelineBenchmark("pipeline, 8 stages", makeStages(8), {3, 5, 7}, 100000);
+
+    // Nested parentheses up to the default nesting limit
+    runBenchmark("parentheses, depth 1000", makeNestedParentheses(Pljit::defaultMaxNestingDepth), {1, 2}, 1000);
+
+    return 0;
+}
+//---------------------------------------------------------------------------
@@ -1,40 +1,64 @@
 #include "pljit/CodeManagement/SourceCodeManager.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace jit {
 
-SourceCodeManager::SourceCodeManager(const string &sourceCode) : code{sourceCode} {
+const vector<size_t>& SourceCodeManager::getLines() const {
+
+    call_once(linesInitialised, [this]() {
 
-    if (code.empty()) {
-        noflines = 0;
-        return;
-    }
+        if (code.empty())
+            return;
 
-    noflines = 1;
+        size_t pos = 0;
+        lines.push_back(0);
 
-    size_t pos = 0;
-    lines.push_back(0);
+        while (pos < code.size()) {
+            pos = code.find('\n', pos);
+            if (pos == string::npos) {
+                lines.push_back(code.size());
+                return;
+            }
 
-    while (pos < code.size()) {
-        pos = code.find('\n', pos);
-        if (pos == string::npos) {
-            lines.push_back(code.size());
-            return;
+            lines.push_back(pos + 1);
+            ++pos;
         }
+    });
+
+    return lines;
+}
+
+size_t SourceCodeManager::getLine(const SourceCodeReference& ref) const {
+
+    const vector<size_t>& l = getLines();
 
-        lines.push_back(pos + 1);
-        ++noflines;
-        ++pos;
-    }
+    // The line is the number of line start positions up to (and including) the referenced position
+    return static_cast<size_t>(upper_bound(l.begin(), l.end(), ref.offset) - l.begin());
+}
+
+size_t SourceCodeManager::getPosition(const SourceCodeReference& ref) const {
+
+    size_t line = getLine(ref);
+
+    return line == 0 ? ref.offset + 1 : ref.offset - getLines()[line - 1] + 1;
 }
 
 void SourceCodeManager::printErrorMessage(const string& message, const SourceCodeReference& location) const {
 
-    cerr << location.line << ":" << location.position << ":  " << message << endl;
-    cerr << code.substr(lines[location.line - 1], lines[location.line] - lines[location.line - 1]);
+    const vector<size_t>& l = getLines();
+
+    size_t line = getLine(location);
+    size_t position = getPosition(location);
+
+    cerr << line << ":" << position << ":  " << message << endl;
+
+    if (line >= 1 && line < l.size())
+        cerr << code.substr(l[line - 1], l[line] - l[line - 1]);
 
-    for (size_t i = 1; i < location.position; ++i)
+    for (size_t i = 1; i < position; ++i)
         cerr << ' ';
 
     cerr << '^';
@@ -53,4 +77,4 @@ string_view SourceCodeManager::getString(const SourceCodeReference &loc) const {
 
 
 
-} // namespace jit
\ No newline at end of file
+} // namespace jit
@@ -1,7 +1,11 @@
 #ifndef PLJIT_SOURCECODEMANAGER_H
 #define PLJIT_SOURCECODEMANAGER_H
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -9,27 +13,36 @@ namespace jit {
 
 
 // SourceCode Reference         Represents a reference into source code. Can be used in combination with SourceCodeManager objects
+//                              The reference only stores the absolute position, line and position within the line are determined by the SourceCodeManager on demand.
+//                              Both values are stored with 32 bits, as the reference is part of every token and node, so source code strings must not exceed maxOffset characters
 struct SourceCodeReference {
 
-    // Constructor              Initialises a Reference to a position in a source code string determined by line number, position within that line and the length (in characters) of
-    //                          the reference
-    SourceCodeReference(size_t line, size_t position, size_t range = 1) : line{line}, position{position}, range{range} {}
+    static constexpr size_t maxOffset = std::numeric_limits<uint32_t>::max();     // The maximal absolute position (and length) a reference can represent
+
+    // Constructor              Initialises a Reference to a position in a source code string determined by the absolute position (i.e. the offset from the start of the string)
+    //                          and the length (in characters) of the reference
+    explicit SourceCodeReference(size_t offset, size_t range = 1) : offset{narrow(offset)}, range{narrow(range)} {}
 
     // Constructor              Initialises a Reference with the start position of a given reference and a length
-    SourceCodeReference(SourceCodeReference c, size_t range) : line{c.line}, position{c.position}, range{range} {}
+    SourceCodeReference(SourceCodeReference c, size_t range) : offset{c.offset}, range{narrow(range)} {}
+
+    uint32_t offset;            // The absolute position in the source code, the reference refers to
+    uint32_t range;             // The number of characters the reference covers starting with the position defined by the parameter 'offset'
+
+    private:
 
-    const size_t line;          // The line in the source code, the reference refers to
-    const size_t position;      // The relative position in the line, the reference refers to
-    const size_t range;         // The number of characters the reference covers starting with the position defined by the parameters 'line' and 'position'
+    static uint32_t narrow(size_t value) { assert(value <= maxOffset); return static_cast<uint32_t>(value); }
 };
 
+static_assert(sizeof(SourceCodeReference) == 8, "SourceCodeReference is expected to be packed into 8 bytes");
+
 // SourceCodeManager            Represents a string as as source code object
 class SourceCodeManager {
 
     public:
 
     // Constructor
-    explicit SourceCodeManager(const std::string& sourceCode);
+    explicit SourceCodeManager(const std::string& sourceCode) : code{sourceCode} {}
 
     // printErrorMessage        Prints a given message in the context of a given source code reference
     void printErrorMessage(const std::string& message, const SourceCodeReference& location) const;
@@ -37,15 +50,25 @@ class SourceCodeManager {
     // getString                Returns a string view object belonging to the given source code reference
     std::string_view getString(const SourceCodeReference& loc) const;
 
-    // getabsolutePosition      Returns the absolute position in the source code string for a given line and position in that line
-    size_t getabsolutePosition(const SourceCodeReference& ref) const { return lines[ref.line - 1] + ref.position - 1; }
+    // getabsolutePosition      Returns the absolute position in the source code string for a given reference
+    size_t getabsolutePosition(const SourceCodeReference& ref) const { return ref.offset; }
+
+    // getLine                  Returns the line (starting with 1) the given reference refers to
+    size_t getLine(const SourceCodeReference& ref) const;
+
+    // getPosition              Returns the position within its line (starting with 1) the given reference refers to
+    size_t getPosition(const SourceCodeReference& ref) const;
 
     private:
 
     std::string_view code;              // A reference to the source code string
 
-    size_t noflines{0};                 // Number of lines of the managed source code string
-    std::vector<size_t> lines{};        // A vector storing the absolute positions of the start points of each line in the source code
+    // The line index is only needed for error messages, so it is created on first use (possibly concurrently by several evaluating threads)
+    mutable std::once_flag linesInitialised{};
+    mutable std::vector<size_t> lines{};        // A vector storing the absolute positions of the start points of each line in the source code
+
+    // getLines                 Returns the line index, creates it if necessary
+    const std::vector<size_t>& getLines() const;
 };
 
 } // namespace jit
@@ -0,0 +1,93 @@
+#ifndef PLJIT_ARITHMETIC_H
+#define PLJIT_ARITHMETIC_H
+
+#include <cstdint>
+#include <limits>
+
+namespace jit {
+
+// The arithmetic of the language is defined on 64 bit two's complement integers, results that are out of range wrap around.
+// All evaluators and optimisations use these functions, so that folding at compile time always gives the same result as evaluating at run time.
+
+// wrappingAdd                          Returns lhs + rhs (modulo 2^64)
+inline int64_t wrappingAdd(int64_t lhs, int64_t rhs) { return static_cast<int64_t>(static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs)); }
+
+// wrappingSub                          Returns lhs - rhs (modulo 2^64)
+inline int64_t wrappingSub(int64_t lhs, int64_t rhs) { return static_cast<int64_t>(static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs)); }
+
+// wrappingMul                          Returns lhs * rhs (modulo 2^64)
+inline int64_t wrappingMul(int64_t lhs, int64_t rhs) { return static_cast<int64_t>(static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs)); }
+
+// wrappingNeg                          Returns -value (modulo 2^64), i.e. the minimal value is mapped to itself
+inline int64_t wrappingNeg(int64_t value) { return static_cast<int64_t>(0 - static_cast<uint64_t>(value)); }
+
+// wrappingDiv                          Returns lhs / rhs rounded towards zero. The only overflowing case (minimal value / -1) wraps around to the minimal value.
+//                                      The divisor must not be zero
+inline int64_t wrappingDiv(int64_t lhs, int64_t rhs) { return rhs == -1 ? wrappingNeg(lhs) : lhs / rhs; }
+
+// wrappingAbs                          Returns |value| (modulo 2^64), i.e. the minimal value is mapped to itself. The sign mask (0 or all ones) avoids a branch
+inline int64_t wrappingAbs(int64_t value) {
+
+    uint64_t mask = static_cast<uint64_t>(value >> 63);
+    return static_cast<int64_t>((static_cast<uint64_t>(value) ^ mask) - mask);
+}
+
+// select                               Returns 'whenTrue', if the condition holds, otherwise 'whenFalse'. Blends both values with a mask instead of branching, so that the
+//                                      time does not depend on the (possibly unpredictable) condition
+inline int64_t select(bool condition, int64_t whenTrue, int64_t whenFalse) {
+
+    uint64_t mask = 0 - static_cast<uint64_t>(condition);
+    return static_cast<int64_t>(static_cast<uint64_t>(whenFalse) ^ ((static_cast<uint64_t>(whenTrue) ^ static_cast<uint64_t>(whenFalse)) & mask));
+}
+
+// branchFreeMin                        Returns the smaller one of the given values, selected without a branch
+inline int64_t branchFreeMin(int64_t lhs, int64_t rhs) { return select(rhs < lhs, rhs, lhs); }
+
+// branchFreeMax                        Returns the larger one of the given values, selected without a branch
+inline int64_t branchFreeMax(int64_t lhs, int64_t rhs) { return select(rhs > lhs, rhs, lhs); }
+
+// shiftLeft                            Returns value * 2^shift (modulo 2^64), the shift must be less than 64
+inline int64_t shiftLeft(int64_t value, int64_t shift) { return static_cast<int64_t>(static_cast<uint64_t>(value) << shift); }
+
+// divideByPowerOfTwo                   Returns value / 2^shift rounded towards zero without dividing, the shift must be between 1 and 63.
+//                                      Shifting to the right rounds towards negative infinity, so 2^shift - 1 is added to negative values before
+inline int64_t divideByPowerOfTwo(int64_t value, int64_t shift) {
+
+    uint64_t bias = static_cast<uint64_t>(value >> (shift - 1)) >> (64 - shift);
+    return wrappingAdd(value, static_cast<int64_t>(bias)) >> shift;
+}
+
+// multiplyHigh                         Returns the upper 64 bits of the 128 bit product lhs * rhs
+inline int64_t multiplyHigh(int64_t lhs, int64_t rhs) {
+
+    __extension__ using int128 = __int128;
+    return static_cast<int64_t>((static_cast<int128>(lhs) * rhs) >> 64);
+}
+
+// MagicNumber                          The data to divide by a constant with a multiplication instead of a division (see H. S. Warren, Hacker's Delight, chapter 10)
+struct MagicNumber {
+    int64_t factor;             // The value is multiplied by this factor, the upper 64 bits of the product are used
+    int64_t shift;              // The number of bits the product is shifted to the right afterwards
+    int64_t adjust;             // 1, if the value has to be added to the product, -1, if it has to be subtracted, 0 otherwise
+    int64_t divisor;            // The divisor the magic number belongs to
+};
+
+// divideByMagicNumber                  Returns value / divisor rounded towards zero, where the given magic number belongs to the divisor
+inline int64_t divideByMagicNumber(int64_t value, const MagicNumber& magic) {
+
+    int64_t quotient = multiplyHigh(value, magic.factor);
+
+    if (magic.adjust > 0)
+        quotient = wrappingAdd(quotient, value);
+    else if (magic.adjust < 0)
+        quotient = wrappingSub(quotient, value);
+
+    quotient >>= magic.shift;
+
+    // Add 1 to negative quotients, to round towards zero
+    return quotient + static_cast<int64_t>(static_cast<uint64_t>(quotient) >> 63);
+}
+
+} // namespace jit
+
+#endif //PLJIT_ARITHMETIC_H
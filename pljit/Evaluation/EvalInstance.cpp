@@ -6,6 +6,7 @@ namespace jit {
 
 optional<int64_t> EvalInstance::evaluate(std::vector<int64_t> parameters) {
 
+    results.clear();
 
     // Initialise the parameters with the given values
 
@@ -31,13 +31,24 @@ class EvalInstance {
     // result               Returns the result of the last evaluation this instance was used (same as the return value from the last evaulate(...) call)
     std::optional<int64_t> result() const {return res;}
 
+    // getResults           Returns all values returned by the last evaluation (incomplete, if it failed)
+    const std::vector<int64_t>& getResults() const {return results;}
+
     private:
 
+    friend class AstArithmeticExpression;
+    friend class AstReturn;
+
     const AstFunction& function;            // The associated AstFunction object
     const SourceCodeManager& manager;       // Reference to the associated SourceCode Manager
     std::vector<int64_t> identifiers{};     // Tracks the values of the identifiers during execution of the function
 
     std::optional<int64_t> res{std::nullopt};        // Stores the result of an evaluation
+    std::vector<int64_t> results{};                  // Stores all returned values of an evaluation (see AstReturn::evaluate)
+
+    // Working stacks to evaluate expressions without recursion (see AstArithmeticExpression::evaluateIteratively), kept here to reuse their memory
+    std::vector<std::pair<const AstArithmeticExpression*, bool>> nodestack{};
+    std::vector<int64_t> valuestack{};
 
 };
 
@@ -0,0 +1,139 @@
+#include "IrEvalInstance.h"
+#include "Arithmetic.h"
+
+using namespace std;
+
+namespace jit {
+
+optional<int64_t> IrEvalInstance::evaluate(const vector<int64_t>& parameters) {
+
+    if (function.nofparameters != parameters.size()) {
+
+        if (reportErrors)
+            cerr << "error: " << parameters.size() << " parameter(s) given, but function expects " << function.nofparameters << endl;
+        return nullopt;
+    }
+
+    // Affine functions are executed as a dot product of their coefficients and the parameters
+    if (function.affine) {
+
+        const vector<int64_t>& coefficients = *function.affine;
+        int64_t result = coefficients[0];
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+            result = wrappingAdd(result, wrappingMul(coefficients[i + 1], parameters[i]));
+
+        return result;
+    }
+
+    if (!execute(parameters))
+        return nullopt;
+
+    return values[function.instructions[function.results.front()].slot];
+}
+
+bool IrEvalInstance::evaluateResults(const vector<int64_t>& parameters, vector<int64_t>& results) {
+
+    if (function.nofparameters != parameters.size()) {
+
+        if (reportErrors)
+            cerr << "error: " << parameters.size() << " parameter(s) given, but function expects " << function.nofparameters << endl;
+        return false;
+    }
+
+    if (!execute(parameters))
+        return false;
+
+    results.resize(function.results.size());
+
+    for (size_t i = 0; i < function.results.size(); ++i)
+        results[i] = values[function.instructions[function.results[i]].slot];
+
+    return true;
+}
+
+bool IrEvalInstance::execute(const vector<int64_t>& parameters) {
+
+    const vector<IrInstruction>& instructions = function.instructions;
+
+    // Returns the value of the given operand from the slot it is stored in
+    auto operand = [&](IrFunction::ValueId v) { return values[instructions[v].slot]; };
+
+    for (const IrInstruction& instr : instructions) {
+
+        int64_t& value = values[instr.slot];
+
+        switch (instr.opcode) {
+
+            case IrInstruction::Opcode::Const:
+                value = instr.immediate;
+                break;
+            case IrInstruction::Opcode::Param:
+                value = parameters[static_cast<size_t>(instr.immediate)];
+                break;
+            case IrInstruction::Opcode::Neg:
+                value = wrappingNeg(operand(instr.lhs));
+                break;
+            case IrInstruction::Opcode::Shl:
+                value = shiftLeft(operand(instr.lhs), instr.immediate);
+                break;
+            case IrInstruction::Opcode::DivPow2:
+                value = divideByPowerOfTwo(operand(instr.lhs), instr.immediate);
+                break;
+            case IrInstruction::Opcode::DivMagic:
+                value = divideByMagicNumber(operand(instr.lhs), function.magicnumbers[static_cast<size_t>(instr.immediate)]);
+                break;
+            case IrInstruction::Opcode::Add:
+                value = wrappingAdd(operand(instr.lhs), operand(instr.rhs));
+                break;
+            case IrInstruction::Opcode::Sub:
+                value = wrappingSub(operand(instr.lhs), operand(instr.rhs));
+                break;
+            case IrInstruction::Opcode::Mul:
+                value = wrappingMul(operand(instr.lhs), operand(instr.rhs));
+                break;
+            case IrInstruction::Opcode::Div: {
+                int64_t divisor = operand(instr.rhs);
+                if (divisor == 0) {
+                    if (reportErrors)
+                        manager.printErrorMessage("error: Division by 0", function.getLocation(instr));
+                    return false;
+                }
+                value = wrappingDiv(operand(instr.lhs), divisor);
+                break;
+            }
+            case IrInstruction::Opcode::DivNonZero:
+                value = wrappingDiv(operand(instr.lhs), operand(instr.rhs));
+                break;
+            case IrInstruction::Opcode::Abs:
+                value = wrappingAbs(operand(instr.lhs));
+                break;
+            case IrInstruction::Opcode::Min:
+                value = branchFreeMin(operand(instr.lhs), operand(instr.rhs));
+                break;
+            case IrInstruction::Opcode::Max:
+                value = branchFreeMax(operand(instr.lhs), operand(instr.rhs));
+                break;
+            case IrInstruction::Opcode::Less:
+                value = operand(instr.lhs) < operand(instr.rhs);
+                break;
+            case IrInstruction::Opcode::LessEqual:
+                value = operand(instr.lhs) <= operand(instr.rhs);
+                break;
+            case IrInstruction::Opcode::Equal:
+                value = operand(instr.lhs) == operand(instr.rhs);
+                break;
+            case IrInstruction::Opcode::NotEqual:
+                value = operand(instr.lhs) != operand(instr.rhs);
+                break;
+            case IrInstruction::Opcode::Select:
+                // Both operands have been computed, so the selection is a blend instead of a branch
+                value = select(operand(instr.condition) != 0, operand(instr.lhs), operand(instr.rhs));
+                break;
+        }
+    }
+
+    return true;
+}
+
+} // namespace jit
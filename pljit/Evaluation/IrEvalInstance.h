@@ -0,0 +1,41 @@
+#ifndef PLJIT_IREVALINSTANCE_H
+#define PLJIT_IREVALINSTANCE_H
+
+#include <optional>
+#include <vector>
+
+#include "pljit/IR/IrFunction.h"
+
+namespace jit {
+
+// IrEvalInstance                       Class used to execute a function given in the intermediate representation with given arguments
+class IrEvalInstance {
+
+    public:
+
+    // Constructor          If 'reportErrors' is false, errors during the execution are not printed (e.g. if the caller repeats a failed execution in another way)
+    IrEvalInstance(const IrFunction& function, const SourceCodeManager& manager, bool reportErrors = true) : function{function}, manager{manager}, reportErrors{reportErrors},
+                                                                                                             values(function.nofslots, 0) {}
+
+    // evaluate             Executes the instructions of the function with the given parameters.
+    //                      If an error occurs during execution (e.g. division-by-zero), returns nullopt, otherwise returns the (first) result of the function
+    std::optional<int64_t> evaluate(const std::vector<int64_t>& parameters);
+
+    // evaluateResults      Executes the instructions of the function with the given parameters and writes all of its results into the given vector.
+    //                      Returns false, if an error occurs during execution
+    bool evaluateResults(const std::vector<int64_t>& parameters, std::vector<int64_t>& results);
+
+    private:
+
+    // execute              Executes the instructions of the function, afterwards the frame holds the results. Returns false, if an error occurs
+    bool execute(const std::vector<int64_t>& parameters);
+
+    const IrFunction& function;             // The associated IrFunction object
+    const SourceCodeManager& manager;       // Reference to the associated SourceCode Manager
+    const bool reportErrors;                // Specifies, whether errors are printed
+    std::vector<int64_t> values{};          // The frame, i.e. the slots holding the values of the instructions during execution
+};
+
+} // namespace jit
+
+#endif //PLJIT_IREVALINSTANCE_H
@@ -0,0 +1,413 @@
+#include "AlgebraicSimplifyOpt.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace jit {
+
+namespace {
+
+// ExpressionKey            Identifies the expression computed by an instruction (the opcode, the immediate value and the numbers of the operand expressions)
+struct ExpressionKey {
+
+    IrInstruction::Opcode opcode;
+    int64_t immediate;
+    size_t lhs;
+    size_t rhs;
+    size_t condition;
+
+    bool operator==(const ExpressionKey& other) const { return opcode == other.opcode && immediate == other.immediate && lhs == other.lhs && rhs == other.rhs &&
+                                                               condition == other.condition; }
+};
+
+struct ExpressionKeyHash {
+
+    size_t operator()(const ExpressionKey& key) const {
+
+        size_t h = static_cast<size_t>(key.opcode);
+        h = h * 1000003 ^ static_cast<size_t>(key.immediate);
+        h = h * 1000003 ^ key.lhs;
+        h = h * 1000003 ^ key.rhs;
+        h = h * 1000003 ^ key.condition;
+        return h;
+    }
+};
+
+// sameInstructions         Returns true, if both functions consist of the same instructions in the same order
+bool sameInstructions(const vector<IrInstruction>& before, const vector<IrInstruction>& after) {
+
+    return equal(before.begin(), before.end(), after.begin(), after.end(), [](const IrInstruction& a, const IrInstruction& b) {
+        return a.opcode == b.opcode && a.immediate == b.immediate && (!(a.isUnary() || a.isBinary()) || a.lhs == b.lhs) && (!a.isBinary() || a.rhs == b.rhs) &&
+               (!a.isTernary() || a.condition == b.condition);
+    });
+}
+
+// countChanges             Returns the number of instructions that have been rewritten, replaced or removed, i.e. the instructions of the simplified function without an
+//                          identical instruction (computing the same expression of the parameters and constants) in the original function, or the other way round
+size_t countChanges(const vector<IrInstruction>& before, const vector<IrInstruction>& after) {
+
+    // A function that cannot be simplified any further is rebuilt as it is
+    if (sameInstructions(before, after))
+        return 0;
+
+    const size_t none = static_cast<size_t>(-1);
+
+    // Identical expressions get the same number in both functions
+    unordered_map<ExpressionKey, size_t, ExpressionKeyHash> numbers{};
+    numbers.reserve(before.size() + after.size());
+
+    auto number = [&](const vector<IrInstruction>& instructions) {
+
+        vector<size_t> ids(instructions.size());
+
+        for (size_t i = 0; i < instructions.size(); ++i) {
+
+            const IrInstruction& instr = instructions[i];
+
+            size_t lhs = instr.isUnary() || instr.isBinary() ? ids[instr.lhs] : none;
+            size_t rhs = instr.isBinary() ? ids[instr.rhs] : none;
+            size_t condition = instr.isTernary() ? ids[instr.condition] : none;
+
+            ids[i] = numbers.emplace(ExpressionKey{instr.opcode, instr.immediate, lhs, rhs, condition}, numbers.size()).first->second;
+        }
+
+        return ids;
+    };
+
+    vector<size_t> original = number(before);
+    vector<size_t> simplified = number(after);
+
+    vector<size_t> count(numbers.size(), 0);
+    for (size_t id : original)
+        ++count[id];
+
+    size_t matched = 0;
+    for (size_t id : simplified)
+        if (count[id] > 0) {
+            --count[id];
+            ++matched;
+        }
+
+    return max(before.size(), after.size()) - matched;
+}
+
+} // namespace
+
+AlgebraicSimplifyOpt::Form AlgebraicSimplifyOpt::scale(const Form& form, int64_t c) {
+
+    int64_t factor = wrappingMul(form.factor, c);
+    int64_t offset = wrappingMul(form.offset, c);
+
+    if (!form.base || factor == 0)
+        return Form{nullopt, 0, offset};
+
+    return Form{form.base, factor, offset};
+}
+
+AlgebraicSimplifyOpt::Form AlgebraicSimplifyOpt::combine(const Form& lhs, Form rhs, bool subtract) {
+
+    if (subtract)
+        rhs = scale(rhs, -1);
+
+    int64_t offset = wrappingAdd(lhs.offset, rhs.offset);
+
+    if (!lhs.base)
+        return Form{rhs.base, rhs.factor, offset};
+
+    if (!rhs.base)
+        return Form{lhs.base, lhs.factor, offset};
+
+    // Both terms have the same base: only the factors have to be added
+    if (*lhs.base == *rhs.base) {
+
+        int64_t factor = wrappingAdd(lhs.factor, rhs.factor);
+        return factor == 0 ? Form{nullopt, 0, offset} : Form{lhs.base, factor, offset};
+    }
+
+    // Keep a common factor, so that it needs only one multiplication
+    if (lhs.factor == rhs.factor)
+        return Form{out->addBinary(IrInstruction::Opcode::Add, *lhs.base, *rhs.base), lhs.factor, offset};
+
+    if (lhs.factor == wrappingNeg(rhs.factor))
+        return Form{out->addBinary(IrInstruction::Opcode::Sub, *lhs.base, *rhs.base), lhs.factor, offset};
+
+    IrFunction::ValueId lhsterm = materialiseTerm(lhs);
+    IrFunction::ValueId rhsterm = materialiseTerm(rhs);
+
+    return Form{out->addBinary(IrInstruction::Opcode::Add, lhsterm, rhsterm), 1, offset};
+}
+
+AlgebraicSimplifyOpt::Form AlgebraicSimplifyOpt::multiply(const Form& lhs, const Form& rhs) {
+
+    if (!lhs.base)
+        return scale(rhs, lhs.offset);
+
+    if (!rhs.base)
+        return scale(lhs, rhs.offset);
+
+    // Without offsets, the factors can be moved out of the product
+    if (lhs.offset == 0 && rhs.offset == 0)
+        return scale(Form{out->addBinary(IrInstruction::Opcode::Mul, *lhs.base, *rhs.base), 1, 0}, wrappingMul(lhs.factor, rhs.factor));
+
+    IrFunction::ValueId lhsvalue = materialise(lhs);
+    IrFunction::ValueId rhsvalue = materialise(rhs);
+
+    return Form{out->addBinary(IrInstruction::Opcode::Mul, lhsvalue, rhsvalue), 1, 0};
+}
+
+bool AlgebraicSimplifyOpt::equal(const Form& lhs, const Form& rhs) {
+
+    return lhs.base == rhs.base && lhs.factor == rhs.factor && lhs.offset == rhs.offset;
+}
+
+optional<int64_t> AlgebraicSimplifyOpt::compare(IrInstruction::Opcode opcode, const Form& lhs, const Form& rhs) {
+
+    using Opcode = IrInstruction::Opcode;
+
+    // Forms of the same base with the same factor are equal exactly if their offsets are equal. Their order is unknown, as the arithmetic wraps around
+    if (lhs.base || rhs.base) {
+
+        if (lhs.base != rhs.base || lhs.factor != rhs.factor)
+            return nullopt;
+        if (opcode == Opcode::Equal)
+            return lhs.offset == rhs.offset;
+        if (opcode == Opcode::NotEqual)
+            return lhs.offset != rhs.offset;
+
+        return nullopt;
+    }
+
+    switch (opcode) {
+        case Opcode::Min:
+            return branchFreeMin(lhs.offset, rhs.offset);
+        case Opcode::Max:
+            return branchFreeMax(lhs.offset, rhs.offset);
+        case Opcode::Less:
+            return lhs.offset < rhs.offset;
+        case Opcode::LessEqual:
+            return lhs.offset <= rhs.offset;
+        case Opcode::Equal:
+            return lhs.offset == rhs.offset;
+        case Opcode::NotEqual:
+            return lhs.offset != rhs.offset;
+        default:
+            return nullopt;
+    }
+}
+
+IrFunction::ValueId AlgebraicSimplifyOpt::materialiseTerm(const Form& form) {
+
+    if (form.factor == 1)
+        return *form.base;
+
+    if (form.factor == -1)
+        return out->addUnary(IrInstruction::Opcode::Neg, *form.base);
+
+    // Factors 2^k and -2^k are shifts, as created by StrengthReductionOpt, which otherwise would have to reduce the multiplication again
+    uint64_t magnitude = form.factor < 0 ? 0 - static_cast<uint64_t>(form.factor) : static_cast<uint64_t>(form.factor);
+
+    if ((magnitude & (magnitude - 1)) == 0) {
+
+        int64_t k = 0;
+        while ((magnitude >> k) > 1)
+            ++k;
+
+        IrFunction::ValueId term = out->addUnary(IrInstruction::Opcode::Shl, *form.base, k);
+        return form.factor < 0 ? out->addUnary(IrInstruction::Opcode::Neg, term) : term;
+    }
+
+    return out->addBinary(IrInstruction::Opcode::Mul, *form.base, constant(form.factor));
+}
+
+IrFunction::ValueId AlgebraicSimplifyOpt::materialise(const Form& form) {
+
+    if (!form.base)
+        return constant(form.offset);
+
+    if (form.offset == 0)
+        return materialiseTerm(form);
+
+    // 'offset - base' needs one instruction less than '-base + offset' (also for other negative factors, e.g. 'offset - (base << k)')
+    if (form.factor < 0 && form.factor != numeric_limits<int64_t>::min()) {
+
+        IrFunction::ValueId term = materialiseTerm(Form{form.base, -form.factor, 0});
+        return out->addBinary(IrInstruction::Opcode::Sub, constant(form.offset), term);
+    }
+
+    IrFunction::ValueId term = materialiseTerm(form);
+
+    return out->addBinary(IrInstruction::Opcode::Add, term, constant(form.offset));
+}
+
+IrFunction::ValueId AlgebraicSimplifyOpt::valueOf(IrFunction::ValueId v) {
+
+    if (!values[v])
+        values[v] = materialise(forms[v]);
+
+    return *values[v];
+}
+
+IrFunction::ValueId AlgebraicSimplifyOpt::constant(int64_t value) {
+
+    auto it = constants.find(value);
+
+    if (it != constants.end())
+        return it->second;
+
+    IrFunction::ValueId v = out->addConstant(value);
+    constants.emplace(value, v);
+
+    return v;
+}
+
+size_t AlgebraicSimplifyOpt::run(IrFunction& function) {
+
+    using Opcode = IrInstruction::Opcode;
+
+    const vector<IrInstruction>& instructions = function.instructions;
+
+    IrFunction simplified{function.nofparameters};
+    simplified.magicnumbers = function.magicnumbers;
+
+    out = &simplified;
+    forms.clear();
+    forms.reserve(instructions.size());
+    values.assign(instructions.size(), nullopt);
+    constants.clear();
+
+    // Instructions that cannot be simplified become the base of their own form
+    auto opaque = [this](size_t i, IrFunction::ValueId v) {
+        forms.push_back(Form{v, 1, 0});
+        values[i] = v;
+    };
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        const IrInstruction& instr = instructions[i];
+
+        switch (instr.opcode) {
+
+            case Opcode::Const:
+                forms.push_back(Form{nullopt, 0, instr.immediate});
+                break;
+            case Opcode::Param:
+                opaque(i, out->addParameter(static_cast<size_t>(instr.immediate)));
+                break;
+            case Opcode::Neg:
+                forms.push_back(scale(forms[instr.lhs], -1));
+                break;
+            case Opcode::Shl:
+                forms.push_back(scale(forms[instr.lhs], shiftLeft(1, instr.immediate)));
+                break;
+            case Opcode::Add:
+                forms.push_back(combine(forms[instr.lhs], forms[instr.rhs], false));
+                break;
+            case Opcode::Sub:
+                forms.push_back(combine(forms[instr.lhs], forms[instr.rhs], true));
+                break;
+            case Opcode::Mul:
+                forms.push_back(multiply(forms[instr.lhs], forms[instr.rhs]));
+                break;
+            case Opcode::DivPow2:
+                if (!forms[instr.lhs].base)
+                    forms.push_back(Form{nullopt, 0, divideByPowerOfTwo(forms[instr.lhs].offset, instr.immediate)});
+                else
+                    opaque(i, out->addUnary(instr.opcode, valueOf(instr.lhs), instr.immediate));
+                break;
+            case Opcode::DivMagic:
+                if (!forms[instr.lhs].base)
+                    forms.push_back(Form{nullopt, 0, divideByMagicNumber(forms[instr.lhs].offset, function.magicnumbers[static_cast<size_t>(instr.immediate)])});
+                else
+                    opaque(i, out->addUnary(instr.opcode, valueOf(instr.lhs), instr.immediate));
+                break;
+            case Opcode::Div: {
+                const Form& dividend = forms[instr.lhs];
+                const Form& divisor = forms[instr.rhs];
+
+                // Divisions are created in their original order, unless they are constant and cannot fail
+                if (!dividend.base && !divisor.base && divisor.offset != 0)
+                    forms.push_back(Form{nullopt, 0, wrappingDiv(dividend.offset, divisor.offset)});
+                else {
+                    IrFunction::ValueId lhs = valueOf(instr.lhs);
+                    IrFunction::ValueId rhs = valueOf(instr.rhs);
+                    opaque(i, out->addDivision(lhs, rhs, function.getLocation(instr)));
+                }
+                break;
+            }
+            case Opcode::DivNonZero:
+                if (!forms[instr.lhs].base && !forms[instr.rhs].base)
+                    forms.push_back(Form{nullopt, 0, wrappingDiv(forms[instr.lhs].offset, forms[instr.rhs].offset)});
+                else {
+                    IrFunction::ValueId lhs = valueOf(instr.lhs);
+                    IrFunction::ValueId rhs = valueOf(instr.rhs);
+                    opaque(i, out->addBinary(instr.opcode, lhs, rhs));
+                }
+                break;
+            case Opcode::Abs:
+                if (!forms[instr.lhs].base)
+                    forms.push_back(Form{nullopt, 0, wrappingAbs(forms[instr.lhs].offset)});
+                else
+                    opaque(i, out->addUnary(instr.opcode, valueOf(instr.lhs)));
+                break;
+            case Opcode::Min:
+            case Opcode::Max:
+            case Opcode::Less:
+            case Opcode::LessEqual:
+            case Opcode::Equal:
+            case Opcode::NotEqual: {
+                const Form& lhs = forms[instr.lhs];
+                const Form& rhs = forms[instr.rhs];
+
+                if (optional<int64_t> value = compare(instr.opcode, lhs, rhs))
+                    forms.push_back(Form{nullopt, 0, *value});
+                else if ((instr.opcode == Opcode::Min || instr.opcode == Opcode::Max) && equal(lhs, rhs))
+                    forms.push_back(lhs);
+                else {
+                    IrFunction::ValueId lhsvalue = valueOf(instr.lhs);
+                    IrFunction::ValueId rhsvalue = valueOf(instr.rhs);
+                    opaque(i, out->addBinary(instr.opcode, lhsvalue, rhsvalue));
+                }
+                break;
+            }
+            case Opcode::Select: {
+                const Form& condition = forms[instr.condition];
+
+                // A constant condition or equal operands select the form of an operand (e.g. a division guarded by a constant condition is unguarded again)
+                if (!condition.base)
+                    forms.push_back(forms[condition.offset != 0 ? instr.lhs : instr.rhs]);
+                else if (equal(forms[instr.lhs], forms[instr.rhs]))
+                    forms.push_back(forms[instr.lhs]);
+                else {
+                    IrFunction::ValueId conditionvalue = valueOf(instr.condition);
+                    IrFunction::ValueId lhs = valueOf(instr.lhs);
+                    IrFunction::ValueId rhs = valueOf(instr.rhs);
+                    opaque(i, out->addSelect(conditionvalue, lhs, rhs));
+                }
+                break;
+            }
+        }
+    }
+
+    for (IrFunction::ValueId result : function.results)
+        simplified.results.push_back(valueOf(result));
+
+    size_t nofchanges = countChanges(instructions, simplified.instructions);
+    out = nullptr;
+
+    // The function is kept, if it cannot be simplified any further (so that repeating the pass reaches a fixed point)
+    if (nofchanges == 0)
+        return 0;
+
+    function.instructions = move(simplified.instructions);
+    function.locations = move(simplified.locations);
+    function.magicnumbers = move(simplified.magicnumbers);
+    function.results = move(simplified.results);
+    function.assignSlots();
+
+    return nofchanges;
+}
+
+} // namespace jit
@@ -0,0 +1,74 @@
+#ifndef PLJIT_ALGEBRAICSIMPLIFYOPT_H
+#define PLJIT_ALGEBRAICSIMPLIFYOPT_H
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// AlgebraicSimplifyOpt                 Simplifies the arithmetic of a function. Every value is described as 'factor * base + offset' with constant factor and offset,
+//                                      where the base is a value that cannot be simplified any further (e.g. a parameter). Additions, subtractions, negations and
+//                                      multiplications with constants only change the factor and the offset. As the arithmetic wraps around, this reassociation never
+//                                      changes a result. Thereby constants are gathered ('(a + 1) + 2' becomes 'a + 3'), identities are removed ('a * 1', 'a - a', '0 * a',
+//                                      '-(-a)') and constant expressions are folded. Factors 2^k are created as shifts.
+//                                      Minima, maxima, comparisons and selections are folded, if their operands are known.
+//                                      The instructions are only created when their values are needed, divisions are kept in their order as they may fail
+class AlgebraicSimplifyOpt : public IrOptimisePass {
+
+    public:
+
+    // Constructor
+    AlgebraicSimplifyOpt() = default;
+
+    // run                      Simplifies the given function and returns the number of rewritten, replaced or removed instructions
+    size_t run(IrFunction& function) override;
+
+    private:
+
+    // Form                     Describes a value as 'factor * base + offset'. Values without base are constants
+    struct Form {
+        std::optional<IrFunction::ValueId> base;
+        int64_t factor;
+        int64_t offset;
+    };
+
+    // scale                    Returns the form of the given form multiplied by a constant
+    static Form scale(const Form& form, int64_t c);
+
+    // combine                  Returns the form of the sum of the given forms, the second one is subtracted, if 'subtract' is true. May create instructions
+    Form combine(const Form& lhs, Form rhs, bool subtract);
+
+    // multiply                 Returns the form of the product of the given forms. May create instructions
+    Form multiply(const Form& lhs, const Form& rhs);
+
+    // equal                    Returns true, if the given forms describe the same value
+    static bool equal(const Form& lhs, const Form& rhs);
+
+    // compare                  Returns the value of the given minimum, maximum or comparison of the given forms, if it is known
+    static std::optional<int64_t> compare(IrInstruction::Opcode opcode, const Form& lhs, const Form& rhs);
+
+    // materialiseTerm          Creates the instructions computing 'factor * base' of the given form (the factor must not be 0) and returns the value
+    IrFunction::ValueId materialiseTerm(const Form& form);
+
+    // materialise              Creates the instructions computing the value of the given form and returns the value
+    IrFunction::ValueId materialise(const Form& form);
+
+    // valueOf                  Returns the value of the instruction with the given index of the original function, creates the instructions if necessary
+    IrFunction::ValueId valueOf(IrFunction::ValueId v);
+
+    // constant                 Returns a value with the given constant, creates it if necessary
+    IrFunction::ValueId constant(int64_t value);
+
+    IrFunction* out{nullptr};                                               // The simplified function, that is being built
+    std::vector<Form> forms{};                                              // The forms of the values of the original function
+    std::vector<std::optional<IrFunction::ValueId>> values{};              // The values of the instructions of the original function in the simplified function, if created
+    std::unordered_map<int64_t, IrFunction::ValueId> constants{};          // The constants of the simplified function
+};
+
+} // namespace jit
+
+#endif //PLJIT_ALGEBRAICSIMPLIFYOPT_H
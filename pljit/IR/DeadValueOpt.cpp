@@ -0,0 +1,48 @@
+#include "DeadValueOpt.h"
+
+using namespace std;
+
+namespace jit {
+
+size_t DeadValueOpt::run(IrFunction& function) {
+
+    vector<IrInstruction>& instructions = function.instructions;
+
+    // Mark the live values backwards, starting with the results. An instruction is live, if its value is used by a live instruction or if it can fail
+    vector<bool> live(instructions.size(), false);
+    for (IrFunction::ValueId result : function.results)
+        live[result] = true;
+
+    for (size_t i = instructions.size(); i-- > 0;) {
+
+        const IrInstruction& instr = instructions[i];
+
+        if (instr.mayFail()) {
+
+            const IrInstruction& divisor = instructions[instr.rhs];
+            bool safe = divisor.opcode == IrInstruction::Opcode::Const && divisor.immediate != 0;
+
+            if (!safe)
+                live[i] = true;
+        }
+
+        if (!live[i])
+            continue;
+
+        if (instr.isUnary() || instr.isBinary())
+            live[instr.lhs] = true;
+        if (instr.isBinary())
+            live[instr.rhs] = true;
+        if (instr.isTernary())
+            live[instr.condition] = true;
+    }
+
+    vector<bool> removed(instructions.size());
+
+    for (size_t i = 0; i < instructions.size(); ++i)
+        removed[i] = !live[i];
+
+    return function.removeInstructions(removed);
+}
+
+} // namespace jit
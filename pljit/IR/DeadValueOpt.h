@@ -0,0 +1,25 @@
+#ifndef PLJIT_DEADVALUEOPT_H
+#define PLJIT_DEADVALUEOPT_H
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// DeadValueOpt                         Removes all instructions whose values do not contribute to the result of the function (e.g. assignments to variables that are never
+//                                      read afterwards). Divisions are kept unless their divisor is a non-zero constant, as they may have to report a division by zero
+class DeadValueOpt : public IrOptimisePass {
+
+    public:
+
+    // Constructor
+    DeadValueOpt() = default;
+
+    // run                      Removes the dead instructions of the given function and returns their number
+    size_t run(IrFunction& function) override;
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_DEADVALUEOPT_H
@@ -0,0 +1,260 @@
+#include "IrBuilder.h"
+
+using namespace std;
+
+namespace jit {
+
+unique_ptr<IrFunction> IrBuilder::buildFunction() {
+
+    bindings.resize(function.nofparameters);
+
+    size_t nofremaining = 0;
+    for (const auto& binding : bindings)
+        nofremaining += !binding;
+
+    ir = make_unique<IrFunction>(nofremaining);
+    current.clear();
+
+    // Parameters get their values from the arguments (or their bindings), variables are initialised with 0
+    size_t next = 0;
+    for (size_t i = 0; i < function.nofparameters; ++i)
+        current.push_back(bindings[i] ? ir->addConstant(*bindings[i]) : ir->addParameter(next++));
+
+    if (function.nofvariables > 0) {
+
+        IrFunction::ValueId zero = ir->addConstant(0);
+        current.insert(current.end(), function.nofvariables, zero);
+    }
+
+    bool hasReturn{false};
+
+    for (auto& st : function.statementlist->statements) {
+
+        if (st->subtype == AstStatement::SubType::AstReturn) {
+            for (const auto& value : static_cast<const AstReturn&>(*st).returnvalues)
+                ir->results.push_back(buildExpression(*value));
+
+            hasReturn = true;
+            break;
+        }
+
+        const auto& assignment = static_cast<const AstAssignment&>(*st);
+        IrFunction::ValueId value = buildExpression(*assignment.rhs);
+        current[static_cast<const AstIdentifier&>(*assignment.lhs).index] = value;
+    }
+
+    // A function without return statement returns 0 (this cannot happen for functions that passed the semantic analysis)
+    if (!hasReturn)
+        ir->results.push_back(ir->addConstant(0));
+
+    ir->assignSlots();
+
+    return move(ir);
+}
+
+IrFunction::ValueId IrBuilder::buildExpression(const AstArithmeticExpression& expr) {
+
+    // Pairs of a node and the number of its lowering steps done so far (for most nodes: 0 before and 1 after their subexpressions have been pushed)
+    vector<pair<const AstArithmeticExpression*, size_t>> nodestack{{&expr, 0}};
+    vector<IrFunction::ValueId> valuestack{};
+
+    guards.clear();
+
+    while (!nodestack.empty()) {
+
+        auto [node, step] = nodestack.back();
+        bool expanded = step != 0;
+
+        switch (node->subtype) {
+
+            case AstArithmeticExpression::Subtype::Literal:
+                nodestack.pop_back();
+                valuestack.push_back(ir->addConstant(static_cast<const AstLiteral&>(*node).value));
+                break;
+
+            case AstArithmeticExpression::Subtype::Identifier:
+                nodestack.pop_back();
+                valuestack.push_back(current[static_cast<const AstIdentifier&>(*node).index]);
+                break;
+
+            case AstArithmeticExpression::Subtype::Unary:
+                if (!expanded) {
+                    nodestack.back().second = 1;
+                    nodestack.emplace_back(static_cast<const AstUnaryArithmeticExpression&>(*node).subexpr.get(), 0);
+                }
+                else {
+                    nodestack.pop_back();
+                    valuestack.back() = ir->addUnary(IrInstruction::Opcode::Neg, valuestack.back());
+                }
+                break;
+
+            case AstArithmeticExpression::Subtype::Binary: {
+
+                const auto& binexpr = static_cast<const AstBinaryArithmeticExpression&>(*node);
+
+                if (!expanded) {
+                    // Push the right subexpression first, so that the left one is lowered first
+                    nodestack.back().second = 1;
+                    nodestack.emplace_back(binexpr.rhs.get(), 0);
+                    nodestack.emplace_back(binexpr.lhs.get(), 0);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                IrFunction::ValueId rhs = valuestack.back();
+                valuestack.pop_back();
+                IrFunction::ValueId& lhs = valuestack.back();
+
+                switch (binexpr.op) {
+
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Plus:
+                        lhs = ir->addBinary(IrInstruction::Opcode::Add, lhs, rhs);
+                        break;
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Minus:
+                        lhs = ir->addBinary(IrInstruction::Opcode::Sub, lhs, rhs);
+                        break;
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Mul:
+                        lhs = ir->addBinary(IrInstruction::Opcode::Mul, lhs, rhs);
+                        break;
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Div:
+                        lhs = ir->addGuardedDivision(lhs, rhs, binexpr.rhs->location, guards.empty() ? nullopt : optional<IrFunction::ValueId>{guards.back()});
+                        break;
+                }
+                break;
+            }
+
+            case AstArithmeticExpression::Subtype::Call: {
+
+                const auto& call = static_cast<const AstCall&>(*node);
+
+                if (!expanded) {
+                    // Push the arguments in reverse order, so that they are lowered from left to right
+                    nodestack.back().second = 1;
+                    for (auto it = call.arguments.rbegin(); it != call.arguments.rend(); ++it)
+                        nodestack.emplace_back(it->get(), 0);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                vector<IrFunction::ValueId> arguments(valuestack.end() - static_cast<ptrdiff_t>(call.arguments.size()), valuestack.end());
+                valuestack.resize(valuestack.size() - call.arguments.size());
+
+                // Calls that have not been inlined into the Ast are inlined here. The divisions of the called function report their errors at the call
+                valuestack.push_back(ir->inlineFunction(*call.callee.ir, arguments, call.location, guards.empty() ? nullopt : optional<IrFunction::ValueId>{guards.back()}).front());
+                break;
+            }
+
+            case AstArithmeticExpression::Subtype::Intrinsic: {
+
+                const auto& intrinsic = static_cast<const AstIntrinsic&>(*node);
+
+                if (!expanded) {
+                    nodestack.back().second = 1;
+                    for (auto it = intrinsic.arguments.rbegin(); it != intrinsic.arguments.rend(); ++it)
+                        nodestack.emplace_back(it->get(), 0);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                if (intrinsic.function == AstIntrinsic::Function::Abs) {
+                    valuestack.back() = ir->addUnary(IrInstruction::Opcode::Abs, valuestack.back());
+                    break;
+                }
+
+                IrFunction::ValueId rhs = valuestack.back();
+                valuestack.pop_back();
+                valuestack.back() = ir->addBinary(intrinsic.function == AstIntrinsic::Function::Min ? IrInstruction::Opcode::Min : IrInstruction::Opcode::Max,
+                                                  valuestack.back(), rhs);
+                break;
+            }
+
+            case AstArithmeticExpression::Subtype::Conditional: {
+
+                /*
+                 * Both alternatives are computed and one of them is selected. The value stack holds the condition and the guard of the ELSE alternative, while the
+                 * alternatives are lowered. The guard of an alternative is 1, if the alternative is selected (and all enclosing alternatives are selected as well)
+                 */
+                const auto& conditional = static_cast<const AstConditional&>(*node);
+
+                if (step == 0) {
+                    nodestack.back().second = 1;
+                    nodestack.emplace_back(conditional.operands[AstConditional::rhsIndex].get(), 0);
+                    nodestack.emplace_back(conditional.operands[AstConditional::lhsIndex].get(), 0);
+                }
+                else if (step == 1) {
+
+                    IrFunction::ValueId rhs = valuestack.back();
+                    valuestack.pop_back();
+                    IrFunction::ValueId lhs = valuestack.back();
+                    valuestack.pop_back();
+
+                    IrFunction::ValueId condition = buildComparison(conditional.comparison, lhs, rhs, false);
+                    IrFunction::ValueId thenGuard = condition;
+                    IrFunction::ValueId elseGuard = buildComparison(conditional.comparison, lhs, rhs, true);
+
+                    if (!guards.empty()) {
+                        thenGuard = ir->addBinary(IrInstruction::Opcode::Min, guards.back(), thenGuard);
+                        elseGuard = ir->addBinary(IrInstruction::Opcode::Min, guards.back(), elseGuard);
+                    }
+
+                    valuestack.push_back(condition);
+                    valuestack.push_back(elseGuard);
+                    guards.push_back(thenGuard);
+
+                    nodestack.back().second = 2;
+                    nodestack.emplace_back(conditional.operands[AstConditional::thenIndex].get(), 0);
+                }
+                else if (step == 2) {
+
+                    // The value of the THEN alternative is on top of the guard of the ELSE alternative
+                    guards.back() = valuestack[valuestack.size() - 2];
+
+                    nodestack.back().second = 3;
+                    nodestack.emplace_back(conditional.operands[AstConditional::elseIndex].get(), 0);
+                }
+                else {
+
+                    nodestack.pop_back();
+                    guards.pop_back();
+
+                    IrFunction::ValueId elseValue = valuestack.back();
+                    valuestack.pop_back();
+                    IrFunction::ValueId thenValue = valuestack.back();
+                    valuestack.pop_back();
+                    valuestack.pop_back();
+
+                    valuestack.back() = ir->addSelect(valuestack.back(), thenValue, elseValue);
+                }
+                break;
+            }
+        }
+    }
+
+    return valuestack.back();
+}
+
+IrFunction::ValueId IrBuilder::buildComparison(AstConditional::Comparison comparison, IrFunction::ValueId lhs, IrFunction::ValueId rhs, bool negate) {
+
+    // 'a > b' is computed as 'b < a', the negation of 'a < b' is 'b <= a'
+    switch (comparison) {
+        case AstConditional::Comparison::Equal:
+            return ir->addBinary(negate ? IrInstruction::Opcode::NotEqual : IrInstruction::Opcode::Equal, lhs, rhs);
+        case AstConditional::Comparison::NotEqual:
+            return ir->addBinary(negate ? IrInstruction::Opcode::Equal : IrInstruction::Opcode::NotEqual, lhs, rhs);
+        case AstConditional::Comparison::Less:
+            return negate ? ir->addBinary(IrInstruction::Opcode::LessEqual, rhs, lhs) : ir->addBinary(IrInstruction::Opcode::Less, lhs, rhs);
+        case AstConditional::Comparison::LessEqual:
+            return negate ? ir->addBinary(IrInstruction::Opcode::Less, rhs, lhs) : ir->addBinary(IrInstruction::Opcode::LessEqual, lhs, rhs);
+        case AstConditional::Comparison::Greater:
+            return negate ? ir->addBinary(IrInstruction::Opcode::LessEqual, lhs, rhs) : ir->addBinary(IrInstruction::Opcode::Less, rhs, lhs);
+        case AstConditional::Comparison::GreaterEqual:
+            return negate ? ir->addBinary(IrInstruction::Opcode::Less, lhs, rhs) : ir->addBinary(IrInstruction::Opcode::LessEqual, rhs, lhs);
+    }
+
+    return lhs;
+}
+
+} // namespace jit
@@ -0,0 +1,49 @@
+#ifndef PLJIT_IRBUILDER_H
+#define PLJIT_IRBUILDER_H
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "pljit/IR/IrFunction.h"
+#include "pljit/SemanticAnalysis/AstNode.h"
+
+namespace jit {
+
+// IrBuilder                            Lowers an Ast into the intermediate representation. Every assignment to a parameter or variable defines a new value, reading an
+//                                      identifier refers to the value it was assigned last. Calls are replaced by the intermediate representation of the called function.
+//                                      Conditional expressions compute both alternatives and select one of them without a branch. The divisions within an alternative are
+//                                      guarded by the condition of the alternative, so that they fail only if the alternative is selected
+class IrBuilder {
+
+    public:
+
+    // Constructor
+    explicit IrBuilder(const AstFunction& function) : function{function} {}
+
+    // Constructor              Parameters with a given value are replaced by constants, the built function only takes the remaining parameters (in their order)
+    IrBuilder(const AstFunction& function, std::vector<std::optional<int64_t>> bindings) : function{function}, bindings{std::move(bindings)} {}
+
+    // buildFunction            Lowers the statements of the function up to the first return statement and returns the resulting IrFunction object
+    std::unique_ptr<IrFunction> buildFunction();
+
+    private:
+
+    // buildExpression          Appends the instructions computing the given expression and returns the value of the expression. Works with an explicit stack instead of
+    //                          recursion, the subexpressions are lowered in the same order as they are evaluated by the Ast
+    IrFunction::ValueId buildExpression(const AstArithmeticExpression& expr);
+
+    // buildComparison          Appends the instruction comparing the given values and returns its value (0 or 1). With 'negate', the opposite comparison is built
+    IrFunction::ValueId buildComparison(AstConditional::Comparison comparison, IrFunction::ValueId lhs, IrFunction::ValueId rhs, bool negate);
+
+    const AstFunction& function;                // The Ast to be lowered
+    std::vector<std::optional<int64_t>> bindings{};     // The values of the bound parameters (nullopt for parameters that remain parameters)
+
+    std::unique_ptr<IrFunction> ir{};           // The function that is being built
+    std::vector<IrFunction::ValueId> current{}; // The current value of every identifier (in order of the indices from the semantic analysis)
+    std::vector<IrFunction::ValueId> guards{};  // The guards (0 or 1) of the alternatives that are currently lowered, the innermost one is the last
+};
+
+} // namespace jit
+
+#endif //PLJIT_IRBUILDER_H
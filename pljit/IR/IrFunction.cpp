@@ -0,0 +1,331 @@
+#include "IrFunction.h"
+
+#include <unordered_map>
+
+using namespace std;
+
+namespace jit {
+
+IrFunction::ValueId IrFunction::addConstant(int64_t value) {
+
+    IrInstruction instr{};
+    instr.opcode = IrInstruction::Opcode::Const;
+    instr.immediate = value;
+
+    instructions.push_back(instr);
+    return instructions.size() - 1;
+}
+
+IrFunction::ValueId IrFunction::addParameter(size_t index) {
+
+    IrInstruction instr{};
+    instr.opcode = IrInstruction::Opcode::Param;
+    instr.immediate = static_cast<int64_t>(index);
+
+    instructions.push_back(instr);
+    return instructions.size() - 1;
+}
+
+IrFunction::ValueId IrFunction::addUnary(IrInstruction::Opcode opcode, ValueId operand, int64_t immediate) {
+
+    IrInstruction instr{};
+    instr.opcode = opcode;
+    instr.lhs = operand;
+    instr.immediate = immediate;
+
+    instructions.push_back(instr);
+    return instructions.size() - 1;
+}
+
+IrFunction::ValueId IrFunction::addBinary(IrInstruction::Opcode opcode, ValueId lhs, ValueId rhs) {
+
+    IrInstruction instr{};
+    instr.opcode = opcode;
+    instr.lhs = lhs;
+    instr.rhs = rhs;
+
+    instructions.push_back(instr);
+    return instructions.size() - 1;
+}
+
+IrFunction::ValueId IrFunction::addDivision(ValueId lhs, ValueId rhs, SourceCodeReference location) {
+
+    ValueId v = addBinary(IrInstruction::Opcode::Div, lhs, rhs);
+
+    locations.push_back(location);
+    instructions[v].location = locations.size() - 1;
+
+    return v;
+}
+
+IrFunction::ValueId IrFunction::addSelect(ValueId condition, ValueId lhs, ValueId rhs) {
+
+    ValueId v = addBinary(IrInstruction::Opcode::Select, lhs, rhs);
+    instructions[v].condition = condition;
+
+    return v;
+}
+
+IrFunction::ValueId IrFunction::addGuardedDivision(ValueId lhs, ValueId rhs, SourceCodeReference location, optional<ValueId> guard) {
+
+    // Divisions by non-zero constants cannot fail and need no guard
+    const IrInstruction& divisor = instructions[rhs];
+
+    if (guard && !(divisor.opcode == IrInstruction::Opcode::Const && divisor.immediate != 0))
+        rhs = addSelect(*guard, rhs, addConstant(1));
+
+    return addDivision(lhs, rhs, location);
+}
+
+vector<IrFunction::ValueId> IrFunction::inlineFunction(const IrFunction& function, const vector<ValueId>& arguments, optional<SourceCodeReference> location,
+                                                       optional<ValueId> guard) {
+
+    vector<ValueId> newid(function.instructions.size());
+
+    // The magic numbers of the inlined function are merged into the table, divisors that are already known share their entry
+    unordered_map<int64_t, size_t> magicindex{};
+    for (size_t m = 0; m < magicnumbers.size(); ++m)
+        magicindex.emplace(magicnumbers[m].divisor, m);
+
+    vector<int64_t> newmagic(function.magicnumbers.size());
+    for (size_t m = 0; m < function.magicnumbers.size(); ++m) {
+
+        auto [it, inserted] = magicindex.emplace(function.magicnumbers[m].divisor, magicnumbers.size());
+
+        if (inserted)
+            magicnumbers.push_back(function.magicnumbers[m]);
+
+        newmagic[m] = static_cast<int64_t>(it->second);
+    }
+
+    for (size_t i = 0; i < function.instructions.size(); ++i) {
+
+        IrInstruction instr = function.instructions[i];
+
+        if (instr.opcode == IrInstruction::Opcode::Param) {
+            newid[i] = arguments[static_cast<size_t>(instr.immediate)];
+            continue;
+        }
+
+        if (instr.isUnary() || instr.isBinary())
+            instr.lhs = newid[instr.lhs];
+        if (instr.isBinary())
+            instr.rhs = newid[instr.rhs];
+        if (instr.isTernary())
+            instr.condition = newid[instr.condition];
+        if (instr.opcode == IrInstruction::Opcode::DivMagic)
+            instr.immediate = newmagic[static_cast<size_t>(instr.immediate)];
+
+        if (instr.mayFail())
+            newid[i] = addGuardedDivision(instr.lhs, instr.rhs, location ? *location : function.getLocation(instr), guard);
+        else {
+            instr.location = IrInstruction::noLocation;
+            instructions.push_back(instr);
+            newid[i] = instructions.size() - 1;
+        }
+    }
+
+    vector<ValueId> values{};
+    for (ValueId result : function.results)
+        values.push_back(newid[result]);
+
+    return values;
+}
+
+size_t IrFunction::removeInstructions(const vector<bool>& removed) {
+
+    // Maps the old value ids of the remaining instructions to the new ones
+    vector<ValueId> newid(instructions.size());
+    size_t next = 0;
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        if (removed[i])
+            continue;
+
+        IrInstruction instr = instructions[i];
+
+        if (instr.isUnary() || instr.isBinary())
+            instr.lhs = newid[instr.lhs];
+        if (instr.isBinary())
+            instr.rhs = newid[instr.rhs];
+        if (instr.isTernary())
+            instr.condition = newid[instr.condition];
+
+        newid[i] = next;
+        instructions[next++] = instr;
+    }
+
+    size_t nofremoved = instructions.size() - next;
+
+    for (ValueId& result : results)
+        result = newid[result];
+
+    instructions.resize(next);
+
+    assignSlots();
+
+    return nofremoved;
+}
+
+void IrFunction::compactMagicNumbers() {
+
+    if (magicnumbers.empty())
+        return;
+
+    // Maps the indices of the used magic numbers to their new indices, the unused ones are removed
+    const int64_t unused = -1;
+    vector<int64_t> newindex(magicnumbers.size(), unused);
+    vector<MagicNumber> used{};
+
+    for (IrInstruction& instr : instructions) {
+
+        if (instr.opcode != IrInstruction::Opcode::DivMagic)
+            continue;
+
+        int64_t& index = newindex[static_cast<size_t>(instr.immediate)];
+
+        if (index == unused) {
+            index = static_cast<int64_t>(used.size());
+            used.push_back(magicnumbers[static_cast<size_t>(instr.immediate)]);
+        }
+
+        instr.immediate = index;
+    }
+
+    magicnumbers = move(used);
+}
+
+void IrFunction::assignSlots() {
+
+    compactMagicNumbers();
+
+    // Determine the last instruction using each value (the results are used after the last instruction)
+    vector<size_t> lastuse(instructions.size());
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        lastuse[i] = i;
+
+        if (instructions[i].isUnary() || instructions[i].isBinary())
+            lastuse[instructions[i].lhs] = i;
+        if (instructions[i].isBinary())
+            lastuse[instructions[i].rhs] = i;
+        if (instructions[i].isTernary())
+            lastuse[instructions[i].condition] = i;
+    }
+
+    for (ValueId result : results)
+        lastuse[result] = instructions.size();
+
+    // Slots that currently do not hold a value that is needed later
+    vector<size_t> freeslots{};
+    nofslots = 0;
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        IrInstruction& instr = instructions[i];
+
+        // The operands are read before the value is written, so the slots of operands that are not needed anymore can be reused for the value itself
+        if ((instr.isUnary() || instr.isBinary()) && lastuse[instr.lhs] == i)
+            freeslots.push_back(instructions[instr.lhs].slot);
+        if (instr.isBinary() && lastuse[instr.rhs] == i && instr.rhs != instr.lhs)
+            freeslots.push_back(instructions[instr.rhs].slot);
+        if (instr.isTernary() && lastuse[instr.condition] == i && instr.condition != instr.lhs && instr.condition != instr.rhs)
+            freeslots.push_back(instructions[instr.condition].slot);
+
+        if (freeslots.empty())
+            instr.slot = nofslots++;
+        else {
+            instr.slot = freeslots.back();
+            freeslots.pop_back();
+        }
+
+        // The value is never used (e.g. a division which is only kept because it can fail)
+        if (lastuse[i] == i)
+            freeslots.push_back(instr.slot);
+    }
+}
+
+void IrFunction::print(ostream& out) const {
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        const IrInstruction& instr = instructions[i];
+
+        out << "%" << i << " = ";
+
+        switch (instr.opcode) {
+            case IrInstruction::Opcode::Const:
+                out << "const " << instr.immediate;
+                break;
+            case IrInstruction::Opcode::Param:
+                out << "param " << instr.immediate;
+                break;
+            case IrInstruction::Opcode::Neg:
+                out << "neg %" << instr.lhs;
+                break;
+            case IrInstruction::Opcode::Abs:
+                out << "abs %" << instr.lhs;
+                break;
+            case IrInstruction::Opcode::Shl:
+                out << "shl %" << instr.lhs << ", " << instr.immediate;
+                break;
+            case IrInstruction::Opcode::DivPow2:
+                out << "divpow2 %" << instr.lhs << ", " << instr.immediate;
+                break;
+            case IrInstruction::Opcode::DivMagic: {
+                const MagicNumber& magic = magicnumbers[static_cast<size_t>(instr.immediate)];
+                out << "divmagic %" << instr.lhs << ", " << magic.factor << ", " << magic.shift << ", " << magic.adjust;
+                break;
+            }
+            case IrInstruction::Opcode::Add:
+                out << "add %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Sub:
+                out << "sub %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Mul:
+                out << "mul %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Div:
+                out << "div %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::DivNonZero:
+                out << "divnonzero %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Min:
+                out << "min %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Max:
+                out << "max %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Less:
+                out << "less %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::LessEqual:
+                out << "lessequal %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Equal:
+                out << "equal %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::NotEqual:
+                out << "notequal %" << instr.lhs << ", %" << instr.rhs;
+                break;
+            case IrInstruction::Opcode::Select:
+                out << "select %" << instr.condition << ", %" << instr.lhs << ", %" << instr.rhs;
+                break;
+        }
+
+        out << "\n";
+    }
+
+    out << "return";
+
+    for (size_t i = 0; i < results.size(); ++i)
+        out << (i == 0 ? " %" : ", %") << results[i];
+
+    out << "\n";
+}
+
+} // namespace jit
@@ -0,0 +1,138 @@
+#ifndef PLJIT_IRFUNCTION_H
+#define PLJIT_IRFUNCTION_H
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include "pljit/CodeManagement/SourceCodeManager.h"
+#include "pljit/Evaluation/Arithmetic.h"
+
+namespace jit {
+
+// IrInstruction                        A single instruction of the intermediate representation. Every instruction defines exactly one value, which is identified by the
+//                                      index of the instruction within its function (static single assignment form)
+struct IrInstruction {
+
+    enum class Opcode : uint8_t {
+        Const,          // value = immediate
+        Param,          // value = parameter with the index 'immediate'
+        Neg,            // value = -lhs
+        Abs,            // value = |lhs|
+        Shl,            // value = lhs << immediate
+        DivPow2,        // value = lhs / 2^immediate, cannot fail
+        DivMagic,       // value = lhs / d for a constant d, computed with the magic number of d with the index 'immediate' in the magic number table, cannot fail
+        Add,            // value = lhs + rhs
+        Sub,            // value = lhs - rhs
+        Mul,            // value = lhs * rhs
+        Div,            // value = lhs / rhs, fails if rhs is 0
+        DivNonZero,     // value = lhs / rhs, rhs is known to be non-zero (see RangeAnalysisOpt), cannot fail
+        Min,            // value = min(lhs, rhs)
+        Max,            // value = max(lhs, rhs)
+        Less,           // value = 1, if lhs < rhs, otherwise 0
+        LessEqual,      // value = 1, if lhs <= rhs, otherwise 0
+        Equal,          // value = 1, if lhs == rhs, otherwise 0
+        NotEqual,       // value = 1, if lhs != rhs, otherwise 0
+        Select          // value = lhs, if condition != 0, otherwise rhs. Both operands have been computed before, so the selection needs no branch
+    };
+
+    static constexpr size_t noLocation = static_cast<size_t>(-1);
+
+    Opcode opcode{};
+    size_t lhs{};                       // First operand (index of the defining instruction)
+    size_t rhs{};                       // Second operand (index of the defining instruction)
+    size_t condition{};                 // Third operand of Select (index of the defining instruction)
+    int64_t immediate{};                // Constant value (Const), parameter index (Param), shift (Shl, DivPow2) or index into the magic number table (DivMagic)
+    size_t location{noLocation};        // Index into the location table of the function, for instructions that can report errors (Div: the location of the divisor)
+    size_t slot{};                      // The slot of the frame that holds the value during execution (see IrFunction::assignSlots)
+
+    // isBinary                 Returns true, if the instruction has (at least) two operands
+    bool isBinary() const { return opcode >= Opcode::Add; }
+
+    // isUnary                  Returns true, if the instruction has exactly one operand
+    bool isUnary() const { return opcode >= Opcode::Neg && opcode < Opcode::Add; }
+
+    // isTernary                Returns true, if the instruction has a condition in addition to its two operands
+    bool isTernary() const { return opcode == Opcode::Select; }
+
+    // isComparison             Returns true, if the instruction compares its operands (its value is 0 or 1)
+    bool isComparison() const { return opcode >= Opcode::Less && opcode <= Opcode::NotEqual; }
+
+    // isCommutative            Returns true, if the operands of the instruction can be swapped
+    bool isCommutative() const { return opcode == Opcode::Add || opcode == Opcode::Mul || opcode == Opcode::Min || opcode == Opcode::Max || opcode == Opcode::Equal ||
+                                        opcode == Opcode::NotEqual; }
+
+    // mayFail                  Returns true, if executing the instruction can result in an error
+    bool mayFail() const { return opcode == Opcode::Div; }
+};
+
+// IrFunction                           A function in the intermediate representation. A function is a single sequence of instructions which is executed in order,
+//                                      conditional expressions compute both alternatives and select one of them (see IrBuilder). Assignments to parameters and variables
+//                                      do not exist anymore, every assignment defines a new value. During execution, the values are stored in the slots of a frame. Values whose lifetimes do not overlap share a slot
+class IrFunction {
+
+    public:
+
+    using ValueId = size_t;
+
+    // Constructor
+    explicit IrFunction(size_t nofparameters) : nofparameters{nofparameters} {}
+
+    // addConstant              Appends an instruction defining the given constant and returns its value
+    ValueId addConstant(int64_t value);
+
+    // addParameter             Appends an instruction defining the parameter with the given index and returns its value
+    ValueId addParameter(size_t index);
+
+    // addUnary                 Appends an instruction with one operand (and an optional immediate value) and returns its value
+    ValueId addUnary(IrInstruction::Opcode opcode, ValueId operand, int64_t immediate = 0);
+
+    // addBinary                Appends an instruction with two operands and returns its value
+    ValueId addBinary(IrInstruction::Opcode opcode, ValueId lhs, ValueId rhs);
+
+    // addDivision              Appends a division. The given location of the divisor is used to report a division by zero
+    ValueId addDivision(ValueId lhs, ValueId rhs, SourceCodeReference location);
+
+    // addSelect                Appends a selection of lhs (if the condition is non-zero) or rhs and returns its value
+    ValueId addSelect(ValueId condition, ValueId lhs, ValueId rhs);
+
+    // addGuardedDivision       Appends a division that is only executed, if the given guard (0 or 1) is 1. Otherwise, the divisor is replaced by 1, so that it cannot fail
+    ValueId addGuardedDivision(ValueId lhs, ValueId rhs, SourceCodeReference location, std::optional<ValueId> guard);
+
+    // inlineFunction           Appends the instructions of the given function, whose parameters are replaced by the given values, and returns the values it returns.
+    //                          Its divisions report their errors at the given location, or at their own locations (nullopt). With a guard, they are guarded divisions
+    std::vector<ValueId> inlineFunction(const IrFunction& function, const std::vector<ValueId>& arguments, std::optional<SourceCodeReference> location = std::nullopt,
+                                        std::optional<ValueId> guard = std::nullopt);
+
+    // getLocation              Returns the source code location of the given instruction (only valid for instructions that have one)
+    SourceCodeReference getLocation(const IrInstruction& instr) const { return locations[instr.location]; }
+
+    // removeInstructions       Removes all instructions that are marked in the given vector and renumbers the remaining values. The removed values must not be used
+    //                          by any remaining instruction. Reassigns the slots afterwards. Returns the number of removed instructions
+    size_t removeInstructions(const std::vector<bool>& removed);
+
+    // assignSlots              Assigns the frame slots to the values, so that a slot is reused as soon as the value it holds is not needed anymore.
+    //                          Must be called whenever an operand of an instruction has been changed. Removes the unused magic numbers as well
+    void assignSlots();
+
+    // print                    Prints the instructions in a readable text form (one instruction per line)
+    void print(std::ostream& out) const;
+
+    const size_t nofparameters;                         // The number of parameters of the function
+    std::vector<IrInstruction> instructions{};          // The instructions in order of execution
+    std::vector<SourceCodeReference> locations{};       // Source code locations referenced by the instructions
+    std::vector<MagicNumber> magicnumbers{};            // Magic numbers referenced by the DivMagic instructions (at most one per divisor)
+    std::vector<ValueId> results{};                     // The values returned by the function (a function compiled from several functions returns several values)
+    size_t nofslots{};                                  // The number of slots of the frame needed to execute the function
+    std::optional<std::vector<int64_t>> affine{};       // If known, the coefficients c0, c1, ... of the function, if it computes 'c0 + c1 * p0 + c2 * p1 + ...' (see PolynomialOpt)
+
+    private:
+
+    // compactMagicNumbers      Removes the magic numbers that are not referenced by a DivMagic instruction anymore and renumbers the remaining ones in order of their use
+    void compactMagicNumbers();
+};
+
+} // namespace jit
+
+#endif //PLJIT_IRFUNCTION_H
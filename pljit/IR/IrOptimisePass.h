@@ -0,0 +1,26 @@
+#ifndef PLJIT_IROPTIMISEPASS_H
+#define PLJIT_IROPTIMISEPASS_H
+
+#include <cstddef>
+
+namespace jit {
+
+class IrFunction;
+
+// IrOptimisePass                       Base class for optimisations on the intermediate representation of a function
+class IrOptimisePass {
+
+    public:
+
+    // Destructor
+    virtual ~IrOptimisePass() = default;
+
+    // run                      Optimises the given function and returns the number of instructions that have been changed or removed. Returns 0 exactly if the function
+    //                          has not been rewritten, so that repeated passes stop at a fixed point
+    virtual size_t run(IrFunction& function) = 0;
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_IROPTIMISEPASS_H
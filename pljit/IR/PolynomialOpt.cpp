@@ -0,0 +1,286 @@
+#include "PolynomialOpt.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace jit {
+
+bool PolynomialOpt::isTooLarge(const Polynomial& polynomial) {
+
+    // The constant and linear terms are limited by the number of parameters anyway, so affine polynomials of any number of parameters are analysed
+    size_t nofterms = static_cast<size_t>(count_if(polynomial.begin(), polynomial.end(), [](const auto& term) { return term.first.size() >= 2; }));
+
+    return nofterms > maxTerms;
+}
+
+optional<PolynomialOpt::Polynomial> PolynomialOpt::add(const Polynomial& lhs, const Polynomial& rhs, int64_t factor) {
+
+    Polynomial result = lhs;
+
+    for (const auto& [monomial, coefficient] : rhs) {
+
+        int64_t sum = wrappingAdd(result[monomial], wrappingMul(coefficient, factor));
+
+        if (sum == 0)
+            result.erase(monomial);
+        else
+            result[monomial] = sum;
+    }
+
+    if (isTooLarge(result))
+        return nullopt;
+
+    return result;
+}
+
+optional<PolynomialOpt::Polynomial> PolynomialOpt::multiply(const Polynomial& lhs, const Polynomial& rhs) {
+
+    Polynomial result{};
+
+    for (const auto& [lmonomial, lcoefficient] : lhs) {
+
+        for (const auto& [rmonomial, rcoefficient] : rhs) {
+
+            if (lmonomial.size() + rmonomial.size() > maxDegree)
+                return nullopt;
+
+            Monomial monomial{};
+            merge(lmonomial.begin(), lmonomial.end(), rmonomial.begin(), rmonomial.end(), back_inserter(monomial));
+
+            int64_t sum = wrappingAdd(result[monomial], wrappingMul(lcoefficient, rcoefficient));
+
+            if (sum == 0)
+                result.erase(monomial);
+            else
+                result[monomial] = sum;
+        }
+    }
+
+    if (isTooLarge(result))
+        return nullopt;
+
+    return result;
+}
+
+optional<int64_t> PolynomialOpt::constantOf(const Polynomial& polynomial) {
+
+    if (polynomial.empty())
+        return 0;
+
+    if (polynomial.size() == 1 && polynomial.begin()->first.empty())
+        return polynomial.begin()->second;
+
+    return nullopt;
+}
+
+optional<PolynomialOpt::Polynomial> PolynomialOpt::analyse(const IrFunction& function) {
+
+    using Opcode = IrInstruction::Opcode;
+
+    vector<Polynomial> polynomials{};
+    polynomials.reserve(function.instructions.size());
+
+    for (const IrInstruction& instr : function.instructions) {
+
+        optional<Polynomial> polynomial{};
+
+        switch (instr.opcode) {
+
+            case Opcode::Const:
+                polynomial = instr.immediate == 0 ? Polynomial{} : Polynomial{{Monomial{}, instr.immediate}};
+                break;
+            case Opcode::Param:
+                polynomial = Polynomial{{Monomial{static_cast<uint32_t>(instr.immediate)}, 1}};
+                break;
+            case Opcode::Neg:
+                polynomial = add(Polynomial{}, polynomials[instr.lhs], -1);
+                break;
+            case Opcode::Shl:
+                polynomial = add(Polynomial{}, polynomials[instr.lhs], shiftLeft(1, instr.immediate));
+                break;
+            case Opcode::Add:
+                polynomial = add(polynomials[instr.lhs], polynomials[instr.rhs], 1);
+                break;
+            case Opcode::Sub:
+                polynomial = add(polynomials[instr.lhs], polynomials[instr.rhs], -1);
+                break;
+            case Opcode::Mul:
+                polynomial = multiply(polynomials[instr.lhs], polynomials[instr.rhs]);
+                break;
+            case Opcode::DivPow2:
+            case Opcode::DivMagic:
+            case Opcode::Div:
+            case Opcode::DivNonZero: {
+
+                // Divisions (rounded towards zero) are not polynomial, they can only be folded if their operands are constant
+                optional<int64_t> dividend = constantOf(polynomials[instr.lhs]);
+
+                if (!dividend)
+                    return nullopt;
+
+                int64_t quotient{};
+
+                if (instr.opcode == Opcode::DivPow2)
+                    quotient = divideByPowerOfTwo(*dividend, instr.immediate);
+                else if (instr.opcode == Opcode::DivMagic)
+                    quotient = divideByMagicNumber(*dividend, function.magicnumbers[static_cast<size_t>(instr.immediate)]);
+                else {
+
+                    optional<int64_t> divisor = constantOf(polynomials[instr.rhs]);
+
+                    if (!divisor || *divisor == 0)
+                        return nullopt;
+
+                    quotient = wrappingDiv(*dividend, *divisor);
+                }
+
+                polynomial = quotient == 0 ? Polynomial{} : Polynomial{{Monomial{}, quotient}};
+                break;
+            }
+            case Opcode::Abs:
+            case Opcode::Min:
+            case Opcode::Max:
+            case Opcode::Less:
+            case Opcode::LessEqual:
+            case Opcode::Equal:
+            case Opcode::NotEqual:
+            case Opcode::Select:
+                // Piecewise functions are not polynomial (constant ones are folded by AlgebraicSimplifyOpt)
+                return nullopt;
+        }
+
+        if (!polynomial)
+            return nullopt;
+
+        polynomials.push_back(move(*polynomial));
+    }
+
+    // Functions returning several values are not normalised
+    if (function.results.size() != 1)
+        return nullopt;
+
+    return move(polynomials[function.results.front()]);
+}
+
+IrFunction PolynomialOpt::build(const Polynomial& polynomial, size_t nofparameters) {
+
+    using Opcode = IrInstruction::Opcode;
+
+    IrFunction out{nofparameters};
+
+    // Products of parameters that have already been computed (a parameter itself is a product with a single factor).
+    // The product of a monomial extends the product of its prefix, so that e.g. p0 * p0 is computed only once for p0 * p0 and p0 * p0 * p1
+    map<Monomial, IrFunction::ValueId> products{};
+
+    auto parameter = [&](uint32_t index) {
+        auto [it, inserted] = products.emplace(Monomial{index}, 0);
+        if (inserted)
+            it->second = out.addParameter(index);
+        return it->second;
+    };
+
+    auto product = [&](const Monomial& monomial) {
+
+        IrFunction::ValueId value = parameter(monomial.front());
+        Monomial prefix{monomial.front()};
+
+        for (size_t i = 1; i < monomial.size(); ++i) {
+
+            prefix.push_back(monomial[i]);
+
+            auto it = products.find(prefix);
+
+            if (it != products.end())
+                value = it->second;
+            else {
+                value = out.addBinary(Opcode::Mul, value, parameter(monomial[i]));
+                products.emplace(prefix, value);
+            }
+        }
+
+        return value;
+    };
+
+    optional<IrFunction::ValueId> sum{};
+    int64_t constant = 0;
+
+    for (const auto& [monomial, coefficient] : polynomial) {
+
+        if (monomial.empty()) {
+            constant = coefficient;
+            continue;
+        }
+
+        IrFunction::ValueId value = product(monomial);
+
+        if (coefficient == -1 && sum) {
+            sum = out.addBinary(Opcode::Sub, *sum, value);
+            continue;
+        }
+
+        if (coefficient == -1)
+            value = out.addUnary(Opcode::Neg, value);
+        else if (coefficient != 1) {
+            IrFunction::ValueId factor = out.addConstant(coefficient);
+            value = out.addBinary(Opcode::Mul, value, factor);
+        }
+
+        sum = sum ? out.addBinary(Opcode::Add, *sum, value) : value;
+    }
+
+    if (!sum)
+        out.results.push_back(out.addConstant(constant));
+    else if (constant != 0) {
+        IrFunction::ValueId value = out.addConstant(constant);
+        out.results.push_back(out.addBinary(Opcode::Add, *sum, value));
+    }
+    else
+        out.results.push_back(*sum);
+
+    out.assignSlots();
+
+    return out;
+}
+
+size_t PolynomialOpt::run(IrFunction& function) {
+
+    optional<Polynomial> polynomial = analyse(function);
+
+    if (!polynomial)
+        return 0;
+
+    // Store the coefficients of affine polynomials. This changes how the function is executed, so it counts as a change (unless they are stored already)
+    bool affine = all_of(polynomial->begin(), polynomial->end(), [](const auto& term) { return term.first.size() <= 1; });
+    size_t nofchanges = 0;
+
+    if (affine) {
+
+        vector<int64_t> coefficients(function.nofparameters + 1, 0);
+
+        for (const auto& [monomial, coefficient] : *polynomial)
+            coefficients[monomial.empty() ? 0 : monomial.front() + 1] = coefficient;
+
+        if (function.affine != coefficients) {
+            function.affine = move(coefficients);
+            ++nofchanges;
+        }
+    }
+
+    IrFunction out = build(*polynomial, function.nofparameters);
+
+    if (out.instructions.size() >= function.instructions.size())
+        return nofchanges;
+
+    nofchanges += function.instructions.size() - out.instructions.size();
+
+    function.instructions = move(out.instructions);
+    function.locations.clear();
+    function.magicnumbers.clear();
+    function.results = move(out.results);
+    function.assignSlots();
+
+    return nofchanges;
+}
+
+} // namespace jit
@@ -0,0 +1,62 @@
+#ifndef PLJIT_POLYNOMIALOPT_H
+#define PLJIT_POLYNOMIALOPT_H
+
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// PolynomialOpt                        Normalises a whole function into a polynomial in its parameters. As the arithmetic wraps around (i.e. it is the arithmetic of the integers
+//                                      modulo 2^64), expanding and collecting the terms never changes a result. If the polynomial is affine ('c0 + c1 * p1 + ...'), its
+//                                      coefficients are stored in the function, so that it can be executed as a dot product. If the polynomial needs fewer instructions than
+//                                      the function, the instructions are replaced by the ones of the polynomial.
+//                                      Functions containing divisions that cannot be folded, or whose polynomials become too large, are left unchanged
+class PolynomialOpt : public IrOptimisePass {
+
+    public:
+
+    // Monomial                 Product of parameters, given as the sorted indices of the parameters (e.g. {0, 0, 1} for p0 * p0 * p1, {} for 1)
+    using Monomial = std::vector<uint32_t>;
+
+    // Polynomial               Maps the monomials to their non-zero coefficients
+    using Polynomial = std::map<Monomial, int64_t>;
+
+    static constexpr size_t maxTerms = 32;          // The maximal number of terms of degree 2 or higher of a polynomial (the affine terms are not limited)
+    static constexpr size_t maxDegree = 8;          // The maximal degree of a polynomial
+
+    // Constructor
+    PolynomialOpt() = default;
+
+    // run                      Normalises the given function and returns the number of removed instructions, plus 1 if the coefficients of the affine polynomial
+    //                          have been stored
+    size_t run(IrFunction& function) override;
+
+    // analyse                  Returns the polynomial computed by the given function or nullopt, if the function is not a polynomial (within the limits above)
+    static std::optional<Polynomial> analyse(const IrFunction& function);
+
+    private:
+
+    // isTooLarge               Returns true, if the given polynomial has too many terms (see maxTerms)
+    static bool isTooLarge(const Polynomial& polynomial);
+
+    // add                      Returns lhs + factor * rhs or nullopt, if the result has too many terms
+    static std::optional<Polynomial> add(const Polynomial& lhs, const Polynomial& rhs, int64_t factor);
+
+    // multiply                 Returns lhs * rhs or nullopt, if the result has too many terms or its degree is too large
+    static std::optional<Polynomial> multiply(const Polynomial& lhs, const Polynomial& rhs);
+
+    // constantOf               Returns the value of the given polynomial, if it is constant
+    static std::optional<int64_t> constantOf(const Polynomial& polynomial);
+
+    // build                    Returns a function computing the given polynomial
+    static IrFunction build(const Polynomial& polynomial, size_t nofparameters);
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_POLYNOMIALOPT_H
@@ -0,0 +1,215 @@
+#include "RangeAnalysisOpt.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+
+using namespace std;
+
+namespace jit {
+
+namespace {
+
+__extension__ using int128 = __int128;
+
+const int128 minValue = numeric_limits<int64_t>::min();
+const int128 maxValue = numeric_limits<int64_t>::max();
+
+// fromBounds               Returns the range with the given bounds (computed without wrapping around), or the full range if a bound does not fit into 64 bits
+ValueRange fromBounds(int128 min, int128 max, uint16_t residues) {
+
+    if (min < minValue || max > maxValue)
+        return ValueRange{numeric_limits<int64_t>::min(), numeric_limits<int64_t>::max(), residues};
+
+    return ValueRange{static_cast<int64_t>(min), static_cast<int64_t>(max), residues};
+}
+
+// combineResidues          Returns the possible residues of 'op(lhs, rhs)' for the given possible residues of lhs and rhs (op must be compatible with the residues)
+template<typename F>
+uint16_t combineResidues(uint16_t lhs, uint16_t rhs, F op) {
+
+    uint16_t result = 0;
+
+    for (int64_t a = 0; a < 16; ++a)
+        for (int64_t b = 0; b < 16; ++b)
+            if ((lhs >> a & 1) != 0 && (rhs >> b & 1) != 0)
+                result |= static_cast<uint16_t>(1u << (op(a, b) & 15));
+
+    return result;
+}
+
+// cornerRange              Returns the range spanned by the given values
+ValueRange cornerRange(initializer_list<int128> corners, uint16_t residues) {
+
+    return fromBounds(min(corners), max(corners), residues);
+}
+
+// divide                   Returns the range of lhs / rhs. Divisors that are 0 are ignored, as the division fails for them
+ValueRange divide(ValueRange lhs, ValueRange rhs) {
+
+    if (rhs.min == 0)
+        rhs.min = 1;
+    if (rhs.max == 0)
+        rhs.max = -1;
+
+    if (rhs.min > rhs.max)
+        return ValueRange::full();
+
+    // The quotient of the minimal value and -1 wraps around
+    if (lhs.min == numeric_limits<int64_t>::min() && rhs.min <= -1 && rhs.max >= -1)
+        return ValueRange::full();
+
+    // The absolute value of the quotient is at most the one of the dividend
+    if (rhs.min < 0 && rhs.max > 0) {
+        int128 bound = max(-static_cast<int128>(lhs.min), static_cast<int128>(lhs.max));
+        return fromBounds(-bound, bound, ValueRange::allResidues);
+    }
+
+    // Otherwise the quotient is monotonic in both operands, so its extremes are at the corners
+    return cornerRange({lhs.min / rhs.min, lhs.min / rhs.max, lhs.max / rhs.min, lhs.max / rhs.max}, ValueRange::allResidues);
+}
+
+} // namespace
+
+ValueRange ValueRange::full() {
+
+    return ValueRange{numeric_limits<int64_t>::min(), numeric_limits<int64_t>::max(), allResidues};
+}
+
+ValueRange ValueRange::constant(int64_t value) {
+
+    return ValueRange{value, value, static_cast<uint16_t>(1u << (value & 15))};
+}
+
+vector<ValueRange> RangeAnalysisOpt::analyse(const IrFunction& function) {
+
+    using Opcode = IrInstruction::Opcode;
+
+    vector<ValueRange> ranges{};
+    ranges.reserve(function.instructions.size());
+
+    for (const IrInstruction& instr : function.instructions) {
+
+        ValueRange range = ValueRange::full();
+
+        ValueRange lhs = instr.isUnary() || instr.isBinary() ? ranges[instr.lhs] : ValueRange::full();
+        ValueRange rhs = instr.isBinary() ? ranges[instr.rhs] : ValueRange::full();
+
+        switch (instr.opcode) {
+
+            case Opcode::Const:
+                range = ValueRange::constant(instr.immediate);
+                break;
+            case Opcode::Param:
+                break;
+            case Opcode::Neg:
+                range = fromBounds(-static_cast<int128>(lhs.max), -static_cast<int128>(lhs.min),
+                                   combineResidues(lhs.residues, 1, [](int64_t a, int64_t) { return -a; }));
+                break;
+            case Opcode::Shl: {
+                int128 factor = static_cast<int128>(1) << instr.immediate;
+                range = fromBounds(lhs.min * factor, lhs.max * factor,
+                                   combineResidues(lhs.residues, 1, [&instr](int64_t a, int64_t) { return shiftLeft(a, instr.immediate); }));
+                break;
+            }
+            case Opcode::DivPow2:
+                range = cornerRange({divideByPowerOfTwo(lhs.min, instr.immediate), divideByPowerOfTwo(lhs.max, instr.immediate)}, ValueRange::allResidues);
+                break;
+            case Opcode::DivMagic: {
+                // The quotient is monotonic (increasing or decreasing, depending on the sign of the divisor)
+                const MagicNumber& magic = function.magicnumbers[static_cast<size_t>(instr.immediate)];
+                range = cornerRange({divideByMagicNumber(lhs.min, magic), divideByMagicNumber(lhs.max, magic)}, ValueRange::allResidues);
+                break;
+            }
+            case Opcode::Add:
+                range = fromBounds(static_cast<int128>(lhs.min) + rhs.min, static_cast<int128>(lhs.max) + rhs.max,
+                                   combineResidues(lhs.residues, rhs.residues, [](int64_t a, int64_t b) { return a + b; }));
+                break;
+            case Opcode::Sub:
+                range = fromBounds(static_cast<int128>(lhs.min) - rhs.max, static_cast<int128>(lhs.max) - rhs.min,
+                                   combineResidues(lhs.residues, rhs.residues, [](int64_t a, int64_t b) { return a - b; }));
+                break;
+            case Opcode::Mul: {
+                int128 a = lhs.min, b = lhs.max, c = rhs.min, d = rhs.max;
+                uint16_t residues = combineResidues(lhs.residues, rhs.residues, [](int64_t x, int64_t y) { return x * y; });
+
+                range = cornerRange({a * c, a * d, b * c, b * d}, residues);
+
+                // A square is not negative (unless it wraps around) and its residues are only the squares of the residues
+                if (instr.lhs == instr.rhs) {
+                    range.residues = combineResidues(lhs.residues, 1, [](int64_t x, int64_t) { return x * x; });
+                    if (a <= 0 && b >= 0 && range.min != numeric_limits<int64_t>::min())
+                        range.min = 0;
+                }
+                break;
+            }
+            case Opcode::Div:
+            case Opcode::DivNonZero:
+                range = divide(lhs, rhs);
+                break;
+            case Opcode::Abs: {
+                // The absolute value has the residues of the value or of its negation
+                uint16_t residues = lhs.residues | combineResidues(lhs.residues, 1, [](int64_t a, int64_t) { return -a; });
+
+                if (lhs.min >= 0)
+                    range = lhs;
+                else if (lhs.max <= 0)
+                    range = fromBounds(-static_cast<int128>(lhs.max), -static_cast<int128>(lhs.min), residues);
+                else
+                    range = fromBounds(0, max(-static_cast<int128>(lhs.min), static_cast<int128>(lhs.max)), residues);
+                break;
+            }
+            case Opcode::Min:
+                range = ValueRange{min(lhs.min, rhs.min), min(lhs.max, rhs.max), static_cast<uint16_t>(lhs.residues | rhs.residues)};
+                break;
+            case Opcode::Max:
+                range = ValueRange{max(lhs.min, rhs.min), max(lhs.max, rhs.max), static_cast<uint16_t>(lhs.residues | rhs.residues)};
+                break;
+            case Opcode::Less:
+            case Opcode::LessEqual:
+            case Opcode::Equal:
+            case Opcode::NotEqual:
+                range = ValueRange{0, 1, 3};
+                break;
+            case Opcode::Select:
+                // The value is one of the operands (e.g. the divisor of a guarded division is the original divisor or 1)
+                range = ValueRange{min(lhs.min, rhs.min), max(lhs.max, rhs.max), static_cast<uint16_t>(lhs.residues | rhs.residues)};
+                break;
+        }
+
+        // Ranges with a single value are exact
+        if (range.min == range.max)
+            range = ValueRange::constant(range.min);
+
+        ranges.push_back(range);
+    }
+
+    return ranges;
+}
+
+size_t RangeAnalysisOpt::run(IrFunction& function) {
+
+    vector<ValueRange> ranges = analyse(function);
+
+    zerodivisors.clear();
+    size_t nofreplaced = 0;
+
+    for (IrInstruction& instr : function.instructions) {
+
+        if (instr.opcode != IrInstruction::Opcode::Div)
+            continue;
+
+        const ValueRange& divisor = ranges[instr.rhs];
+
+        if (divisor.isZero())
+            zerodivisors.push_back(function.getLocation(instr));
+        else if (!divisor.mayBeZero()) {
+            instr.opcode = IrInstruction::Opcode::DivNonZero;
+            ++nofreplaced;
+        }
+    }
+
+    return nofreplaced;
+}
+
+} // namespace jit
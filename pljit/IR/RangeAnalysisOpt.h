@@ -0,0 +1,60 @@
+#ifndef PLJIT_RANGEANALYSISOPT_H
+#define PLJIT_RANGEANALYSISOPT_H
+
+#include <vector>
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// ValueRange                           Describes the possible values of a value by an interval and by the possible residues modulo 16 (which, unlike the interval, stay exact
+//                                      when the arithmetic wraps around, e.g. 'a * a + 1' is odd or 2 modulo 4 and therefore never 0)
+struct ValueRange {
+
+    static constexpr uint16_t allResidues = 0xFFFF;
+
+    int64_t min;                // The smallest possible value
+    int64_t max;                // The largest possible value
+    uint16_t residues;          // Bit r is set, if the value may be r modulo 16
+
+    // full                     Returns the range containing all values
+    static ValueRange full();
+
+    // constant                 Returns the range only containing the given value
+    static ValueRange constant(int64_t value);
+
+    // mayBeZero                Returns true, if the value may be 0
+    bool mayBeZero() const { return min <= 0 && max >= 0 && (residues & 1) != 0; }
+
+    // isZero                   Returns true, if the value is always 0
+    bool isZero() const { return min == 0 && max == 0; }
+};
+
+// RangeAnalysisOpt                     Computes the ranges of all values of a function. Divisions whose divisors are never 0 do not need to check their divisors and are
+//                                      replaced by DivNonZero instructions. Divisions whose divisors are always 0 are remembered, as the function always fails
+class RangeAnalysisOpt : public IrOptimisePass {
+
+    public:
+
+    // Constructor
+    RangeAnalysisOpt() = default;
+
+    // run                      Replaces the divisions by non-zero divisors of the given function and returns their number
+    size_t run(IrFunction& function) override;
+
+    // analyse                  Returns the ranges of the values of the given function
+    static std::vector<ValueRange> analyse(const IrFunction& function);
+
+    // getZeroDivisors          Returns the locations of the divisors that are always 0, found by the last run
+    const std::vector<SourceCodeReference>& getZeroDivisors() const { return zerodivisors; }
+
+    private:
+
+    std::vector<SourceCodeReference> zerodivisors{};         // The locations of the divisors that are always 0
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_RANGEANALYSISOPT_H
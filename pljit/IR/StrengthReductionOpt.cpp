@@ -0,0 +1,203 @@
+#include "StrengthReductionOpt.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace jit {
+
+namespace {
+
+// absolute                 Returns the absolute value of the given value (also for the minimal value)
+uint64_t absolute(int64_t value) { return value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value); }
+
+// exactLog2                Returns k, if the given value is 2^k, otherwise nullopt
+optional<int64_t> exactLog2(uint64_t value) {
+
+    if (value == 0 || (value & (value - 1)) != 0)
+        return nullopt;
+
+    int64_t k = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++k;
+    }
+
+    return k;
+}
+
+} // namespace
+
+MagicNumber StrengthReductionOpt::computeMagicNumber(int64_t divisor) {
+
+    const uint64_t two63 = uint64_t{1} << 63;
+
+    uint64_t ad = absolute(divisor);
+    uint64_t t = two63 + (static_cast<uint64_t>(divisor) >> 63);
+    uint64_t anc = t - 1 - t % ad;                  // Absolute value of the largest value that is divisible with the smallest remainder
+
+    int64_t p = 63;
+    uint64_t q1 = two63 / anc;                      // q1 = 2^p / |nc|
+    uint64_t r1 = two63 - q1 * anc;                 // r1 = rem(2^p, |nc|)
+    uint64_t q2 = two63 / ad;                       // q2 = 2^p / |d|
+    uint64_t r2 = two63 - q2 * ad;                  // r2 = rem(2^p, |d|)
+    uint64_t delta{};
+
+    do {
+        ++p;
+
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            ++q1;
+            r1 -= anc;
+        }
+
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            ++q2;
+            r2 -= ad;
+        }
+
+        delta = ad - r2;
+
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    int64_t factor = static_cast<int64_t>(q2 + 1);
+
+    if (divisor < 0)
+        factor = wrappingNeg(factor);
+
+    // The factor does not fit into 64 bits, if its sign differs from the divisor's. This is corrected by adding (or subtracting) the value to the product
+    int64_t adjust = 0;
+
+    if (divisor > 0 && factor < 0)
+        adjust = 1;
+    else if (divisor < 0 && factor > 0)
+        adjust = -1;
+
+    return MagicNumber{factor, p - 64, adjust, divisor};
+}
+
+optional<IrFunction::ValueId> StrengthReductionOpt::reduceMultiplication(IrFunction& out, IrFunction::ValueId value, int64_t factor) {
+
+    auto k = exactLog2(absolute(factor));
+
+    if (!k)
+        return nullopt;
+
+    IrFunction::ValueId result = *k == 0 ? value : out.addUnary(IrInstruction::Opcode::Shl, value, *k);
+
+    if (factor < 0)
+        result = out.addUnary(IrInstruction::Opcode::Neg, result);
+
+    return result;
+}
+
+IrFunction::ValueId StrengthReductionOpt::reduceDivision(IrFunction& out, IrFunction::ValueId value, int64_t divisor) {
+
+    using Opcode = IrInstruction::Opcode;
+
+    if (divisor == 1)
+        return value;
+
+    if (divisor == -1)
+        return out.addUnary(Opcode::Neg, value);
+
+    // Division by 2^k
+    if (auto k = exactLog2(absolute(divisor))) {
+
+        IrFunction::ValueId quotient = out.addUnary(Opcode::DivPow2, value, *k);
+        return divisor < 0 ? out.addUnary(Opcode::Neg, quotient) : quotient;
+    }
+
+    // Division by other constants: Multiply with the magic number of the divisor
+    auto [it, inserted] = magicindex.emplace(divisor, out.magicnumbers.size());
+
+    if (inserted)
+        out.magicnumbers.push_back(computeMagicNumber(divisor));
+
+    return out.addUnary(Opcode::DivMagic, value, static_cast<int64_t>(it->second));
+}
+
+size_t StrengthReductionOpt::run(IrFunction& function) {
+
+    const vector<IrInstruction>& instructions = function.instructions;
+
+    // Returns the value of the given instruction, if it is a constant
+    auto constant = [&](IrFunction::ValueId v) -> optional<int64_t> {
+        if (instructions[v].opcode == IrInstruction::Opcode::Const)
+            return instructions[v].immediate;
+        return nullopt;
+    };
+
+    // The function is rebuilt, as the replaced instructions may need several new ones
+    IrFunction out{function.nofparameters};
+    out.instructions.reserve(instructions.size());
+    out.magicnumbers = function.magicnumbers;
+
+    // Divisors reduced by earlier runs keep their magic numbers
+    magicindex.clear();
+    for (size_t m = 0; m < out.magicnumbers.size(); ++m)
+        magicindex.emplace(out.magicnumbers[m].divisor, m);
+
+    vector<IrFunction::ValueId> newid(instructions.size());
+    size_t nofreplaced = 0;
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        IrInstruction instr = instructions[i];
+        optional<IrFunction::ValueId> replaced{};
+
+        if (instr.opcode == IrInstruction::Opcode::Mul) {
+
+            if (auto factor = constant(instr.rhs))
+                replaced = reduceMultiplication(out, newid[instr.lhs], *factor);
+            else if (auto factor = constant(instr.lhs))
+                replaced = reduceMultiplication(out, newid[instr.rhs], *factor);
+        }
+        else if (instr.opcode == IrInstruction::Opcode::Div) {
+
+            auto divisor = constant(instr.rhs);
+
+            if (divisor && *divisor != 0)
+                replaced = reduceDivision(out, newid[instr.lhs], *divisor);
+        }
+
+        if (replaced) {
+            newid[i] = *replaced;
+            ++nofreplaced;
+            continue;
+        }
+
+        // Copy the instruction
+        if (instr.isUnary() || instr.isBinary())
+            instr.lhs = newid[instr.lhs];
+        if (instr.isBinary())
+            instr.rhs = newid[instr.rhs];
+        if (instr.isTernary())
+            instr.condition = newid[instr.condition];
+
+        if (instr.mayFail())
+            newid[i] = out.addDivision(instr.lhs, instr.rhs, function.getLocation(instr));
+        else {
+            out.instructions.push_back(instr);
+            newid[i] = out.instructions.size() - 1;
+        }
+    }
+
+    if (nofreplaced == 0)
+        return 0;
+
+    function.instructions = move(out.instructions);
+    function.locations = move(out.locations);
+    function.magicnumbers = move(out.magicnumbers);
+    for (IrFunction::ValueId& result : function.results)
+        result = newid[result];
+    function.assignSlots();
+
+    return nofreplaced;
+}
+
+} // namespace jit
@@ -0,0 +1,45 @@
+#ifndef PLJIT_STRENGTHREDUCTIONOPT_H
+#define PLJIT_STRENGTHREDUCTIONOPT_H
+
+#include <optional>
+#include <unordered_map>
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// StrengthReductionOpt                 Replaces multiplications and divisions by constants with cheaper instructions:
+//                                      x * 2^k becomes a left shift, x / 2^k a sequence of shifts (DivPow2) and x / c (for other non-zero constants c) a multiplication
+//                                      with a 'magic number' followed by shifts (DivMagic, see H. S. Warren, Hacker's Delight, chapter 10). Each sequence is a single
+//                                      instruction, as executing an instruction is more expensive than the operations of the sequence. The results (rounded towards zero)
+//                                      stay the same. As the divisors of the replaced divisions are known to be non-zero, the division-by-zero checks are dropped as well
+class StrengthReductionOpt : public IrOptimisePass {
+
+    public:
+
+    // Constructor
+    StrengthReductionOpt() = default;
+
+    // run                      Replaces the multiplications and divisions in the given function and returns the number of replaced instructions
+    size_t run(IrFunction& function) override;
+
+    // computeMagicNumber       Computes the magic number for the given divisor. The absolute value of the divisor must be at least 2 and not be a power of two
+    static MagicNumber computeMagicNumber(int64_t divisor);
+
+    private:
+
+    // reduceMultiplication     Appends the instructions computing value * factor to the given function, if the factor is a power of two (or its negation).
+    //                          Returns the new value or nullopt, if the multiplication is not replaced
+    static std::optional<IrFunction::ValueId> reduceMultiplication(IrFunction& out, IrFunction::ValueId value, int64_t factor);
+
+    // reduceDivision           Appends the instructions computing value / divisor to the given function, the divisor must not be zero. Returns the new value
+    IrFunction::ValueId reduceDivision(IrFunction& out, IrFunction::ValueId value, int64_t divisor);
+
+    std::unordered_map<int64_t, size_t> magicindex{};       // Maps the divisors to the indices of their magic numbers in the magic number table
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_STRENGTHREDUCTIONOPT_H
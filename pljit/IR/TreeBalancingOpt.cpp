@@ -0,0 +1,145 @@
+#include "TreeBalancingOpt.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace jit {
+
+IrFunction::ValueId TreeBalancingOpt::build(IrFunction& out, IrInstruction::Opcode opcode, const vector<IrFunction::ValueId>& operands, size_t begin, size_t end) {
+
+    // The depth of the tree is logarithmic, so the recursion is bounded
+    if (end - begin == 1)
+        return operands[begin];
+
+    size_t mid = begin + (end - begin) / 2;
+
+    IrFunction::ValueId lhs = build(out, opcode, operands, begin, mid);
+    IrFunction::ValueId rhs = build(out, opcode, operands, mid, end);
+
+    return out.addBinary(opcode, lhs, rhs);
+}
+
+size_t TreeBalancingOpt::run(IrFunction& function) {
+
+    const vector<IrInstruction>& instructions = function.instructions;
+
+    auto associative = [](const IrInstruction& instr) { return instr.opcode == IrInstruction::Opcode::Add || instr.opcode == IrInstruction::Opcode::Mul ||
+                                                               instr.opcode == IrInstruction::Opcode::Min || instr.opcode == IrInstruction::Opcode::Max; };
+
+    // Count the uses of each value and remember the (last) instruction using it
+    vector<size_t> uses(instructions.size(), 0);
+    vector<size_t> user(instructions.size(), 0);
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        const IrInstruction& instr = instructions[i];
+
+        if (instr.isUnary() || instr.isBinary()) {
+            ++uses[instr.lhs];
+            user[instr.lhs] = i;
+        }
+        if (instr.isBinary()) {
+            ++uses[instr.rhs];
+            user[instr.rhs] = i;
+        }
+        if (instr.isTernary()) {
+            ++uses[instr.condition];
+            user[instr.condition] = i;
+        }
+    }
+
+    // The results are used by the caller
+    vector<bool> returned(instructions.size(), false);
+
+    for (IrFunction::ValueId result : function.results) {
+        ++uses[result];
+        returned[result] = true;
+    }
+
+    // An instruction is inside of a chain, if its only use is an instruction with the same associative operation. These instructions are rebuilt with the root of their chain
+    vector<bool> inner(instructions.size(), false);
+
+    for (size_t i = 0; i < instructions.size(); ++i)
+        inner[i] = associative(instructions[i]) && uses[i] == 1 && !returned[i] && instructions[user[i]].opcode == instructions[i].opcode;
+
+    IrFunction out{function.nofparameters};
+    out.instructions.reserve(instructions.size());
+    out.magicnumbers = function.magicnumbers;
+
+    vector<IrFunction::ValueId> newid(instructions.size());
+    size_t nofbalanced = 0;
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        IrInstruction instr = instructions[i];
+
+        if (inner[i])
+            continue;
+
+        if (associative(instr)) {
+
+            // Collect the operands of the chain from left to right and determine its depth
+            vector<IrFunction::ValueId> operands{};
+            vector<pair<IrFunction::ValueId, size_t>> stack{{instr.rhs, 1}, {instr.lhs, 1}};
+            size_t depth = 1;
+
+            while (!stack.empty()) {
+
+                auto [v, d] = stack.back();
+                stack.pop_back();
+
+                if (inner[v]) {
+                    stack.emplace_back(instructions[v].rhs, d + 1);
+                    stack.emplace_back(instructions[v].lhs, d + 1);
+                    depth = max(depth, d + 1);
+                }
+                else
+                    operands.push_back(newid[v]);
+            }
+
+            // The minimal depth of a tree with n operands is ceil(log2(n))
+            size_t mindepth = 0;
+            while ((size_t{1} << mindepth) < operands.size())
+                ++mindepth;
+
+            // Chains that are already balanced are rebuilt as well, with the same number of operations
+            newid[i] = build(out, instr.opcode, operands, 0, operands.size());
+
+            if (depth > mindepth)
+                ++nofbalanced;
+
+            continue;
+        }
+
+        // Copy the instruction
+        if (instr.isUnary() || instr.isBinary())
+            instr.lhs = newid[instr.lhs];
+        if (instr.isBinary())
+            instr.rhs = newid[instr.rhs];
+        if (instr.isTernary())
+            instr.condition = newid[instr.condition];
+
+        if (instr.mayFail())
+            newid[i] = out.addDivision(instr.lhs, instr.rhs, function.getLocation(instr));
+        else {
+            out.instructions.push_back(instr);
+            newid[i] = out.instructions.size() - 1;
+        }
+    }
+
+    if (nofbalanced == 0)
+        return 0;
+
+    function.instructions = move(out.instructions);
+    function.locations = move(out.locations);
+    function.magicnumbers = move(out.magicnumbers);
+    for (IrFunction::ValueId& result : function.results)
+        result = newid[result];
+    function.assignSlots();
+
+    return nofbalanced;
+}
+
+} // namespace jit
@@ -0,0 +1,33 @@
+#ifndef PLJIT_TREEBALANCINGOPT_H
+#define PLJIT_TREEBALANCINGOPT_H
+
+#include <vector>
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// TreeBalancingOpt                     Rebalances chains of additions, multiplications, minima and maxima (e.g. 'a + (b + (c + d))', as produced by the right recursive
+//                                      grammar), so that the operations do not depend on each other serially and can be overlapped by the processor. As the arithmetic wraps
+//                                      around, additions and multiplications are associative (like minima and maxima) and the results do not change
+class TreeBalancingOpt : public IrOptimisePass {
+
+    public:
+
+    // Constructor
+    TreeBalancingOpt() = default;
+
+    // run                      Rebalances the chains of the given function and returns the number of rebalanced chains
+    size_t run(IrFunction& function) override;
+
+    private:
+
+    // build                    Appends a balanced tree of the given operation over the given operands to the function and returns its value
+    static IrFunction::ValueId build(IrFunction& out, IrInstruction::Opcode opcode, const std::vector<IrFunction::ValueId>& operands, size_t begin, size_t end);
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_TREEBALANCINGOPT_H
@@ -0,0 +1,92 @@
+#include "ValueNumberingOpt.h"
+
+#include <unordered_map>
+
+using namespace std;
+
+namespace jit {
+
+namespace {
+
+// ExpressionKey            Identifies the operation computed by an instruction (the opcode, the operand values and the immediate value resp. the condition)
+struct ExpressionKey {
+
+    IrInstruction::Opcode opcode;
+    size_t lhs;
+    size_t rhs;
+    int64_t immediate;
+
+    bool operator==(const ExpressionKey& other) const { return opcode == other.opcode && lhs == other.lhs && rhs == other.rhs && immediate == other.immediate; }
+};
+
+struct ExpressionKeyHash {
+
+    size_t operator()(const ExpressionKey& key) const {
+
+        size_t h = static_cast<size_t>(key.opcode);
+        h = h * 1000003 ^ key.lhs;
+        h = h * 1000003 ^ key.rhs;
+        h = h * 1000003 ^ static_cast<size_t>(key.immediate);
+        return h;
+    }
+};
+
+} // namespace
+
+size_t ValueNumberingOpt::run(IrFunction& function) {
+
+    vector<IrInstruction>& instructions = function.instructions;
+
+    // The value each instruction has been replaced by (the instruction itself, if it is not redundant)
+    vector<IrFunction::ValueId> replacement(instructions.size());
+    vector<bool> removed(instructions.size(), false);
+
+    unordered_map<ExpressionKey, IrFunction::ValueId, ExpressionKeyHash> known{};
+    known.reserve(instructions.size());
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+
+        IrInstruction& instr = instructions[i];
+
+        // Operands refer to the remaining representative of their value
+        if (instr.isUnary() || instr.isBinary())
+            instr.lhs = replacement[instr.lhs];
+        if (instr.isBinary())
+            instr.rhs = replacement[instr.rhs];
+        if (instr.isTernary())
+            instr.condition = replacement[instr.condition];
+
+        ExpressionKey key{instr.opcode, 0, 0, 0};
+
+        if (instr.opcode == IrInstruction::Opcode::Const || instr.opcode == IrInstruction::Opcode::Param)
+            key.immediate = instr.immediate;
+        else if (instr.isUnary()) {
+            key.lhs = instr.lhs;
+            key.immediate = instr.immediate;
+        }
+        else if (instr.isCommutative()) {
+            key.lhs = min(instr.lhs, instr.rhs);
+            key.rhs = max(instr.lhs, instr.rhs);
+        }
+        else {
+            key.lhs = instr.lhs;
+            key.rhs = instr.rhs;
+
+            // The condition of a selection takes the place of the immediate value
+            if (instr.isTernary())
+                key.immediate = static_cast<int64_t>(instr.condition);
+        }
+
+        auto [it, inserted] = known.emplace(key, i);
+
+        replacement[i] = it->second;
+        removed[i] = !inserted;
+    }
+
+    for (IrFunction::ValueId& result : function.results)
+        result = replacement[result];
+
+    return function.removeInstructions(removed);
+}
+
+} // namespace jit
@@ -0,0 +1,27 @@
+#ifndef PLJIT_VALUENUMBERINGOPT_H
+#define PLJIT_VALUENUMBERINGOPT_H
+
+#include "IrFunction.h"
+#include "IrOptimisePass.h"
+
+namespace jit {
+
+// ValueNumberingOpt                    Performs a value numbering (common subexpression elimination) on the intermediate representation: if an instruction computes the
+//                                      same operation on the same values as a previous instruction, its uses are redirected to the previous instruction and it is removed.
+//                                      As a function is a single sequence of instructions, the previous instruction always has been executed before. This also holds for
+//                                      divisions: a repeated division cannot fail, if the first one did not, so the first division by zero is still reported at the same place
+class ValueNumberingOpt : public IrOptimisePass {
+
+    public:
+
+    // Constructor
+    ValueNumberingOpt() = default;
+
+    // run                      Removes the redundant instructions of the given function and returns their number
+    size_t run(IrFunction& function) override;
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_VALUENUMBERINGOPT_H
@@ -0,0 +1,67 @@
+#include "IdentifierTable.h"
+
+using namespace std;
+
+namespace jit {
+
+uint64_t IdentifierTable::hash(string_view name) {
+
+    uint64_t h = 14695981039346656037ull;
+
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+
+    return h;
+}
+
+size_t IdentifierTable::intern(string_view name) {
+
+    uint64_t h = hash(name);
+    size_t mask = slots.size() - 1;
+
+    // Linear probing until either the name or an empty slot is found
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+
+        Slot& slot = slots[i];
+
+        if (slot.id == emptySlot) {
+
+            slot.hash = h;
+            slot.id = static_cast<uint32_t>(names.size());
+            names.push_back(name);
+
+            // Keep the load factor below 1/2
+            if (names.size() * 2 > slots.size())
+                grow();
+
+            return names.size() - 1;
+        }
+
+        if (slot.hash == h && names[slot.id] == name)
+            return slot.id;
+    }
+}
+
+void IdentifierTable::grow() {
+
+    vector<Slot> old = move(slots);
+    slots = vector<Slot>(old.size() * 2);
+
+    size_t mask = slots.size() - 1;
+
+    for (const Slot& s : old) {
+
+        if (s.id == emptySlot)
+            continue;
+
+        size_t i = s.hash & mask;
+        while (slots[i].id != emptySlot)
+            i = (i + 1) & mask;
+
+        slots[i] = s;
+    }
+}
+
+} // namespace jit
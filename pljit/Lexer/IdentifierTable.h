@@ -0,0 +1,50 @@
+#ifndef PLJIT_IDENTIFIERTABLE_H
+#define PLJIT_IDENTIFIERTABLE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace jit {
+
+// IdentifierTable      Interns the names of identifiers. Every distinct name gets a dense id (0, 1, 2, ...) the first time it is seen, so that later phases can
+//                      work with direct-indexed arrays instead of comparing strings. Internally an open-addressing hash map with linear probing is used.
+class IdentifierTable {
+
+    public:
+
+    // Constructor
+    IdentifierTable() : slots(initialCapacity) {}
+
+    // intern           Returns the id of the given name. If the name has not been seen before, a new id is assigned
+    size_t intern(std::string_view name);
+
+    // size             Returns the number of distinct names, i.e. all ids are smaller than this value
+    size_t size() const { return names.size(); }
+
+    // getName          Returns the name belonging to the given id
+    std::string_view getName(size_t id) const { return names[id]; }
+
+    private:
+
+    static constexpr size_t initialCapacity = 64;       // Must be a power of two
+    static constexpr uint32_t emptySlot = UINT32_MAX;   // Marks an unused slot
+
+    struct Slot {
+        uint64_t hash{0};               // The full hash value of the name stored in this slot
+        uint32_t id{emptySlot};         // The id of the name stored in this slot
+    };
+
+    std::vector<Slot> slots;                    // The hash table (the names themselves are stored in 'names', indexed by id)
+    std::vector<std::string_view> names{};      // The interned names in order of their ids
+
+    // hash             FNV-1a hash over the characters of the name
+    static uint64_t hash(std::string_view name);
+
+    // grow             Doubles the capacity of the hash table and reinserts all ids
+    void grow();
+};
+
+} // namespace jit
+
+#endif //PLJIT_IDENTIFIERTABLE_H
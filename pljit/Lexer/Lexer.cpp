@@ -1,5 +1,8 @@
 #include "Lexer.h"
 
+#include <array>
+#include <limits>
+
 
 using namespace std;
 
@@ -10,6 +13,109 @@ using SeparatorType = Separator::SeparatorType;
 using ArithmeticType = ArithmeticOperator::ArithmeticType;
 using KeywordType = Keyword::KeywordType;
 
+namespace {
+
+// The keywords of the PL together with their keyword types
+struct KeywordEntry {
+    string_view text;
+    KeywordType type;
+};
+
+constexpr array<KeywordEntry, 13> keywords{{{"PARAM", KeywordType::Parameter},
+                                            {"VAR", KeywordType::Var},
+                                            {"CONST", KeywordType::Constant},
+                                            {"BEGIN", KeywordType::Begin},
+                                            {"END", KeywordType::End},
+                                            {"RETURN", KeywordType::Ret},
+                                            {"CALL", KeywordType::Call},
+                                            {"IF", KeywordType::If},
+                                            {"THEN", KeywordType::Then},
+                                            {"ELSE", KeywordType::Else},
+                                            {"MIN", KeywordType::Min},
+                                            {"MAX", KeywordType::Max},
+                                            {"ABS", KeywordType::Abs}}};
+
+constexpr size_t minKeywordLength = 2;
+constexpr size_t maxKeywordLength = 6;
+constexpr size_t keywordTableSize = 32;
+
+// keywordHash          Hash function over the length, the first and the last character of a word (MIN and MAX only differ in the last one). The multiplier is
+//                      chosen at compile time, so that the hash is perfect for the keywords
+constexpr size_t keywordHash(size_t length, char first, char last, size_t multiplier) {
+
+    return (length * multiplier + static_cast<unsigned char>(first) + 3 * static_cast<size_t>(static_cast<unsigned char>(last))) % keywordTableSize;
+}
+
+// findKeywordMultiplier    Searches the smallest multiplier for which keywordHash maps all keywords to distinct slots
+constexpr size_t findKeywordMultiplier() {
+
+    for (size_t multiplier = 1; multiplier < 256; ++multiplier) {
+
+        array<bool, keywordTableSize> used{};
+        bool collision{false};
+
+        for (const auto& kw : keywords) {
+
+            size_t h = keywordHash(kw.text.size(), kw.text.front(), kw.text.back(), multiplier);
+            collision = collision || used[h];
+            used[h] = true;
+        }
+
+        if (!collision)
+            return multiplier;
+    }
+
+    return 0;
+}
+
+constexpr size_t keywordMultiplier = findKeywordMultiplier();
+static_assert(keywordMultiplier != 0, "No perfect hash found for the keywords");
+
+// buildKeywordTable        Creates the hash table mapping a hash value to the index of the keyword in 'keywords' (or -1 for empty slots)
+constexpr array<int, keywordTableSize> buildKeywordTable() {
+
+    array<int, keywordTableSize> table{};
+
+    for (auto& slot : table)
+        slot = -1;
+
+    for (size_t i = 0; i < keywords.size(); ++i)
+        table[keywordHash(keywords[i].text.size(), keywords[i].text.front(), keywords[i].text.back(), keywordMultiplier)] = static_cast<int>(i);
+
+    return table;
+}
+
+constexpr array<int, keywordTableSize> keywordTable = buildKeywordTable();
+
+} // namespace
+
+
+optional<KeywordType> Lexer::lookupKeyword(string_view word) {
+
+    if (word.size() < minKeywordLength || word.size() > maxKeywordLength)
+        return nullopt;
+
+    int index = keywordTable[keywordHash(word.size(), word.front(), word.back(), keywordMultiplier)];
+
+    // The hash is perfect for the keywords, so one single comparison decides whether the word is a keyword
+    if (index < 0 || keywords[index].text != word)
+        return nullopt;
+
+    return keywords[index].type;
+}
+
+
+bool Lexer::checkSourceSize() const {
+
+    // Source code references can only represent positions up to a fixed limit
+    if (code.size() > SourceCodeReference::maxOffset) {
+        cerr << "error: Source code is too large (at most " << SourceCodeReference::maxOffset << " characters are allowed)\n";
+        return false;
+    }
+
+    return true;
+}
+
 
 unique_ptr<Token> Lexer::nextToken() {
 
@@ -25,20 +131,33 @@ unique_ptr<Token> Lexer::nextToken() {
 
     // Check for literal
     if (isdigit(*currAbsPos)) {
-        int64_t value = strtol(currAbsPos, nullptr, 10);
 
+        // Parse the digits by hand (the source code view is not null-terminated) and detect values that do not fit into an int64_t
+        int64_t value{0};
+        bool overflow{false};
         size_t n{0};
 
-        while (isdigit(*(currAbsPos + n)))
+        while (currAbsPos + n != code.end() && isdigit(currAbsPos[n])) {
+
+            int64_t digit = currAbsPos[n] - '0';
+
+            if (value > (numeric_limits<int64_t>::max() - digit) / 10)
+                overflow = true;
+            else
+                value = value * 10 + digit;
+
             ++n;
+        }
+
+        if (overflow) {
+            manager.printErrorMessage("error: integer literal is too large", SourceCodeReference(currentOffset(), n));
+            return nullptr;
+        }
 
-        res = make_unique<Literal>(SourceCodeReference(currLine, currPos, n), value);
+        res = make_unique<Literal>(SourceCodeReference(currentOffset(), n), value);
 
         // Move Lexer position to the end of the literal
-        while (isdigit(*currAbsPos)) {
-            ++currPos;
-            ++currAbsPos;
-        }
+        currAbsPos += n;
 
         return res;
     }
@@ -46,111 +165,104 @@ unique_ptr<Token> Lexer::nextToken() {
     else if (isalpha(*currAbsPos)) {
         // calculate the length of the token
         size_t n = 0;
-        while (isalpha(currAbsPos[n]))
+        while (currAbsPos + n != code.end() && isalpha(currAbsPos[n]))
             ++n;
 
         string_view tk(currAbsPos, n);
 
-        if (tk == "PARAM")
-            res = make_unique<Keyword>(SourceCodeReference(currLine, currPos, n), KeywordType::Parameter);
-        else if (tk == "VAR")
-            res = make_unique<Keyword>(SourceCodeReference(currLine, currPos, n), KeywordType::Var);
-        else if (tk == "CONST")
-            res = make_unique<Keyword>(SourceCodeReference(currLine, currPos, n), KeywordType::Constant);
-        else if (tk == "BEGIN")
-            res = make_unique<Keyword>(SourceCodeReference(currLine, currPos, n), KeywordType::Begin);
-        else if (tk == "END")
-            res = make_unique<Keyword>(SourceCodeReference(currLine, currPos, n), KeywordType::End);
-        else if (tk == "RETURN")
-            res = make_unique<Keyword>(SourceCodeReference(currLine, currPos, n), KeywordType::Ret);
-        else {
-            res = make_unique<Identifier>(SourceCodeReference(currLine, currPos, n));
-        }
+        auto keyword = lookupKeyword(tk);
+
+        if (keyword)
+            res = make_unique<Keyword>(SourceCodeReference(currentOffset(), n), *keyword);
+        else
+            res = make_unique<Identifier>(SourceCodeReference(currentOffset(), n), identifiers.intern(tk));
+
         currAbsPos += n;
-        currPos += n;
         return res;
     }
     // Check for Separator tokens
     else if (*currAbsPos == '.') {
-        res = make_unique<Separator>(SourceCodeReference(currLine, currPos), SeparatorType::Dot);
-        ++currPos;
+        res = make_unique<Separator>(refToCurrentPosition(), SeparatorType::Dot);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == ',') {
-        res = make_unique<Separator>(SourceCodeReference(currLine, currPos), SeparatorType::Comma);
-        ++currPos;
+        res = make_unique<Separator>(refToCurrentPosition(), SeparatorType::Comma);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == ';') {
-        res = make_unique<Separator>(SourceCodeReference(currLine, currPos), SeparatorType::SemiColon);
-        ++currPos;
+        res = make_unique<Separator>(refToCurrentPosition(), SeparatorType::SemiColon);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == '(') {
-        res = make_unique<Separator>(SourceCodeReference(currLine, currPos), SeparatorType::OpenPar);
-        ++currPos;
+        res = make_unique<Separator>(refToCurrentPosition(), SeparatorType::OpenPar);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == ')') {
-        res = make_unique<Separator>(SourceCodeReference(currLine, currPos), SeparatorType::ClosePar);
-        ++currPos;
+        res = make_unique<Separator>(refToCurrentPosition(), SeparatorType::ClosePar);
         ++currAbsPos;
         return res;
     }
     // Check for Arithmetic operator tokens
     else if (*currAbsPos == '+') {
-        res = make_unique<ArithmeticOperator>(SourceCodeReference(currLine, currPos), ArithmeticType::Plus);
-        ++currPos;
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Plus);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == '-') {
-        res = make_unique<ArithmeticOperator>(SourceCodeReference(currLine, currPos), ArithmeticType::Minus);
-        ++currPos;
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Minus);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == '*') {
-        res = make_unique<ArithmeticOperator>(SourceCodeReference(currLine, currPos), ArithmeticType::Mul);
-        ++currPos;
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Mul);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == '/') {
-        res = make_unique<ArithmeticOperator>(SourceCodeReference(currLine, currPos), ArithmeticType::Div);
-        ++currPos;
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Div);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == '=') {
-        res = make_unique<ArithmeticOperator>(SourceCodeReference(currLine, currPos), ArithmeticType::Assign);
-        ++currPos;
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Assign);
+        ++currAbsPos;
+        return res;
+    } else if (*currAbsPos == '<') {
+        // '<', '<=' or '<>'
+        if (currAbsPos + 1 < code.end() && (*(currAbsPos + 1) == '=' || *(currAbsPos + 1) == '>')) {
+            res = make_unique<ArithmeticOperator>(SourceCodeReference(currentOffset(), 2), *(currAbsPos + 1) == '=' ? ArithmeticType::LessEqual : ArithmeticType::NotEqual);
+            currAbsPos += 2;
+            return res;
+        }
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Less);
+        ++currAbsPos;
+        return res;
+    } else if (*currAbsPos == '>') {
+        // '>' or '>='
+        if (currAbsPos + 1 < code.end() && *(currAbsPos + 1) == '=') {
+            res = make_unique<ArithmeticOperator>(SourceCodeReference(currentOffset(), 2), ArithmeticType::GreaterEqual);
+            currAbsPos += 2;
+            return res;
+        }
+        res = make_unique<ArithmeticOperator>(refToCurrentPosition(), ArithmeticType::Greater);
         ++currAbsPos;
         return res;
     } else if (*currAbsPos == ':') {
         if (currAbsPos + 1 < code.end() && *(currAbsPos + 1) == '=') {
-            res = make_unique<ArithmeticOperator>(SourceCodeReference(currLine, currPos, 2), ArithmeticType::VarAssign);
-            currPos += 2;
+            res = make_unique<ArithmeticOperator>(SourceCodeReference(currentOffset(), 2), ArithmeticType::VarAssign);
             currAbsPos += 2;
             return res;
         } else {
-            manager.printErrorMessage("expected '=' after ':'", SourceCodeReference(currLine, currPos, 2));
+            manager.printErrorMessage("expected '=' after ':'", SourceCodeReference(currentOffset(), 2));
             return nullptr;
         }
     }
 
-    manager.printErrorMessage("Unrecognized Character", SourceCodeReference{currLine, currPos});
+    manager.printErrorMessage("Unrecognized Character", refToCurrentPosition());
 
     return nullptr;
 }
 
 void Lexer::skipWhitespaces() {
 
-    while (currAbsPos != code.end() && isspace(*currAbsPos)) {
-        if (*currAbsPos == '\n') {
-            currPos = 1;
-            ++currLine;
-        } else
-            ++currPos;
-
+    while (currAbsPos != code.end() && isspace(*currAbsPos))
         ++currAbsPos;
-    }
 }
 bool Lexer::checkForEndOfFile() {
 
@@ -3,7 +3,10 @@
 
 #include <cctype>
 #include <memory>
+#include <optional>
+#include <string_view>
 
+#include "IdentifierTable.h"
 #include "Token.h"
 #include "pljit/CodeManagement/SourceCodeManager.h"
 
@@ -19,25 +22,35 @@ class Lexer {
         currAbsPos = code.begin();
     }
 
+    // checkSourceSize          Returns true, if the source code can be represented by source code references. Otherwise, prints an error and returns false.
+    //                          Must be checked once before the first token is taken
+    bool checkSourceSize() const;
+
     // nextToken                Continues to scan the source code, creates and returns the next token
     std::unique_ptr<Token> nextToken();
 
     // checkForEndOfFile        Skips all whitespaces starting from the current position. If then the end of the file is reached, returns true. Otherwise returns false
     bool checkForEndOfFile();
 
-    SourceCodeReference refToCurrentPosition() const { return SourceCodeReference{currLine, currPos};}
+    SourceCodeReference refToCurrentPosition() const { return SourceCodeReference{currentOffset()};}
+
+    // lookupKeyword            Returns the keyword type if the given word is a keyword, otherwise nullopt. Uses a perfect hash over the length, the first and the last character of the word
+    static std::optional<Keyword::KeywordType> lookupKeyword(std::string_view word);
+
+    // getIdentifierTable       Returns the table of the identifier names that have been interned so far
+    const IdentifierTable& getIdentifierTable() const { return identifiers; }
 
     private:
     std::string_view code;              // A reference to the source code string
-    size_t currLine{1};                 // The current line, where the lexer stands
-    size_t currPos{1};                  // The current position within the current line, where the lexer stands
     decltype(code.begin()) currAbsPos;  // An iterator, pointing to the current positon in the source code, where the lexer stands
 
     const SourceCodeManager& manager;   // A reference to the source code manager
+    IdentifierTable identifiers{};      // Assigns the ids to the names of the identifier tokens
 
 
     // Helper methods
     void skipWhitespaces();
+    size_t currentOffset() const { return static_cast<size_t>(currAbsPos - code.begin()); }
 };
 
 } // namespace jit
@@ -20,6 +20,20 @@ string Keyword::toString(jit::Keyword::KeywordType t) {
             return "RETURN";
         case KeywordType::Constant:
             return "CONST";
+        case KeywordType::Call:
+            return "CALL";
+        case KeywordType::If:
+            return "IF";
+        case KeywordType::Then:
+            return "THEN";
+        case KeywordType::Else:
+            return "ELSE";
+        case KeywordType::Min:
+            return "MIN";
+        case KeywordType::Max:
+            return "MAX";
+        case KeywordType::Abs:
+            return "ABS";
         default:
             exit(EXIT_FAILURE);
     }
@@ -41,6 +55,16 @@ string ArithmeticOperator::toString(ArithmeticOperator::ArithmeticType t) {
             return "*";
         case ArithmeticType::Div:
             return "/";
+        case ArithmeticType::Less:
+            return "<";
+        case ArithmeticType::LessEqual:
+            return "<=";
+        case ArithmeticType::Greater:
+            return ">";
+        case ArithmeticType::GreaterEqual:
+            return ">=";
+        case ArithmeticType::NotEqual:
+            return "<>";
         default:
             exit(EXIT_FAILURE);
     }
@@ -44,7 +44,14 @@ class Keyword : public Token {
         Constant,
         Ret,
         Begin,
-        End
+        End,
+        Call,
+        If,
+        Then,
+        Else,
+        Min,
+        Max,
+        Abs
     };
 
     // Constructor
@@ -62,7 +69,9 @@ class Identifier : public Token {
     public:
 
     // Constructor
-    explicit Identifier(SourceCodeReference loc) : Token{loc, TokenType::Identifier} {}
+    Identifier(SourceCodeReference loc, size_t id) : Token{loc, TokenType::Identifier}, id{id} {}
+
+    const size_t id;                // The interned id of the name of the identifier (see IdentifierTable)
 };
 
 // Literal              Token class that represents literal values (64-bit integers)
@@ -76,7 +85,7 @@ class Literal : public Token {
     const int64_t value;            // Contains the integer value of the literal
 };
 
-// ArithmeticOperator   Token class that represents the operators +, -, *, /, = and :=
+// ArithmeticOperator   Token class that represents the operators +, -, *, /, = and := as well as the comparison operators <, <=, >, >= and <>
 class ArithmeticOperator : public Token {
 
     public:
@@ -86,8 +95,13 @@ class ArithmeticOperator : public Token {
         Minus,
         Mul,
         Div,
-        VarAssign,  // :=
-        Assign      // =
+        VarAssign,      // :=
+        Assign,         // = (also the equality comparison in conditions)
+        Less,           // <
+        LessEqual,      // <=
+        Greater,        // >
+        GreaterEqual,   // >=
+        NotEqual        // <>
     };
 
     // Constructor
@@ -4,6 +4,27 @@ using namespace std;
 
 namespace jit {
 
+NonTerminalTreeNode::~NonTerminalTreeNode() {
+
+    // Detach all non terminal descendants and destroy them one after the other. When a node is destroyed here, its children have already been moved out,
+    // so the destructor calls do not nest
+    vector<unique_ptr<ParseTreeNode>> pending{};
+
+    for (auto& n : nodes)
+        if (n && isNonTerminal(*n))
+            pending.push_back(move(n));
+
+    while (!pending.empty()) {
+
+        unique_ptr<ParseTreeNode> n = move(pending.back());
+        pending.pop_back();
+
+        for (auto& child : static_cast<NonTerminalTreeNode&>(*n).nodes)
+            if (child && isNonTerminal(*child))
+                pending.push_back(move(child));
+    }
+}
+
 const ParamDeclNode* FuncDeclNode::getParameterDeclarations() const {
 
     return hasParamDecl ?  static_cast<ParamDeclNode*>(nodes[0].get()) : nullptr;
@@ -57,6 +57,12 @@ class NonTerminalTreeNode : public ParseTreeNode {
     public:
     NonTerminalTreeNode(SourceCodeReference location, Type nodetype, std::vector<std::unique_ptr<ParseTreeNode>> nodes) : ParseTreeNode{location, nodetype}, nodes{std::move(nodes)} {}
 
+    // Destructor           Destroys the subtree iteratively, so that deep trees (e.g. long expressions) do not exhaust the call stack
+    ~NonTerminalTreeNode() override;
+
+    // isNonTerminal        Returns whether the given node is a non terminal node
+    static bool isNonTerminal(const ParseTreeNode& node) { return node.nodetype != Type::Identifier && node.nodetype != Type::Literal && node.nodetype != Type::GenericTerminal; }
+
     std::vector<std::unique_ptr<ParseTreeNode>> nodes{};
 };
 
@@ -67,10 +73,12 @@ class IdentifierNode : public ParseTreeNode {
     public:
 
     // Constructor
-    explicit IdentifierNode(SourceCodeReference location) : ParseTreeNode{location, ParseTreeNode::Type::Identifier} {}
+    IdentifierNode(SourceCodeReference location, size_t id) : ParseTreeNode{location, ParseTreeNode::Type::Identifier}, id{id} {}
 
     // accept               accept method for the visitor pattern
     void accept(ParseTreeVisitor& visitor) const override { visitor.visit(*this);}
+
+    const size_t id;            // The interned id of the name of the identifier
 };
 
 // Class to represent literal nodes
@@ -98,6 +106,15 @@ class GenericTerminalNode : public ParseTreeNode {
         Minus,
         Mul,
         Div,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual,
+        Min,
+        Max,
+        Abs,
         Other
     };
 
@@ -118,7 +135,10 @@ class PrimaryExprNode : public NonTerminalTreeNode {
     enum class SubType {
         Identifier,
         Literal,
-        AdditiveExpr
+        AdditiveExpr,
+        Call,           // CALL identifier ( additive-expr, ... ): the arguments are the additive expressions at the indices 3, 5, ...
+        Intrinsic,      // (MIN | MAX | ABS) ( additive-expr, ... ): the arguments are the additive expressions at the indices 2, 4, ...
+        Conditional     // IF additive-expr comparison additive-expr THEN additive-expr ELSE additive-expr: the operands are at the indices 1, 3, 5 and 7
     };
 
     // Constructor
@@ -10,6 +10,39 @@ using SeparatorType = Separator::SeparatorType;
 using ArithmeticType = ArithmeticOperator::ArithmeticType;
 using KeywordType = Keyword::KeywordType;
 
+namespace {
+
+// genericTypeOf            Returns the subtype of the parse tree node representing the given operator ('=' is the equality comparison in conditions)
+GenericTerminalNode::SubType genericTypeOf(ArithmeticType t) {
+
+    switch(t) {
+        case ArithmeticType::Plus:
+            return GenericTerminalNode::SubType::Plus;
+        case ArithmeticType::Minus:
+            return GenericTerminalNode::SubType::Minus;
+        case ArithmeticType::Mul:
+            return GenericTerminalNode::SubType::Mul;
+        case ArithmeticType::Div:
+            return GenericTerminalNode::SubType::Div;
+        case ArithmeticType::Less:
+            return GenericTerminalNode::SubType::Less;
+        case ArithmeticType::LessEqual:
+            return GenericTerminalNode::SubType::LessEqual;
+        case ArithmeticType::Greater:
+            return GenericTerminalNode::SubType::Greater;
+        case ArithmeticType::GreaterEqual:
+            return GenericTerminalNode::SubType::GreaterEqual;
+        case ArithmeticType::Assign:
+            return GenericTerminalNode::SubType::Equal;
+        case ArithmeticType::NotEqual:
+            return GenericTerminalNode::SubType::NotEqual;
+        default:
+            return GenericTerminalNode::SubType::Other;
+    }
+}
+
+} // namespace
+
 
 unique_ptr<GenericTerminalNode> Parser::parseSeparator(SeparatorType t, bool mandatory) {
 
@@ -50,7 +83,17 @@ unique_ptr<GenericTerminalNode> Parser::parseKeyword(KeywordType t, bool mandato
         return nullptr;
     }
 
-    return make_unique<GenericTerminalNode>(currToken->location, GenericTerminalNode::SubType::Other);
+    // The keywords of the intrinsics are distinguished by their subtype, all other keywords are only checked for their presence
+    GenericTerminalNode::SubType generictype{GenericTerminalNode::SubType::Other};
+
+    if (t == KeywordType::Min)
+        generictype = GenericTerminalNode::SubType::Min;
+    else if (t == KeywordType::Max)
+        generictype = GenericTerminalNode::SubType::Max;
+    else if (t == KeywordType::Abs)
+        generictype = GenericTerminalNode::SubType::Abs;
+
+    return make_unique<GenericTerminalNode>(currToken->location, generictype);
 }
 
 unique_ptr<GenericTerminalNode> Parser::parseArithmeticOperator(ArithmeticType t, bool mandatory)
@@ -71,23 +114,30 @@ unique_ptr<GenericTerminalNode> Parser::parseArithmeticOperator(ArithmeticType t
         return nullptr;
     }
 
-    GenericTerminalNode::SubType generictype{};
+    return make_unique<GenericTerminalNode>(currToken->location, genericTypeOf(t));
+}
 
-    switch(t) {
-        case ArithmeticType::Plus:
-            generictype = GenericTerminalNode::SubType::Plus;
-            break;
-        case ArithmeticType::Minus:
-            generictype = GenericTerminalNode::SubType::Minus;
-            break;
-        case ArithmeticType::Mul:
-            generictype = GenericTerminalNode::SubType::Mul;
-            break;
-        case ArithmeticType::Div:
-            generictype = GenericTerminalNode::SubType::Div;
-            break;
-        default:
-            generictype = GenericTerminalNode::SubType::Other;
+unique_ptr<GenericTerminalNode> Parser::parseComparisonOperator(bool mandatory) {
+
+    auto currToken = nextToken();
+
+    if (!currToken)
+        return nullptr;
+
+    GenericTerminalNode::SubType generictype{GenericTerminalNode::SubType::Other};
+
+    if (currToken->tokentype == Token::TokenType::ArithmeticOperator)
+        generictype = genericTypeOf(static_cast<ArithmeticOperator*>(currToken.get())->arithmetictype);
+
+    if (generictype < GenericTerminalNode::SubType::Less || generictype > GenericTerminalNode::SubType::NotEqual) {
+
+        if (mandatory)
+            manager.printErrorMessage("error: comparison operator expected", currToken->location);
+
+        // Move falsely read token back to the lookahead place
+        lookaheadToken = move(currToken);
+
+        return nullptr;
     }
 
     return make_unique<GenericTerminalNode>(currToken->location, generictype);
@@ -101,7 +151,7 @@ unique_ptr<IdentifierNode> Parser::parseIdentifier(bool mandatory) {
         return nullptr;
 
     if (currToken->tokentype == TokenType::Identifier)
-        return make_unique<IdentifierNode>(currToken->location);
+        return make_unique<IdentifierNode>(currToken->location, static_cast<Identifier*>(currToken.get())->id);
     else {
         if (mandatory)
             manager.printErrorMessage("error: identifier expected", currToken->location);
@@ -132,8 +182,13 @@ unique_ptr<LiteralNode> Parser::parseLiteral(bool mandatory) {
 
 }
 
-unique_ptr<PrimaryExprNode> Parser::parsePrimaryExpr(bool mandatory) {
+SourceCodeReference Parser::makeReference(const ParseTreeNode& front, const ParseTreeNode& back) const {
+
+    size_t range = manager.getabsolutePosition(back.location) + back.location.range - manager.getabsolutePosition(front.location);
+    return SourceCodeReference{front.location, range};
+}
 
+unique_ptr<PrimaryExprNode> Parser::parseAtomicPrimaryExpr(bool& failed) {
 
     // vector of child nodes
     vector<unique_ptr<ParseTreeNode>> nodes{};
@@ -151,167 +206,338 @@ unique_ptr<PrimaryExprNode> Parser::parsePrimaryExpr(bool mandatory) {
         return make_unique<PrimaryExprNode>(nodes[0]->location, move(nodes), PrimaryExprNode::SubType::Literal);
     }
 
+    // Check for -> "CALL" identifier "(" [additive-expr {"," additive-expr}] ")" alternative
+    if ((n = parseKeyword(KeywordType::Call, false))) {
 
-    // Check for -> "("  additive-expr  ")" alternative
+        auto call = parseCall(move(n));
+        failed = !call;
+        return call;
+    }
 
-    // Check for '('
-    if((n = parseSeparator(SeparatorType::OpenPar, false))) {
+    // Check for -> ("MIN" | "MAX" | "ABS") "(" [additive-expr {"," additive-expr}] ")" alternative
+    if ((n = parseKeyword(KeywordType::Min, false)) || (n = parseKeyword(KeywordType::Max, false)) || (n = parseKeyword(KeywordType::Abs, false))) {
 
-         // Push "(" to the child nodes
-        nodes.push_back(move(n));
+        auto intrinsic = parseIntrinsic(move(n));
+        failed = !intrinsic;
+        return intrinsic;
+    }
 
-        // Parse the additive expression (mandatory expression because of the open '(' )
-        if (!(n = parseAdditiveExpr(true)))
-            return nullptr;
+    // Check for -> "IF" additive-expr comparison-op additive-expr "THEN" additive-expr "ELSE" additive-expr alternative
+    if ((n = parseKeyword(KeywordType::If, false))) {
 
-        // Push the additive expression to the child nodes
-       nodes.push_back(move(n));
+        auto conditional = parseConditional(move(n));
+        failed = !conditional;
+        return conditional;
+    }
 
-        // Check for ")"
-        n = parseSeparator(SeparatorType::ClosePar, true);
+    return nullptr;
+}
 
-        if (n) {
-            size_t range = manager.getabsolutePosition(n->location) + 1 - manager.getabsolutePosition(nodes.front()->location);
-            SourceCodeReference ref{nodes.front()->location, range};
+unique_ptr<PrimaryExprNode> Parser::parseCall(unique_ptr<ParseTreeNode> keyword) {
 
-            // Push the ')' to the child nodes
-            nodes.push_back(move(n));
+    // vector of child nodes
+    vector<unique_ptr<ParseTreeNode>> nodes{};
+    nodes.push_back(move(keyword));
 
-            return make_unique<PrimaryExprNode>(ref, move(nodes), PrimaryExprNode::SubType::AdditiveExpr);
+    unique_ptr<ParseTreeNode> n;
 
-        }
-        else {
-            manager.printErrorMessage("... to match this '('", nodes[0]->location);
-            return nullptr;
-        }
-    }
-    else { // No primary expression could be parsed
+    // Check for the name of the called function
+    if (!(n = parseIdentifier(true)))
+        return nullptr;
 
-        if (mandatory)
-            manager.printErrorMessage("error: Unexpected Token", (lookaheadToken ? lookaheadToken->location : lex.refToCurrentPosition()));
+    nodes.push_back(move(n));
 
+    if (!parseArguments(nodes))
         return nullptr;
-    }
+
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
+
+    return make_unique<PrimaryExprNode>(ref, move(nodes), PrimaryExprNode::SubType::Call);
 }
 
+unique_ptr<PrimaryExprNode> Parser::parseIntrinsic(unique_ptr<ParseTreeNode> keyword) {
 
-unique_ptr<AdditiveExprNode> Parser::parseAdditiveExpr(bool mandatory) {
+    // vector of child nodes
+    vector<unique_ptr<ParseTreeNode>> nodes{};
+    nodes.push_back(move(keyword));
 
+    // The number of arguments is checked by the semantic analysis
+    if (!parseArguments(nodes))
+        return nullptr;
 
-    AdditiveExprNode::SubType subtype {AdditiveExprNode::SubType::Unary};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
-    // Vector for child nodes
-    vector<unique_ptr<ParseTreeNode>> nodes{};
+    return make_unique<PrimaryExprNode>(ref, move(nodes), PrimaryExprNode::SubType::Intrinsic);
+}
+
+bool Parser::parseArguments(vector<unique_ptr<ParseTreeNode>>& nodes) {
+
+    if (nofOpenCalls >= maxNestingDepth) {
+        manager.printErrorMessage("error: Calls are nested too deeply (at most " + to_string(maxNestingDepth) + " nested calls are allowed)", nodes.front()->location);
+        return false;
+    }
 
     unique_ptr<ParseTreeNode> n;
 
-    // Parse multiplicative expression
-    if (!(n = parseMultExpr(mandatory)))
-        return nullptr;
+    // Check for '('
+    if (!(n = parseSeparator(SeparatorType::OpenPar, true)))
+        return false;
 
-    // Push multiplicative expression to the child nodes
     nodes.push_back(move(n));
 
-    // Check or optional (+|-) add-expr
-    if ((n = parseArithmeticOperator(ArithmeticType::Plus)) || (n = parseArithmeticOperator(ArithmeticType::Minus))) {
+    // Parse the arguments (separated by ','), a function without parameters is called without arguments
+    if (!(n = parseSeparator(SeparatorType::ClosePar, false))) {
 
-        // push the '+' or '-' to the child nodes
-        nodes.push_back(move(n));
+        ++nofOpenCalls;
+        bool valid = true;
 
-        // parse the following mandatory additive expression
-        if (!(n = parseAdditiveExpr(true)))
-            return nullptr;
+        while (true) {
 
-        // push the additive expression to the child vector
-        nodes.push_back(move(n));
+            if (!(n = parseAdditiveExpr(true))) {
+                valid = false;
+                break;
+            }
+
+            nodes.push_back(move(n));
+
+            if (!(n = parseSeparator(SeparatorType::Comma, false)))
+                break;
+
+            nodes.push_back(move(n));
+        }
+
+        --nofOpenCalls;
 
-        // the additive expression is binary (... (+|-) ...)
-        subtype = AdditiveExprNode::SubType::Binary;
+        if (!valid)
+            return false;
+
+        // Check for ')'
+        if (!(n = parseSeparator(SeparatorType::ClosePar, true)))
+            return false;
     }
 
-    // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    nodes.push_back(move(n));
 
-    return make_unique<AdditiveExprNode>(ref, move(nodes), subtype) ;
+    return true;
 }
 
+unique_ptr<PrimaryExprNode> Parser::parseConditional(unique_ptr<ParseTreeNode> keyword) {
 
-unique_ptr<MultExprNode> Parser::parseMultExpr(bool mandatory) {
+    if (nofOpenCalls >= maxNestingDepth) {
+        manager.printErrorMessage("error: Conditional expressions are nested too deeply (at most " + to_string(maxNestingDepth) + " nested expressions are allowed)",
+                                  keyword->location);
+        return nullptr;
+    }
 
+    // vector of child nodes
+    vector<unique_ptr<ParseTreeNode>> nodes{};
+    nodes.push_back(move(keyword));
 
-    MultExprNode::SubType subtype {MultExprNode::SubType::Unary};
+    // Appends the given node and returns true, if it has been parsed
+    auto append = [&nodes](unique_ptr<ParseTreeNode> node) {
+        if (!node)
+            return false;
+        nodes.push_back(move(node));
+        return true;
+    };
 
-    // Vector for child nodes
-    vector<unique_ptr<ParseTreeNode>> nodes{};
+    ++nofOpenCalls;
 
-    unique_ptr<ParseTreeNode> n;
+    // The parts are parsed in order, the first missing part stops the parsing
+    bool valid = append(parseAdditiveExpr(true)) && append(parseComparisonOperator(true)) && append(parseAdditiveExpr(true)) &&
+                 append(parseKeyword(KeywordType::Then, true)) && append(parseAdditiveExpr(true)) &&
+                 append(parseKeyword(KeywordType::Else, true)) && append(parseAdditiveExpr(true));
 
-    // Parse unary expression
-    if (!(n = parseUnaryExpr(mandatory)))
-        return nullptr;
+    --nofOpenCalls;
 
-    nodes.push_back(move(n));
+    if (!valid)
+        return nullptr;
 
-    // Check for optional (*|/) mult-expr
-    if((n = parseArithmeticOperator(ArithmeticType::Mul)) || (n = parseArithmeticOperator(ArithmeticType::Div))) {
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
-        // push the '*' or '/' to the child vector
-        nodes.push_back(move(n));
+    return make_unique<PrimaryExprNode>(ref, move(nodes), PrimaryExprNode::SubType::Conditional);
+}
 
-        if (!(n = parseMultExpr(true)))
-            return nullptr;
+unique_ptr<UnaryExprNode> Parser::buildUnaryExpr(unique_ptr<ParseTreeNode> sign, unique_ptr<ParseTreeNode> primary) const {
 
-        // push the multiplicative expression to the child vector
-        nodes.push_back(move(n));
+    vector<unique_ptr<ParseTreeNode>> nodes{};
 
-        // the multiplicative expression is binary (... (*|/) ...)
-        subtype = MultExprNode::SubType::Binary;
+    UnaryExprNode::SubType subtype{UnaryExprNode::SubType::NoSign};
 
+    if (sign) {
+        subtype = static_cast<GenericTerminalNode&>(*sign).subtype == GenericTerminalNode::SubType::Plus ? UnaryExprNode::SubType::Plus : UnaryExprNode::SubType::Minus;
+        nodes.push_back(move(sign));
     }
 
-    // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    nodes.push_back(move(primary));
 
-    return make_unique<MultExprNode>(ref, move(nodes), subtype);
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
+
+    return make_unique<UnaryExprNode>(ref, move(nodes), subtype);
 }
 
-unique_ptr<UnaryExprNode> Parser::parseUnaryExpr(bool mandatory) {
+unique_ptr<MultExprNode> Parser::buildMultExpr(vector<unique_ptr<ParseTreeNode>> items) const {
 
+    // The items alternate between unary expressions and the operators '*' resp. '/' ( u0 op0 u1 op1 ... uk ). As the grammar is right recursive, the tree is built
+    // from the right:  mult-expr(u0 op0 mult-expr(u1 op1 ... mult-expr(uk)))
     vector<unique_ptr<ParseTreeNode>> nodes{};
+    nodes.push_back(move(items.back()));
 
-    UnaryExprNode::SubType subtype{UnaryExprNode::SubType::NoSign};
+    SourceCodeReference lastref = nodes.back()->location;
+    auto result = make_unique<MultExprNode>(lastref, move(nodes), MultExprNode::SubType::Unary);
 
-    // Check for optional + and -
-    unique_ptr<ParseTreeNode> n;
+    for (size_t i = items.size() - 1; i >= 2; i -= 2) {
 
-    if ((n = parseArithmeticOperator(ArithmeticType ::Plus, false))) {
-        subtype = UnaryExprNode::SubType::Plus;
-        nodes.push_back(move(n));
+        nodes = vector<unique_ptr<ParseTreeNode>>{};
+        nodes.push_back(move(items[i - 2]));
+        nodes.push_back(move(items[i - 1]));
+        nodes.push_back(move(result));
+
+        SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
+        result = make_unique<MultExprNode>(ref, move(nodes), MultExprNode::SubType::Binary);
     }
-    else if((n = parseArithmeticOperator(ArithmeticType::Minus, false))) {
-        subtype = UnaryExprNode::SubType::Minus;
-        nodes.push_back(move(n));
+
+    return result;
+}
+
+unique_ptr<AdditiveExprNode> Parser::buildAdditiveExpr(vector<unique_ptr<ParseTreeNode>> items) const {
+
+    // The items alternate between multiplicative expressions and the operators '+' resp. '-' ( m0 op0 m1 op1 ... mk ). As the grammar is right recursive, the tree is
+    // built from the right:  additive-expr(m0 op0 additive-expr(m1 op1 ... additive-expr(mk)))
+    vector<unique_ptr<ParseTreeNode>> nodes{};
+    nodes.push_back(move(items.back()));
+
+    SourceCodeReference lastref = nodes.back()->location;
+    auto result = make_unique<AdditiveExprNode>(lastref, move(nodes), AdditiveExprNode::SubType::Unary);
+
+    for (size_t i = items.size() - 1; i >= 2; i -= 2) {
+
+        nodes = vector<unique_ptr<ParseTreeNode>>{};
+        nodes.push_back(move(items[i - 2]));
+        nodes.push_back(move(items[i - 1]));
+        nodes.push_back(move(result));
+
+        SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
+        result = make_unique<AdditiveExprNode>(ref, move(nodes), AdditiveExprNode::SubType::Binary);
     }
 
+    return result;
+}
 
-    // Parse the primary expression (expression is mandatory, if +/- was parsed, otherwise it depends on mandatory flag)
-    if (subtype == UnaryExprNode::SubType::NoSign)
-        n = parsePrimaryExpr(mandatory);
-    else
-        n = parsePrimaryExpr(true);
 
-    if (!n)
-        return nullptr;
+unique_ptr<AdditiveExprNode> Parser::parseAdditiveExpr(bool mandatory) {
 
-    nodes.push_back(move(n));
+    /*
+     * The arithmetic expressions are parsed without recursion. Sequences like 'a + b + c' resp. 'a * b * c' are collected in a loop and only afterwards assembled into
+     * the (right recursive) parse tree. For every open parenthesis, a frame is pushed on an explicit stack, which stores the partially parsed expression of that level.
+     * The number of nested parentheses is limited by maxNestingDepth.
+     */
+    struct Frame {
+        unique_ptr<ParseTreeNode> openPar{};                // The '(' that opened this level (nullptr for the outermost level)
+        unique_ptr<ParseTreeNode> sign{};                   // The optional sign in front of the '(' (it belongs to the unary expression of the enclosing level)
+        vector<unique_ptr<ParseTreeNode>> terms{};          // Multiplicative expressions and '+' / '-' operators parsed so far on this level
+        vector<unique_ptr<ParseTreeNode>> factors{};        // Unary expressions and '*' / '/' operators of the current multiplicative expression
+    };
 
-    // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    vector<Frame> frames(1);
 
-    return make_unique<UnaryExprNode>(ref, move(nodes), subtype);
+    // Only the very first primary expression of the outermost level may be optional
+    bool required = mandatory;
+
+    while (true) {
+
+        // Check for optional + and -
+        unique_ptr<ParseTreeNode> sign;
+        if (!(sign = parseArithmeticOperator(ArithmeticType::Plus, false)))
+            sign = parseArithmeticOperator(ArithmeticType::Minus, false);
+
+        // Parse the primary expression (mandatory, if a sign was parsed)
+        required = required || sign;
+
+        bool failed = false;
+        unique_ptr<ParseTreeNode> primary = parseAtomicPrimaryExpr(failed);
+
+        if (failed)
+            return nullptr;
+
+        if (!primary) {
+
+            // Check for -> "("  additive-expr  ")" alternative
+            unique_ptr<ParseTreeNode> openPar = parseSeparator(SeparatorType::OpenPar, false);
+
+            if (!openPar) { // No primary expression could be parsed
+
+                if (required)
+                    manager.printErrorMessage("error: Unexpected Token", (lookaheadToken ? lookaheadToken->location : lex.refToCurrentPosition()));
+
+                return nullptr;
+            }
+
+            if (frames.size() > maxNestingDepth) {
+                manager.printErrorMessage("error: Expression is nested too deeply (at most " + to_string(maxNestingDepth) + " nested parentheses are allowed)", openPar->location);
+                return nullptr;
+            }
+
+            // Open a new level, the additive expression within the parentheses is mandatory
+            frames.emplace_back();
+            frames.back().openPar = move(openPar);
+            frames.back().sign = move(sign);
+            required = true;
+            continue;
+        }
+
+        required = true;
+
+        // A complete primary expression has been parsed. Add it to the current level and close all levels that end after it
+        while (true) {
+
+            Frame& frame = frames.back();
+
+            frame.factors.push_back(buildUnaryExpr(move(sign), move(primary)));
+
+            // Check for optional (*|/) mult-expr
+            unique_ptr<ParseTreeNode> op;
+            if ((op = parseArithmeticOperator(ArithmeticType::Mul)) || (op = parseArithmeticOperator(ArithmeticType::Div))) {
+                frame.factors.push_back(move(op));
+                break;
+            }
+
+            frame.terms.push_back(buildMultExpr(move(frame.factors)));
+            frame.factors.clear();
+
+            // Check or optional (+|-) add-expr
+            if ((op = parseArithmeticOperator(ArithmeticType::Plus)) || (op = parseArithmeticOperator(ArithmeticType::Minus))) {
+                frame.terms.push_back(move(op));
+                break;
+            }
+
+            unique_ptr<AdditiveExprNode> addexpr = buildAdditiveExpr(move(frame.terms));
+
+            if (frames.size() == 1)
+                return addexpr;
+
+            // Check for ")"
+            unique_ptr<ParseTreeNode> closePar = parseSeparator(SeparatorType::ClosePar, true);
+
+            if (!closePar) {
+                manager.printErrorMessage("... to match this '('", frame.openPar->location);
+                return nullptr;
+            }
+
+            SourceCodeReference ref = makeReference(*frame.openPar, *closePar);
+
+            vector<unique_ptr<ParseTreeNode>> nodes{};
+            nodes.push_back(move(frame.openPar));
+            nodes.push_back(move(addexpr));
+            nodes.push_back(move(closePar));
+
+            // The parenthesised expression is the primary expression of the enclosing level
+            primary = make_unique<PrimaryExprNode>(ref, move(nodes), PrimaryExprNode::SubType::AdditiveExpr);
+            sign = move(frame.sign);
+
+            frames.pop_back();
+        }
+    }
 }
 
 
@@ -340,8 +566,7 @@ unique_ptr<AssignExprNode> Parser::parseAssignExpr(bool mandatory) {
     nodes.push_back(move(n));
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<AssignExprNode>(ref, move(nodes));
 
@@ -363,11 +588,19 @@ unique_ptr<Statement> Parser::parseStatement() {
         subtype = Statement::SubType::Return;
         nodes.push_back(move(n));
 
-        // Check for additive-expression
-        if(!(n = parseAdditiveExpr(true)))
-            return nullptr;
+        // Check for the additive-expressions of the returned values (separated by ',')
+        while (true) {
 
-        nodes.push_back(move(n));
+            if(!(n = parseAdditiveExpr(true)))
+                return nullptr;
+
+            nodes.push_back(move(n));
+
+            if (!(n = parseSeparator(SeparatorType::Comma, false)))
+                break;
+
+            nodes.push_back(move(n));
+        }
     }
     // Check for assignment expression
     else {
@@ -379,8 +612,7 @@ unique_ptr<Statement> Parser::parseStatement() {
     }
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<Statement>(ref, move(nodes), subtype);
 }
@@ -410,8 +642,7 @@ unique_ptr<StatementList> Parser::parseStatementList() {
     }
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<StatementList>(ref, move(nodes));
 }
@@ -443,8 +674,7 @@ unique_ptr<CompoundStatement> Parser::parseCompoundStatement() {
     nodes.push_back(move(n));
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<CompoundStatement>(ref, move(nodes));
 }
@@ -479,8 +709,7 @@ unique_ptr<InitDeclNode> Parser::parseInitDecl() {
     nodes.push_back(move(n));
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<InitDeclNode>(ref, move(nodes));
 }
@@ -511,8 +740,7 @@ unique_ptr<InitDeclListNode> Parser::parseInitDeclList() {
     }
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<InitDeclListNode>(ref, move(nodes));
 }
@@ -542,8 +770,7 @@ unique_ptr<DeclListNode> Parser::parseDeclList() {
     }
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<DeclListNode>(ref, move(nodes));
 }
@@ -576,8 +803,7 @@ optional<unique_ptr<ParamDeclNode>> Parser::parseParamDecl() {
     nodes.push_back(move(n));
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<ParamDeclNode>(ref, move(nodes));
 }
@@ -609,8 +835,7 @@ optional<unique_ptr<VarDeclNode>> Parser::parseVarDecl() {
     nodes.push_back(move(n));
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<VarDeclNode>(ref, move(nodes));
 }
@@ -642,8 +867,7 @@ optional<unique_ptr<ConstDeclNode>> Parser::parseConstDecl() {
     nodes.push_back(move(n));
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<ConstDeclNode>(ref, move(nodes));
 }
@@ -651,6 +875,9 @@ optional<unique_ptr<ConstDeclNode>> Parser::parseConstDecl() {
 
 unique_ptr<FuncDeclNode> Parser::parseFunction() {
 
+    if (!lex.checkSourceSize())
+        return nullptr;
+
     // Vector for the child nodes
     vector<unique_ptr<ParseTreeNode>> nodes{};
 
@@ -705,8 +932,7 @@ unique_ptr<FuncDeclNode> Parser::parseFunction() {
     }
 
     // Determine the range ( resp. the length) of the node in the source code and create a source code reference
-    size_t range = manager.getabsolutePosition(nodes.back()->location) + nodes.back()->location.range - manager.getabsolutePosition(nodes.front()->location);
-    SourceCodeReference ref{nodes.front()->location, range};
+    SourceCodeReference ref = makeReference(*nodes.front(), *nodes.back());
 
     return make_unique<FuncDeclNode>(ref, move(nodes), hasParam, hasVar, hasConst);
 }
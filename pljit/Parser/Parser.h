@@ -13,8 +13,11 @@ class Parser {
 
     public:
 
+    static constexpr size_t defaultMaxNestingDepth = 1000;     // Default for the maximal number of nested parentheses in an expression
+
     // Constructor
-    Parser(const std::string& sourcecode, const SourceCodeManager& manager) : manager{manager}, lex{sourcecode, manager} {}
+    Parser(const std::string& sourcecode, const SourceCodeManager& manager, size_t maxNestingDepth = defaultMaxNestingDepth) : manager{manager}, lex{sourcecode, manager},
+                                                                                                                              maxNestingDepth{maxNestingDepth} {}
 
     // parseFunction                Parses the source code and, if successfull, returns a pointer to the root node of the created parse tree
     std::unique_ptr<FuncDeclNode> parseFunction();
@@ -24,6 +27,8 @@ class Parser {
 
     const SourceCodeManager& manager;       // A reference to the source code manager
     Lexer lex;                              // The lexer that is used within the parser
+    const size_t maxNestingDepth;           // The maximal number of nested parentheses (resp. calls, intrinsics and conditional expressions) in an expression
+    size_t nofOpenCalls{0};                 // The number of calls, intrinsics and conditional expressions, whose operands are currently parsed
 
 
     // Parser methods to parse Separator-, Keyword- and ArithemticOperator token. The methods check if the next token matches the token given as parameter.
@@ -32,16 +37,43 @@ class Parser {
     std::unique_ptr<GenericTerminalNode> parseKeyword(Keyword::KeywordType t, bool mandatory = false);
     std::unique_ptr<GenericTerminalNode> parseArithmeticOperator(ArithmeticOperator::ArithmeticType t, bool mandatory = false);
 
+    // parseComparisonOperator  Parses one of the comparison operators =, <>, <, <=, > and >=
+    std::unique_ptr<GenericTerminalNode> parseComparisonOperator(bool mandatory = false);
+
     // Parser methods to parse an identifier and a literal with a flag indicating whether the token is mandatory or optional
     std::unique_ptr<IdentifierNode> parseIdentifier(bool mandatory = false);
     std::unique_ptr<LiteralNode> parseLiteral(bool mandatory = false);
 
-    // Parser methods for the arithmetic expressions with a flag indicating whether the expression is mandatory or optional
-    std::unique_ptr<PrimaryExprNode> parsePrimaryExpr(bool mandatory = false);
-    std::unique_ptr<UnaryExprNode> parseUnaryExpr(bool mandatory = false);
-    std::unique_ptr<MultExprNode> parseMultExpr(bool mandatory = false);
+    // parseAdditiveExpr        Parses an additive expression (including all of its subexpressions) with a flag indicating whether the expression is mandatory or optional.
+    //                          Works iteratively with an explicit stack, so the length of the expression is not limited by the call stack
     std::unique_ptr<AdditiveExprNode> parseAdditiveExpr(bool mandatory = false);
 
+    // parseAtomicPrimaryExpr   Parses the identifier, literal, call, intrinsic and conditional alternatives of a primary expression (the parenthesised alternative is
+    //                          handled by parseAdditiveExpr). Returns a null pointer, if none of them is found, and sets 'failed', if one has been found that is invalid
+    std::unique_ptr<PrimaryExprNode> parseAtomicPrimaryExpr(bool& failed);
+
+    // parseCall                Parses the name and the arguments of a call, after the keyword 'CALL' has been parsed
+    std::unique_ptr<PrimaryExprNode> parseCall(std::unique_ptr<ParseTreeNode> keyword);
+
+    // parseIntrinsic           Parses the arguments of an intrinsic function, after its keyword ('MIN', 'MAX' or 'ABS') has been parsed
+    std::unique_ptr<PrimaryExprNode> parseIntrinsic(std::unique_ptr<ParseTreeNode> keyword);
+
+    // parseArguments           Parses a parenthesised argument list and appends its nodes to the given nodes. The arguments are parsed by recursive calls of
+    //                          parseAdditiveExpr, so the number of nested calls is limited by maxNestingDepth
+    bool parseArguments(std::vector<std::unique_ptr<ParseTreeNode>>& nodes);
+
+    // parseConditional         Parses the comparison and the two alternatives of a conditional expression, after the keyword 'IF' has been parsed. The operands are
+    //                          parsed by recursive calls of parseAdditiveExpr like the arguments of a call. The ELSE alternative extends as far as possible
+    std::unique_ptr<PrimaryExprNode> parseConditional(std::unique_ptr<ParseTreeNode> keyword);
+
+    // Methods to assemble the parse tree nodes of the arithmetic expressions from already parsed parts
+    std::unique_ptr<UnaryExprNode> buildUnaryExpr(std::unique_ptr<ParseTreeNode> sign, std::unique_ptr<ParseTreeNode> primary) const;
+    std::unique_ptr<MultExprNode> buildMultExpr(std::vector<std::unique_ptr<ParseTreeNode>> items) const;
+    std::unique_ptr<AdditiveExprNode> buildAdditiveExpr(std::vector<std::unique_ptr<ParseTreeNode>> items) const;
+
+    // makeReference            Returns a source code reference spanning from the start of the front node to the end of the back node
+    SourceCodeReference makeReference(const ParseTreeNode& front, const ParseTreeNode& back) const;
+
     // parseAssignExpr          Parses an assignment expression with a flag indicating whether the expression is mandatory or optional
     std::unique_ptr<AssignExprNode> parseAssignExpr(bool mandatory = false);
 
@@ -1,10 +1,11 @@
 #include "FunctionObject.h"
+#include "pljit/IR/IrFunction.h"
 #include "pljit/SemanticAnalysis/AstNode.h"
 
 namespace jit {
 
 
-FunctionObject::FunctionObject(std::string code) : sourceCode(std::move(code)), manager{sourceCode} {
+FunctionObject::FunctionObject(std::string code, std::vector<std::pair<size_t, int64_t>> bindings) : sourceCode(std::move(code)), bindings{std::move(bindings)}, manager{sourceCode} {
 
 }
 
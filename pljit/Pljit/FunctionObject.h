@@ -3,28 +3,61 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "pljit/CodeManagement/SourceCodeManager.h"
+#include "pljit/Pljit/MemoCache.h"
+#include "pljit/Pljit/PassManager.h"
 
 
 namespace jit {
 
 
 class AstFunction;
+class IrFunction;
 
 // FunctionObject           Wraps all data (source code, source code manager, AstFunction object ...) for a registered function
 struct FunctionObject {
 
-    // Constructor
-    explicit FunctionObject(std::string code);
+    // Constructor              The given bindings fix the values of parameters (pairs of parameter index and value, see Pljit::specialize)
+    explicit FunctionObject(std::string code, std::vector<std::pair<size_t, int64_t>> bindings = {});
 
     const std::string sourceCode;                       // Source code
+    const std::vector<std::pair<size_t, int64_t>> bindings;     // Parameters bound to values, the function only takes the remaining parameters
     const SourceCodeManager manager;                    // Source Code Manager
     std::atomic<unsigned char> compileStatus{0};        // 0 --> Function not yet compiled  1 --> Function currently gets compiled by one thread   2 --> Compiling finished
     std::unique_ptr<AstFunction> function{nullptr};     // Pointer to the Ast-Function object
+    std::unique_ptr<IrFunction> ir{nullptr};            // Pointer to the intermediate representation of the function, which is used to execute it
+    std::vector<PassStatistics> statistics{};           // The statistics of the optimisation passes run to compile the function
+    std::optional<int64_t> constant{};                  // The result of the function, if it is the same for all arguments and cannot fail (see Pljit::isConstant)
+    const FunctionObject* waitsFor{nullptr};            // The called function, whose compilation the compilation of this function currently waits for (see Pljit::resolveCall)
+
+    // Pipeline (see Pljit::compose)
+    std::vector<FunctionObject*> stages{};                      // The functions of the pipeline in order (empty, if the function is not composed)
+    std::vector<size_t> wiring{};                               // For every stage but the first, the parameter that receives the result of the previous stage
+
+    // Value profile (see Pljit::profile)
+    std::mutex profileMutex{};                                  // Protects the samples while the profile is recorded
+    std::vector<std::vector<int64_t>> samples{};                // The arguments of the sampled calls
+    std::atomic<bool> profiled{false};                          // Set, when the profile has been evaluated. Afterwards, the guards and the guarded function do not change anymore
+    std::vector<std::pair<size_t, int64_t>> guards{};           // The parameters (sorted indices) and values the guarded function is specialised on
+    std::unique_ptr<IrFunction> guarded{nullptr};               // The function specialised on the guards, it takes the remaining parameters
+
+    // Result cache (see Pljit::memoise)
+    std::atomic<MemoCache*> memo{nullptr};                      // The cache of the results, if the function is memoised
+    std::unique_ptr<MemoCache> memoStorage{nullptr};            // Owns the cache, set once by the thread that enabled it
 };
 
 
+// FusedProgram             A group of functions compiled into a single function, which computes all of their results at once (see Pljit::evaluateMany)
+struct FusedProgram {
+    std::unique_ptr<IrFunction> ir{nullptr};                    // The fused function, it takes the arguments shared by all functions (null, if no function could be fused)
+    std::vector<std::optional<size_t>> outputs{};               // For every function of the group, the index of its result in the fused function (nullopt, if it is called on its own)
+};
+
 } // namespace jit
 
 #endif //PLJIT_FUNCTIONOBJECT_H
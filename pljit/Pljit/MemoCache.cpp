@@ -0,0 +1,121 @@
+#include "MemoCache.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace jit {
+
+MemoCache::MemoCache(MemoConfig config) : config{config},
+                                          nofshards{max<size_t>(1, config.shards)},
+                                          shardCapacity{max<size_t>(1, (config.capacity + nofshards - 1) / nofshards)},
+                                          shards{make_unique<Shard[]>(nofshards)} {}
+
+size_t MemoCache::ArgumentHash::operator()(const vector<int64_t>& args) const {
+
+    // Mix every argument into the hash (the finaliser of splitmix64), so that tuples differing in a single argument do not collide
+    uint64_t h = args.size();
+
+    for (int64_t arg : args) {
+
+        uint64_t x = h ^ static_cast<uint64_t>(arg);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        h = x ^ (x >> 31);
+    }
+
+    return static_cast<size_t>(h);
+}
+
+MemoCache::Shard& MemoCache::shardOf(const vector<int64_t>& args) {
+
+    // The low bits of the hash select the bucket within the shard, so the shard is selected by the high bits
+    return shards[(ArgumentHash{}(args) >> 32) % nofshards];
+}
+
+optional<int64_t> MemoCache::lookup(const vector<int64_t>& args) {
+
+    if (!isEnabled())
+        return nullopt;
+
+    Shard& shard = shardOf(args);
+    optional<int64_t> result{};
+
+    {
+        lock_guard<mutex> lock{shard.mutex};
+
+        auto it = shard.results.find(args);
+
+        if (it != shard.results.end()) {
+
+            result = it->second.first;
+
+            if (config.eviction == EvictionPolicy::LeastRecentlyUsed)
+                shard.order.splice(shard.order.end(), shard.order, it->second.second);
+        }
+    }
+
+    if (result) {
+        size_t lookups = hits.fetch_add(1, memory_order_relaxed) + 1 + misses.load(memory_order_relaxed);
+        checkHitRate(lookups);
+    }
+    else {
+        size_t lookups = misses.fetch_add(1, memory_order_relaxed) + 1 + hits.load(memory_order_relaxed);
+        checkHitRate(lookups);
+    }
+
+    return result;
+}
+
+void MemoCache::insert(vector<int64_t> args, int64_t result) {
+
+    if (!isEnabled())
+        return;
+
+    Shard& shard = shardOf(args);
+    lock_guard<mutex> lock{shard.mutex};
+
+    auto [it, inserted] = shard.results.emplace(move(args), pair<int64_t, list<const vector<int64_t>*>::iterator>{result, {}});
+
+    // Another call has already inserted the result
+    if (!inserted)
+        return;
+
+    it->second.second = shard.order.insert(shard.order.end(), &it->first);
+
+    if (shard.results.size() > shardCapacity) {
+
+        // Erase by iterator, the key the list points to belongs to the erased node (the map's iterators cannot be kept in the list, a rehash invalidates them)
+        auto victim = shard.results.find(*shard.order.front());
+        shard.order.pop_front();
+        shard.results.erase(victim);
+        evictions.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+void MemoCache::checkHitRate(size_t lookups) {
+
+    if (config.checkInterval == 0 || lookups % config.checkInterval != 0)
+        return;
+
+    if (hits.load(memory_order_relaxed) * 100 >= lookups * config.minHitRate)
+        return;
+
+    if (!enabled.exchange(false))
+        return;
+
+    // Release the cached results, they are not used anymore
+    for (size_t i = 0; i < nofshards; ++i) {
+
+        lock_guard<mutex> lock{shards[i].mutex};
+        shards[i].results.clear();
+        shards[i].order.clear();
+    }
+}
+
+MemoStatistics MemoCache::getStatistics() const {
+
+    return MemoStatistics{hits.load(), misses.load(), evictions.load(), enabled.load()};
+}
+
+} // namespace jit
@@ -0,0 +1,93 @@
+#ifndef PLJIT_MEMOCACHE_H
+#define PLJIT_MEMOCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace jit {
+
+// EvictionPolicy                       Selects the cached result that is removed, when a shard of a MemoCache is full
+enum class EvictionPolicy {
+    LeastRecentlyUsed,          // The result that has not been looked up for the longest time
+    FirstInFirstOut             // The result that has been inserted first (lookups do not need to reorder the results)
+};
+
+// MemoConfig                           The configuration of a MemoCache
+struct MemoConfig {
+    size_t capacity{4096};                                      // The maximal number of cached results
+    size_t shards{16};                                          // The number of independently locked parts of the cache
+    EvictionPolicy eviction{EvictionPolicy::LeastRecentlyUsed}; // The result removed from a full shard
+    size_t minHitRate{10};                                      // The cache is disabled, if less than this percentage of the lookups are hits
+    size_t checkInterval{1024};                                 // The hit rate is checked every time this number of lookups has been done
+};
+
+// MemoStatistics                       The lookups of a MemoCache
+struct MemoStatistics {
+    size_t hits{0};             // The number of lookups that found a result
+    size_t misses{0};           // The number of lookups that did not find a result
+    size_t evictions{0};        // The number of results removed from full shards
+    bool enabled{true};         // Specifies, whether the cache is still used (it is disabled automatically, see MemoConfig::minHitRate)
+};
+
+// MemoCache                            Caches the results of a function for argument tuples. As the functions are pure, a result never changes. The cache is split into shards,
+//                                      every shard is locked on its own, so that concurrent calls rarely wait for each other
+class MemoCache {
+
+    public:
+
+    // Constructor
+    explicit MemoCache(MemoConfig config);
+
+    // lookup                   Returns the cached result for the given arguments, or nullopt if it is not cached
+    std::optional<int64_t> lookup(const std::vector<int64_t>& args);
+
+    // insert                   Caches the result for the given arguments, the shard of the arguments evicts a result if it is full
+    void insert(std::vector<int64_t> args, int64_t result);
+
+    // isEnabled                Returns true, if the cache is still used
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // getStatistics            Returns the lookups done so far
+    MemoStatistics getStatistics() const;
+
+    private:
+
+    // ArgumentHash             Hash function for argument tuples
+    struct ArgumentHash {
+        size_t operator()(const std::vector<int64_t>& args) const;
+    };
+
+    // Shard                    A part of the cache with its own lock
+    struct Shard {
+        std::mutex mutex{};                                                     // Protects the results of the shard
+        std::list<const std::vector<int64_t>*> order{};                         // The arguments of the cached results, the next result to be evicted last
+        std::unordered_map<std::vector<int64_t>, std::pair<int64_t, std::list<const std::vector<int64_t>*>::iterator>, ArgumentHash> results{};   // The results and their positions in 'order'
+    };
+
+    // shardOf                  Returns the shard the given arguments belong to
+    Shard& shardOf(const std::vector<int64_t>& args);
+
+    // checkHitRate             Disables the cache, if the hit rate is too low
+    void checkHitRate(size_t lookups);
+
+    const MemoConfig config;                    // The configuration
+    const size_t nofshards;                     // The number of shards (at least 1)
+    const size_t shardCapacity;                 // The maximal number of results of a shard
+    std::unique_ptr<Shard[]> shards;            // The shards
+
+    std::atomic<bool> enabled{true};            // Specifies, whether the cache is still used
+    std::atomic<size_t> hits{0};                // The number of lookups that found a result
+    std::atomic<size_t> misses{0};              // The number of lookups that did not find a result
+    std::atomic<size_t> evictions{0};           // The number of results removed from full shards
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_MEMOCACHE_H
@@ -0,0 +1,85 @@
+#include "PassManager.h"
+
+#include "pljit/SemanticAnalysis/AstNode.h"
+
+using namespace std;
+
+namespace jit {
+
+void PassManager::addPass(string name, unique_ptr<OptimisePass> pass, bool iterate) {
+
+    astpasses.push_back(Entry<OptimisePass>{move(pass), iterate, PassStatistics{move(name)}});
+}
+
+void PassManager::addPass(string name, unique_ptr<IrOptimisePass> pass, bool iterate) {
+
+    irpasses.push_back(Entry<IrOptimisePass>{move(pass), iterate, PassStatistics{move(name)}});
+}
+
+template<typename Pass, typename Function, typename F>
+void PassManager::runPipeline(vector<Entry<Pass>>& passes, Function& function, F runPass) {
+
+    size_t begin = 0;
+
+    while (begin < passes.size()) {
+
+        // A pass that is not repeated forms a group on its own
+        size_t end = begin + 1;
+
+        if (passes[begin].iterate)
+            while (end < passes.size() && passes[end].iterate)
+                ++end;
+
+        size_t iterations = passes[begin].iterate ? maxIterations : 1;
+        bool changed = true;
+
+        for (size_t i = 0; i < iterations && changed; ++i) {
+
+            changed = false;
+
+            for (size_t p = begin; p < end; ++p) {
+
+                PassStatistics& statistics = passes[p].statistics;
+
+                auto start = chrono::steady_clock::now();
+                size_t changes = runPass(*passes[p].pass, function);
+                statistics.time += chrono::steady_clock::now() - start;
+
+                ++statistics.runs;
+                statistics.changes += changes;
+                changed |= changes != 0;
+            }
+        }
+
+        begin = end;
+    }
+}
+
+void PassManager::run(AstFunction& function) {
+
+    runPipeline(astpasses, function, [](OptimisePass& pass, AstFunction& f) {
+        size_t before = pass.getNofChanges();
+        f.optimise(pass);
+        return pass.getNofChanges() - before;
+    });
+}
+
+void PassManager::run(IrFunction& function) {
+
+    runPipeline(irpasses, function, [](IrOptimisePass& pass, IrFunction& f) { return pass.run(f); });
+}
+
+vector<PassStatistics> PassManager::getStatistics() const {
+
+    vector<PassStatistics> result{};
+
+    for (const auto& entry : astpasses)
+        result.push_back(entry.statistics);
+
+    for (const auto& entry : irpasses)
+        result.push_back(entry.statistics);
+
+    return result;
+}
+
+} // namespace jit
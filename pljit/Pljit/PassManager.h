@@ -0,0 +1,79 @@
+#ifndef PLJIT_PASSMANAGER_H
+#define PLJIT_PASSMANAGER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pljit/IR/IrOptimisePass.h"
+#include "pljit/SemanticAnalysis/OptimisePass.h"
+
+namespace jit {
+
+class AstFunction;
+
+// OptimisationLevel                    Selects the optimisation passes run by Pljit:
+//                                      O0  No optimisation, the function is lowered as it is written
+//                                      O1  Every cheap pass runs once (dead code, constant propagation, value numbering, strength reduction, dead values)
+//                                      O2  All passes, the ones enabling each other are repeated until they do not change the function anymore
+enum class OptimisationLevel { O0, O1, O2 };
+
+// PassStatistics                       The time spent in a pass and the changes made by it
+struct PassStatistics {
+    std::string name{};                         // The name of the pass
+    size_t runs{0};                             // The number of times the pass has been run
+    size_t changes{0};                          // The number of nodes (Ast) or instructions (IR) changed or removed by the pass
+    std::chrono::nanoseconds time{0};           // The time spent in the pass
+};
+
+// PassManager                          Runs a pipeline of optimisation passes on an Ast and on the intermediate representation. Consecutive passes that are added with
+//                                      'iterate' set form a group, which is repeated until none of its passes changes the function (or up to 'maxIterations' times)
+class PassManager {
+
+    public:
+
+    static constexpr size_t defaultMaxIterations = 8;  // Default for the maximal number of times a group of passes is repeated
+
+    // Constructor
+    explicit PassManager(size_t maxIterations = defaultMaxIterations) : maxIterations{maxIterations} {}
+
+    // addPass                  Appends a pass on the Ast to the pipeline
+    void addPass(std::string name, std::unique_ptr<OptimisePass> pass, bool iterate = false);
+
+    // addPass                  Appends a pass on the intermediate representation to the pipeline
+    void addPass(std::string name, std::unique_ptr<IrOptimisePass> pass, bool iterate = false);
+
+    // run                      Runs the passes on the Ast in order of the pipeline
+    void run(AstFunction& function);
+
+    // run                      Runs the passes on the intermediate representation in order of the pipeline
+    void run(IrFunction& function);
+
+    // getStatistics            Returns the statistics of all passes in order of the pipeline (Ast passes first)
+    std::vector<PassStatistics> getStatistics() const;
+
+    private:
+
+    // Entry                    A pass of the pipeline
+    template<typename Pass>
+    struct Entry {
+        std::unique_ptr<Pass> pass;             // The pass
+        bool iterate;                           // Specifies, whether the pass belongs to a group that is repeated
+        PassStatistics statistics;              // The statistics of the pass
+    };
+
+    // runPipeline              Runs the given passes on the given function. 'runPass' runs a single pass and returns the number of its changes
+    template<typename Pass, typename Function, typename F>
+    void runPipeline(std::vector<Entry<Pass>>& passes, Function& function, F runPass);
+
+    const size_t maxIterations;                             // The maximal number of times a group of passes is repeated
+
+    std::vector<Entry<OptimisePass>> astpasses{};           // The passes on the Ast
+    std::vector<Entry<IrOptimisePass>> irpasses{};          // The passes on the intermediate representation
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_PASSMANAGER_H
@@ -1,10 +1,25 @@
 #include "pljit/Pljit/Pljit.h"
-#include "pljit/Evaluation/EvalInstance.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include "pljit/Evaluation/IrEvalInstance.h"
+#include "pljit/IR/AlgebraicSimplifyOpt.h"
+#include "pljit/IR/DeadValueOpt.h"
+#include "pljit/IR/IrBuilder.h"
+#include "pljit/IR/PolynomialOpt.h"
+#include "pljit/IR/RangeAnalysisOpt.h"
+#include "pljit/IR/StrengthReductionOpt.h"
+#include "pljit/IR/TreeBalancingOpt.h"
+#include "pljit/IR/ValueNumberingOpt.h"
 #include "pljit/Parser/ParsePrintVisitor.h"
 #include "pljit/Parser/Parser.h"
 #include "pljit/SemanticAnalysis/AstPrintVisitor.h"
 #include "pljit/SemanticAnalysis/ConstantPropOpt.h"
 #include "pljit/SemanticAnalysis/DeadCodeOpt.h"
+#include "pljit/SemanticAnalysis/ForwardSubstitutionOpt.h"
+#include "pljit/SemanticAnalysis/InliningOpt.h"
 #include "pljit/SemanticAnalysis/SemanticAnalyser.h"
 #include "pljit/Pljit/FunctionObject.h"
 
@@ -13,13 +28,98 @@ using namespace std;
 
 namespace jit {
 
+namespace {
+
+// bindParameters           Returns the values of the parameters bound by the function object (nullopt for the remaining parameters) or nullopt, if a binding refers to a
+//                          parameter that does not exist
+optional<vector<optional<int64_t>>> bindParameters(const FunctionObject& functionobj, size_t nofparameters) {
+
+    vector<optional<int64_t>> values(nofparameters);
+
+    for (auto [index, value] : functionobj.bindings) {
+
+        if (index >= nofparameters) {
+            cerr << "error: Parameter " << index << " cannot be bound, the function has " << nofparameters << " parameter(s)\n";
+            return nullopt;
+        }
+
+        values[index] = value;
+    }
+
+    return values;
+}
+
+// constantResult           Returns the result of the given function, if it neither depends on the parameters nor can fail
+optional<int64_t> constantResult(const IrFunction& ir, const SourceCodeManager& manager) {
+
+    vector<bool> variable(ir.instructions.size(), false);
+
+    for (size_t i = 0; i < ir.instructions.size(); ++i) {
+
+        const IrInstruction& instr = ir.instructions[i];
+
+        if (instr.mayFail())
+            return nullopt;
+
+        variable[i] = instr.opcode == IrInstruction::Opcode::Param || ((instr.isUnary() || instr.isBinary()) && variable[instr.lhs]) ||
+                      (instr.isBinary() && variable[instr.rhs]) || (instr.isTernary() && variable[instr.condition]);
+    }
+
+    if (any_of(ir.results.begin(), ir.results.end(), [&variable](IrFunction::ValueId result) { return variable[result]; }))
+        return nullopt;
+
+    // The parameters are not read by the result, so any arguments can be used
+    IrEvalInstance evalInstance{ir, manager};
+    return evalInstance.evaluate(vector<int64_t>(ir.nofparameters, 0));
+}
+
+// nofPipelineParameters    Returns the number of parameters of the pipeline of the composed function object, i.e. the parameters of its (compiled) stages that do not
+//                          receive the result of the previous stage
+size_t nofPipelineParameters(const FunctionObject& functionobj) {
+
+    size_t nofparameters = 0;
+
+    for (const FunctionObject* stage : functionobj.stages)
+        nofparameters += stage->ir->nofparameters;
+
+    return nofparameters - functionobj.wiring.size();
+}
+
+// guardedArguments         Returns the arguments of the parameters that are not guarded, if the function object has a guarded function and the given arguments
+//                          match its guards (see Pljit::profile)
+optional<vector<int64_t>> guardedArguments(const FunctionObject& functionobj, const vector<int64_t>& args) {
+
+    if (!functionobj.profiled.load() || !functionobj.guarded || args.size() != functionobj.ir->nofparameters)
+        return nullopt;
+
+    vector<int64_t> remaining{};
+    auto guard = functionobj.guards.begin();
+
+    for (size_t i = 0; i < args.size(); ++i) {
+
+        if (guard != functionobj.guards.end() && guard->first == i) {
+
+            if (args[i] != guard->second)
+                return nullopt;
+
+            ++guard;
+        }
+        else
+            remaining.push_back(args[i]);
+    }
+
+    return remaining;
+}
+
+} // namespace
 
-Pljit::Pljit() = default;
+
+Pljit::Pljit(size_t maxNestingDepth, size_t profileSamples, OptimisationLevel level) : maxNestingDepth{maxNestingDepth}, profileSamples{profileSamples}, level{level} {}
 
 Pljit::~Pljit() = default;
 
 
-Pljit::PljitHandle Pljit::registerFunction(string sourceCode) {
+Pljit::PljitHandle Pljit::registerFunction(string sourceCode, string name) {
 
     // If the source code does not end with a new-line character, one single new-line character is added at the end (this is just to print error messages
     // referencing to the last line in a correct way
@@ -30,17 +130,66 @@ Pljit::PljitHandle Pljit::registerFunction(string sourceCode) {
 
     PljitHandle handle{this, functionobj.get()};
 
+    if (!name.empty()) {
+
+        auto [it, inserted] = names.emplace(move(name), functionobj.get());
+
+        if (!inserted)
+            cerr << "error: A function with the name '" << it->first << "' has already been registered, the function cannot be called by its name.\n";
+    }
+
     // Add the function object to the vector of registerd functions
     vecfunctions.emplace_back(move(functionobj));
 
     return handle;
 }
 
-unique_ptr<AstFunction> Pljit::compileFunction(const FunctionObject& functionobj) {
+optional<AstCallee> Pljit::resolveCall(FunctionObject& caller, string_view name, SourceCodeReference location) const {
+
+    auto it = names.find(name);
+
+    if (it == names.end()) {
+        caller.manager.printErrorMessage("error: unknown function", location);
+        return nullopt;
+    }
+
+    FunctionObject& callee = *it->second;
+
+    {
+        // The compiling functions wait for each other along a chain of calls. If the chain starting at the callee leads back to the caller, the call is recursive
+        lock_guard<mutex> lock{callMutex};
+
+        for (const FunctionObject* f = &callee; f; f = f->waitsFor) {
+
+            if (f == &caller) {
+                caller.manager.printErrorMessage("error: recursive call of function", location);
+                return nullopt;
+            }
+        }
+
+        caller.waitsFor = &callee;
+    }
+
+    ensureCompiled(callee);
+
+    {
+        lock_guard<mutex> lock{callMutex};
+        caller.waitsFor = nullptr;
+    }
+
+    if (!callee.ir) {
+        caller.manager.printErrorMessage("error: called function has invalid source code", location);
+        return nullopt;
+    }
+
+    return AstCallee{callee.function.get(), callee.ir.get(), &callee.manager};
+}
+
+unique_ptr<AstFunction> Pljit::compileFunction(FunctionObject& functionobj, vector<PassStatistics>& statistics) const {
 
     // Parse the sourcecode
 
-    Parser parser{functionobj.sourceCode, functionobj.manager};
+    Parser parser{functionobj.sourceCode, functionobj.manager, maxNestingDepth};
 
     auto parsetree = parser.parseFunction();
 
@@ -49,54 +198,591 @@ unique_ptr<AstFunction> Pljit::compileFunction(const FunctionObject& functionobj
 
     // Do the semantical analysis
 
-    SemanticAnalyser seman{functionobj.manager, *parsetree};
+    // Calls are resolved by the names of the registered functions
+    auto resolver = [this, &functionobj](string_view name, SourceCodeReference location) { return resolveCall(functionobj, name, location); };
+
+    SemanticAnalyser seman{functionobj.manager, *parsetree, resolver};
 
     auto function = seman.analyseFunction();
 
     if (!function)
         return nullptr;
 
-    // Run the two optimisation passes on the function object
+    auto parameters = bindParameters(functionobj, function->nofparameters);
+
+    if (!parameters)
+        return nullptr;
 
-    DeadCodeOpt deadcodeopt{};
-    ConstantPropOpt constpropop{};
+    // Run the optimisation passes on the function object (the bound parameters are propagated as constants, the IrBuilder binds them at O0)
 
-    function->optimise(deadcodeopt);
-    function->optimise(constpropop);
+    PassManager passmanager{};
+
+    if (level == OptimisationLevel::O1) {
+        passmanager.addPass("deadcode", make_unique<DeadCodeOpt>());
+        passmanager.addPass("inlining", make_unique<InliningOpt>());
+        passmanager.addPass("constantprop", make_unique<ConstantPropOpt>(move(*parameters)));
+    }
+    else if (level == OptimisationLevel::O2) {
+        // Constant propagation leaves assignments without uses, which are removed by the forward substitution. Forwarded expressions may become constant
+        passmanager.addPass("deadcode", make_unique<DeadCodeOpt>());
+        passmanager.addPass("inlining", make_unique<InliningOpt>());
+        passmanager.addPass("forwardsubstitution", make_unique<ForwardSubstitutionOpt>(), true);
+        passmanager.addPass("constantprop", make_unique<ConstantPropOpt>(move(*parameters)), true);
+    }
+
+    passmanager.run(*function);
+
+    for (PassStatistics& s : passmanager.getStatistics())
+        statistics.push_back(move(s));
 
     return function;
 }
 
-optional<int64_t> Pljit::PljitHandle::operator()(vector<int64_t> args) {
+void Pljit::compile(FunctionObject& functionobj) const {
+
+    if (!functionobj.stages.empty()) {
+        compileComposition(functionobj);
+        return;
+    }
+
+    vector<PassStatistics> statistics{};
+
+    functionobj.function = compileFunction(functionobj, statistics);
+
+    if (!functionobj.function)
+        return;
+
+    functionobj.ir = lower(*functionobj.function, *bindParameters(functionobj, functionobj.function->nofparameters), &functionobj.manager, &statistics);
+    functionobj.statistics = move(statistics);
+    functionobj.constant = constantResult(*functionobj.ir, functionobj.manager);
+}
+
+void Pljit::compileComposition(FunctionObject& functionobj) const {
+
+    for (size_t i = 0; i < functionobj.stages.size(); ++i) {
+
+        FunctionObject& stage = *functionobj.stages[i];
+
+        ensureCompiled(stage);
+
+        if (!stage.ir) {
+            cerr << "error: Function " << i << " of the pipeline has invalid source code\n";
+            return;
+        }
+
+        if (i > 0 && functionobj.wiring[i - 1] >= stage.ir->nofparameters) {
+            cerr << "error: Function " << i << " of the pipeline has " << stage.ir->nofparameters << " parameter(s), parameter " << functionobj.wiring[i - 1]
+                 << " cannot receive the result of the previous function\n";
+            return;
+        }
+    }
+
+    auto parameters = bindParameters(functionobj, nofPipelineParameters(functionobj));
+
+    if (!parameters)
+        return;
+
+    size_t nofremaining = static_cast<size_t>(count(parameters->begin(), parameters->end(), nullopt));
+    auto ir = make_unique<IrFunction>(nofremaining);
+
+    // The bound parameters become constants, the remaining ones the parameters of the composed function
+    vector<IrFunction::ValueId> values{};
+    size_t index = 0;
+
+    for (const optional<int64_t>& parameter : *parameters)
+        values.push_back(parameter ? ir->addConstant(*parameter) : ir->addParameter(index++));
+
+    // Chain the stages, the first result of each stage is passed to the wired parameter of the next one
+    vector<IrFunction::ValueId> results{};
+    auto value = values.begin();
+
+    for (size_t i = 0; i < functionobj.stages.size(); ++i) {
+
+        const IrFunction& stage = *functionobj.stages[i]->ir;
+        vector<IrFunction::ValueId> arguments{};
+
+        for (size_t k = 0; k < stage.nofparameters; ++k)
+            arguments.push_back(i > 0 && k == functionobj.wiring[i - 1] ? results.front() : *value++);
+
+        results = ir->inlineFunction(stage, arguments);
+    }
+
+    ir->results = move(results);
+    ir->assignSlots();
+
+    // The locations of the divisions refer to the source code of the stages, so no warnings are printed
+    vector<PassStatistics> statistics{};
+    optimise(*ir, nullptr, &statistics);
+
+    functionobj.ir = move(ir);
+    functionobj.statistics = move(statistics);
+    functionobj.constant = constantResult(*functionobj.ir, functionobj.manager);
+}
+
+void Pljit::ensureCompiled(FunctionObject& functionobj) const {
 
     // Check, if the function has not yet been compiled
-    if (ptr->compileStatus.load() == 0) {
+    if (functionobj.compileStatus.load() == 0) {
 
         unsigned char c = 0;
-        bool b = ptr->compileStatus.compare_exchange_strong(c, 1);
+        bool b = functionobj.compileStatus.compare_exchange_strong(c, 1);
 
         if (b) { // This thread successfully compare-and-swaped the compile-status-flag from 0 to 1 --> this thread has to compile the function
 
-            auto function = jit->compileFunction(*ptr);
-            ptr->function = move(function);
-            ptr->compileStatus.store(2);        // Set the compile-status-flag to 2 to signal all other threads that the function is ready
+            compile(functionobj);
+            functionobj.compileStatus.store(2);        // Set the compile-status-flag to 2 to signal all other threads that the function is ready
         }
     }
 
     // Wait until the compile-status flag gets set to 2 (exactly one thread will ensure that this definitely happens)
-    while(ptr->compileStatus.load() != 2) {
+    while(functionobj.compileStatus.load() != 2) {
+    }
+}
+
+unique_ptr<IrFunction> Pljit::lower(const AstFunction& function, vector<optional<int64_t>> parameters, const SourceCodeManager* manager, vector<PassStatistics>* statistics) const {
+
+    // Lower the optimised Ast into the intermediate representation, which is used for the execution
+    auto ir = IrBuilder{function, move(parameters)}.buildFunction();
+
+    optimise(*ir, manager, statistics);
+
+    return ir;
+}
+
+void Pljit::optimise(IrFunction& ir, const SourceCodeManager* manager, vector<PassStatistics>* statistics) const {
+
+    PassManager passmanager{};
+    RangeAnalysisOpt* rangeanalysis = nullptr;
+
+    if (level == OptimisationLevel::O1) {
+        passmanager.addPass("valuenumbering", make_unique<ValueNumberingOpt>());
+        passmanager.addPass("strengthreduction", make_unique<StrengthReductionOpt>());
+        passmanager.addPass("deadvalue", make_unique<DeadValueOpt>());
+    }
+    else if (level == OptimisationLevel::O2) {
+
+        auto range = make_unique<RangeAnalysisOpt>();
+        rangeanalysis = range.get();
+
+        // The simplifications enable each other (e.g. merged values become common factors, reduced divisions get known ranges), so they are repeated
+        passmanager.addPass("polynomial", make_unique<PolynomialOpt>());
+        passmanager.addPass("algebraicsimplify", make_unique<AlgebraicSimplifyOpt>(), true);
+        passmanager.addPass("valuenumbering", make_unique<ValueNumberingOpt>(), true);
+        passmanager.addPass("strengthreduction", make_unique<StrengthReductionOpt>(), true);
+        passmanager.addPass("rangeanalysis", move(range), true);
+        passmanager.addPass("deadvalue", make_unique<DeadValueOpt>(), true);
+        passmanager.addPass("treebalancing", make_unique<TreeBalancingOpt>());
+    }
+
+    passmanager.run(ir);
+
+    // Divisions by 0 are not reported before the function is called, but they are worth a warning
+    if (manager && rangeanalysis)
+        for (const SourceCodeReference& location : rangeanalysis->getZeroDivisors())
+            manager->printErrorMessage("warning: Division by 0, every call of the function fails", location);
+
+    if (statistics)
+        for (PassStatistics& s : passmanager.getStatistics())
+            statistics->push_back(move(s));
+}
+
+void Pljit::profile(FunctionObject& functionobj, const vector<int64_t>& args) const {
+
+    lock_guard<mutex> lock{functionobj.profileMutex};
+
+    // Calls with a wrong number of arguments fail anyway and are not sampled
+    if (functionobj.profiled.load() || args.size() != functionobj.ir->nofparameters)
+        return;
+
+    functionobj.samples.push_back(args);
+
+    if (functionobj.samples.size() < profileSamples)
+        return;
+
+    // Find the parameters that have the same value in most of the samples
+    for (size_t i = 0; i < args.size(); ++i) {
+
+        unordered_map<int64_t, size_t> counts{};
+        pair<int64_t, size_t> mostfrequent{0, 0};
+
+        for (const auto& sample : functionobj.samples) {
+
+            size_t count = ++counts[sample[i]];
+
+            if (count > mostfrequent.second)
+                mostfrequent = {sample[i], count};
+        }
+
+        if (mostfrequent.second * 100 >= functionobj.samples.size() * stableRatio)
+            functionobj.guards.emplace_back(i, mostfrequent.first);
+    }
+
+    if (!functionobj.guards.empty()) {
+
+        // The guards refer to the parameters of the handle, i.e. to the parameters that are not bound already
+        vector<optional<int64_t>> parameters = *bindParameters(functionobj, functionobj.function->nofparameters);
+        size_t index = 0;
+        auto guard = functionobj.guards.begin();
+
+        for (auto& parameter : parameters) {
+
+            if (parameter)
+                continue;
+
+            if (guard != functionobj.guards.end() && guard->first == index) {
+                parameter = guard->second;
+                ++guard;
+            }
+
+            ++index;
+        }
+
+        functionobj.guarded = lower(*functionobj.function, move(parameters));
+    }
+
+    functionobj.samples.clear();
+    functionobj.samples.shrink_to_fit();
+    functionobj.profiled.store(true);
+}
+
+Pljit::PljitHandle Pljit::specialize(const PljitHandle& handle, const vector<pair<size_t, int64_t>>& bindings) {
+
+    if (this != handle.jit) {
+        cerr << "error: Handle belongs to a different Pljit object.\n";
+        return makeInvalid();
+    }
+
+    // The indices refer to the parameters that are not bound by the given handle yet. Translate them into the indices of the parameters in the source code
+    vector<pair<size_t, int64_t>> merged = handle.ptr->bindings;
+
+    vector<size_t> bound{};
+    for (const auto& binding : merged)
+        bound.push_back(binding.first);
+
+    sort(bound.begin(), bound.end());
+
+    for (auto [index, value] : bindings) {
+
+        size_t original = index;
+
+        for (size_t b : bound)
+            if (b <= original)
+                ++original;
+
+        merged.emplace_back(original, value);
+    }
+
+    unique_ptr<FunctionObject> functionobj = make_unique<FunctionObject>(handle.ptr->sourceCode, move(merged));
+
+    // Specialised pipelines bind the parameters of the pipeline
+    functionobj->stages = handle.ptr->stages;
+    functionobj->wiring = handle.ptr->wiring;
+
+    PljitHandle specialised{this, functionobj.get()};
+    vecfunctions.emplace_back(move(functionobj));
+
+    return specialised;
+}
+
+Pljit::PljitHandle Pljit::compose(const vector<PljitHandle>& handles, const vector<size_t>& wiring) {
+
+    if (handles.empty()) {
+        cerr << "error: A pipeline needs at least one function.\n";
+        return makeInvalid();
     }
 
+    if (wiring.size() != handles.size() - 1) {
+        cerr << "error: A pipeline of " << handles.size() << " functions needs " << handles.size() - 1 << " wired parameter(s), but " << wiring.size() << " are given.\n";
+        return makeInvalid();
+    }
+
+    for (const PljitHandle& handle : handles) {
+
+        if (this != handle.jit) {
+            cerr << "error: Handle belongs to a different Pljit object.\n";
+            return makeInvalid();
+        }
+    }
+
+    unique_ptr<FunctionObject> functionobj = make_unique<FunctionObject>(string{});
+
+    for (const PljitHandle& handle : handles)
+        functionobj->stages.push_back(handle.ptr);
+
+    functionobj->wiring = wiring;
+
+    PljitHandle composed{this, functionobj.get()};
+    vecfunctions.emplace_back(move(functionobj));
+
+    return composed;
+}
+
+Pljit::PljitHandle Pljit::makeInvalid() {
+
+    unique_ptr<FunctionObject> functionobj = make_unique<FunctionObject>(string{});
+    functionobj->compileStatus.store(2);
+
+    PljitHandle invalid{this, functionobj.get()};
+    vecfunctions.emplace_back(move(functionobj));
+
+    return invalid;
+}
+
+optional<int64_t> Pljit::PljitHandle::operator()(vector<int64_t> args) {
+
+    jit->ensureCompiled(*ptr);
+
     // If the pointer now still is a null-pointer this means an error occurred during compilation
-    if (!ptr->function) {
+    if (!ptr->ir) {
 
         cerr << "error: Handle belongs to invalid source code\n";
         return nullopt;
     }
 
+    // Constant functions return their result without being executed
+    if (ptr->constant && args.size() == ptr->ir->nofparameters)
+        return ptr->constant;
+
+    // Calls with cached arguments do not need to execute the function at all
+    MemoCache* memo = ptr->memo.load();
+
+    if (memo && memo->isEnabled() && args.size() == ptr->ir->nofparameters) {
+
+        optional<int64_t> result = memo->lookup(args);
+
+        if (result)
+            return result;
+    }
+
+    if (jit->profileSamples > 0 && !ptr->profiled.load() && ptr->stages.empty())
+        jit->profile(*ptr, args);
+
+    optional<int64_t> result = jit->execute(*ptr, args);
+
+    // Failed calls are not cached, so that their errors are reported every time
+    if (memo && result && args.size() == ptr->ir->nofparameters)
+        memo->insert(move(args), *result);
+
+    return result;
+}
+
+bool Pljit::PljitHandle::operator()(const vector<int64_t>& args, vector<int64_t>& results) {
+
+    jit->ensureCompiled(*ptr);
+
+    if (!ptr->ir) {
+
+        cerr << "error: Handle belongs to invalid source code\n";
+        return false;
+    }
+
+    if (jit->profileSamples > 0 && !ptr->profiled.load() && ptr->stages.empty())
+        jit->profile(*ptr, args);
+
+    return jit->execute(*ptr, args, results);
+}
+
+optional<int64_t> Pljit::execute(FunctionObject& functionobj, const vector<int64_t>& args) const {
+
+    // Errors of composed functions are not reported, the stages are executed one by one instead
+    if (!functionobj.stages.empty() && args.size() == functionobj.ir->nofparameters) {
+
+        IrEvalInstance evalInstance{*functionobj.ir, functionobj.manager, false};
+        optional<int64_t> result = evalInstance.evaluate(args);
+
+        if (result)
+            return result;
+
+        vector<int64_t> results{};
+        return executeStages(functionobj, args, results) ? optional<int64_t>{results.front()} : nullopt;
+    }
+
+    // Execute the guarded function, if the arguments match its guards
+    if (auto remaining = guardedArguments(functionobj, args)) {
+        IrEvalInstance evalInstance{*functionobj.guarded, functionobj.manager};
+        return evalInstance.evaluate(*remaining);
+    }
+
     // Finally evaluate the function with the given arguments and return the result
-    EvalInstance evalInstance{*ptr->function, ptr->manager};
-    return evalInstance.evaluate(move(args));
+    IrEvalInstance evalInstance{*functionobj.ir, functionobj.manager};
+    return evalInstance.evaluate(args);
+}
+
+bool Pljit::execute(FunctionObject& functionobj, const vector<int64_t>& args, vector<int64_t>& results) const {
+
+    if (!functionobj.stages.empty() && args.size() == functionobj.ir->nofparameters) {
+        IrEvalInstance evalInstance{*functionobj.ir, functionobj.manager, false};
+        return evalInstance.evaluateResults(args, results) || executeStages(functionobj, args, results);
+    }
+
+    if (auto remaining = guardedArguments(functionobj, args)) {
+        IrEvalInstance evalInstance{*functionobj.guarded, functionobj.manager};
+        return evalInstance.evaluateResults(*remaining, results);
+    }
+
+    IrEvalInstance evalInstance{*functionobj.ir, functionobj.manager};
+    return evalInstance.evaluateResults(args, results);
+}
+
+bool Pljit::executeStages(FunctionObject& functionobj, const vector<int64_t>& args, vector<int64_t>& results) const {
+
+    // The parameters of the pipeline are the bound values and the given arguments
+    vector<optional<int64_t>> parameters = *bindParameters(functionobj, nofPipelineParameters(functionobj));
+    auto arg = args.begin();
+
+    for (optional<int64_t>& parameter : parameters)
+        if (!parameter)
+            parameter = *arg++;
+
+    auto parameter = parameters.begin();
+
+    for (size_t i = 0; i < functionobj.stages.size(); ++i) {
+
+        FunctionObject& stage = *functionobj.stages[i];
+        vector<int64_t> arguments{};
+
+        for (size_t k = 0; k < stage.ir->nofparameters; ++k)
+            arguments.push_back(i > 0 && k == functionobj.wiring[i - 1] ? results.front() : **parameter++);
+
+        if (!execute(stage, arguments, results))
+            return false;
+    }
+
+    return true;
+}
+
+void Pljit::evaluateMany(const vector<PljitHandle>& handles, const vector<int64_t>& args, vector<optional<int64_t>>& results) {
+
+    results.assign(handles.size(), nullopt);
+
+    vector<const FunctionObject*> functions{};
+    functions.reserve(handles.size());
+
+    for (const PljitHandle& handle : handles) {
+
+        if (this != handle.jit) {
+            cerr << "error: Handle belongs to a different Pljit object.\n";
+            return;
+        }
+
+        ensureCompiled(*handle.ptr);
+        functions.push_back(handle.ptr);
+    }
+
+    if (handles.empty())
+        return;
+
+    const FusedProgram& program = fuse(functions, args.size());
+
+    // Errors are not reported by the fused function, the functions are called one by one instead
+    vector<int64_t> values{};
+    bool fused = false;
+
+    if (program.ir) {
+        IrEvalInstance evalInstance{*program.ir, handles.front().ptr->manager, false};
+        fused = evalInstance.evaluateResults(args, values);
+    }
+
+    for (size_t i = 0; i < handles.size(); ++i) {
+
+        if (fused && program.outputs[i])
+            results[i] = values[*program.outputs[i]];
+        else {
+            PljitHandle handle = handles[i];
+            results[i] = handle(args);
+        }
+    }
+}
+
+const FusedProgram& Pljit::fuse(const vector<const FunctionObject*>& functions, size_t nofargs) {
+
+    lock_guard<mutex> lock{fusedMutex};
+
+    FusedProgram*& program = fusedindex[{functions, nofargs}];
+
+    if (program)
+        return *program;
+
+    fusedprograms.push_back(make_unique<FusedProgram>());
+    program = fusedprograms.back().get();
+    auto ir = make_unique<IrFunction>(nofargs);
+
+    // The parameters of all functions are the shared arguments
+    vector<IrFunction::ValueId> arguments{};
+    for (size_t i = 0; i < nofargs; ++i)
+        arguments.push_back(ir->addParameter(i));
+
+    for (const FunctionObject* functionobj : functions) {
+
+        // Invalid functions and functions with another number of parameters are called on their own (and report their errors)
+        if (!functionobj->ir || functionobj->ir->nofparameters != nofargs) {
+            program->outputs.emplace_back(nullopt);
+            continue;
+        }
+
+        program->outputs.emplace_back(ir->results.size());
+        ir->results.push_back(ir->inlineFunction(*functionobj->ir, arguments).front());
+    }
+
+    if (ir->results.empty())
+        return *program;
+
+    // The values computed by several functions are merged
+    ValueNumberingOpt valuenumbering{};
+    DeadValueOpt deadvalue{};
+
+    valuenumbering.run(*ir);
+    deadvalue.run(*ir);
+    ir->assignSlots();
+
+    program->ir = move(ir);
+
+    return *program;
+}
+
+bool Pljit::isConstant(const PljitHandle& handle) const {
+
+    if (this != handle.jit) {
+        cerr << "error: Handle belongs to a different Pljit object.\n";
+        return false;
+    }
+
+    ensureCompiled(*handle.ptr);
+
+    return handle.ptr->constant.has_value();
+}
+
+void Pljit::memoise(const PljitHandle& handle, MemoConfig config) {
+
+    if (this != handle.jit) {
+        cerr << "error: Handle belongs to a different Pljit object.\n";
+        return;
+    }
+
+    auto cache = make_unique<MemoCache>(config);
+    MemoCache* expected = nullptr;
+
+    if (!handle.ptr->memo.compare_exchange_strong(expected, cache.get())) {
+        cerr << "error: Function is already memoised.\n";
+        return;
+    }
+
+    handle.ptr->memoStorage = move(cache);
+}
+
+optional<MemoStatistics> Pljit::getMemoStatistics(const PljitHandle& handle) const {
+
+    if (this != handle.jit) {
+        cerr << "error: Handle belongs to a different Pljit object.\n";
+        return nullopt;
+    }
+
+    MemoCache* memo = handle.ptr->memo.load();
+
+    if (!memo)
+        return nullopt;
+
+    return memo->getStatistics();
 }
 
 
@@ -140,7 +826,7 @@ void Pljit::printParseTree(const Pljit::PljitHandle& h, const string& filename)
         return;
     }
 
-    Parser p{h.ptr->sourceCode, h.ptr->manager};
+    Parser p{h.ptr->sourceCode, h.ptr->manager, maxNestingDepth};
     auto pt = p.parseFunction();
 
     assert(pt != nullptr);
@@ -149,6 +835,19 @@ void Pljit::printParseTree(const Pljit::PljitHandle& h, const string& filename)
     printer.printTree(*pt);
 }
 
+vector<PassStatistics> Pljit::getPassStatistics(const Pljit::PljitHandle& h) const {
+
+    if (this != h.jit) {
+        cerr << "error: Handle belongs to a different Pljit object.\n";
+        return {};
+    }
+
+    if (h.ptr->compileStatus.load() != 2)
+        return {};
+
+    return h.ptr->statistics;
+}
+
 
 
 } // namespace jit
\ No newline at end of file
@@ -1,15 +1,27 @@
 #ifndef PLJIT_PLJIT_H
 #define PLJIT_PLJIT_H
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "pljit/Pljit/MemoCache.h"
+#include "pljit/Pljit/PassManager.h"
 
 namespace jit {
 
 class AstFunction;
+struct AstCallee;
+class IrFunction;
+class SourceCodeManager;
+struct SourceCodeReference;
 struct FunctionObject;
+struct FusedProgram;
 
 // Pljit                Creates handles for registered functions and manages the underlying data
 class Pljit {
@@ -26,9 +38,15 @@ class Pljit {
         // Constructor
         explicit PljitHandle(Pljit* jit, FunctionObject* ptr) : ptr{ptr}, jit{jit} {};
 
-        // ()-operator              calls (and perhaps previously compiles) the function associated with the handle. The arguments to the function are given in a vector
+        // ()-operator              calls (and perhaps previously compiles) the function associated with the handle. The arguments to the function are given in a vector.
+        //                          Returns the first value, if the function returns several values
         std::optional<int64_t> operator()(std::vector<int64_t> args);
 
+        // ()-operator              calls the function like the ()-operator above, but writes all values returned by the function (e.g. 'RETURN x, y, z') into the given
+        //                          vector, which is resized to their number, so that repeated calls reuse its memory. Returns false, if the call fails.
+        //                          The result cache (see memoise) holds the first values only, so these calls bypass it
+        bool operator()(const std::vector<int64_t>& args, std::vector<int64_t>& results);
+
         private:
 
         FunctionObject* const ptr;              // Pointer to the associated Function object.
@@ -36,14 +54,53 @@ class Pljit {
     };
 
 
-    // Constructor
-    Pljit();
+    static constexpr size_t defaultMaxNestingDepth = 1000;     // Default for the maximal number of nested parentheses in an expression of a registered function
+
+    static constexpr size_t stableRatio = 90;                   // The percentage of the sampled calls a parameter must have the same value in, to be specialised on
+
+    // Constructor              The maximal number of nested parentheses within expressions of the registered functions can be configured.
+    //                          If 'profileSamples' is not 0, the arguments of the first calls of each function are sampled. Parameters that have the same value in most
+    //                          of these calls are guarded, i.e. the function is compiled once more specialised on their values, and this version is executed whenever
+    //                          the arguments match the guards.
+    //                          The optimisation level trades the time needed to compile a function against the time needed to execute it
+    explicit Pljit(size_t maxNestingDepth = defaultMaxNestingDepth, size_t profileSamples = 0, OptimisationLevel level = OptimisationLevel::O2);
 
     // Destructor
     ~Pljit();
 
-    // registerFunction         registers the given source code and returns a handle to the function
-    PljitHandle registerFunction(std::string sourceCode);
+    // registerFunction         registers the given source code and returns a handle to the function. If a name is given, other functions can call the function
+    //                          with 'CALL name(arguments)'. The calls are resolved when the calling function is compiled, so the called function must be registered before
+    PljitHandle registerFunction(std::string sourceCode, std::string name = {});
+
+    // specialize               Returns a handle to the function of the given handle, whose parameters with the given indices are bound to the given values (pairs of
+    //                          parameter index and value). The bound parameters are propagated as constants, the new function only takes the remaining parameters in their order.
+    //                          The indices refer to the parameters taken by the given handle, so specialised handles can be specialised further
+    PljitHandle specialize(const PljitHandle& handle, const std::vector<std::pair<size_t, int64_t>>& bindings);
+
+    // evaluateMany             Calls the functions of the given handles with the same arguments and writes their results into 'results' (in order of the handles).
+    //                          The first call for a group of handles compiles the group into one fused function, in which the values computed by several functions (the same
+    //                          operations on the same argument positions) are computed once. If the fused function fails, the functions are called one by one, so that the
+    //                          errors are reported as usual. Fused calls bypass the guarded functions (see profileSamples) and the result caches (see memoise)
+    void evaluateMany(const std::vector<PljitHandle>& handles, const std::vector<int64_t>& args, std::vector<std::optional<int64_t>>& results);
+
+    // compose                  Returns a handle to the pipeline of the functions of the given handles: the (first) result of every function is passed to the next function
+    //                          as its parameter with the index wiring[i] (for the handles[i + 1]), the results of the last function are returned. The new function takes the
+    //                          parameters of the first function, followed by the remaining parameters of the next functions in their order.
+    //                          The pipeline is compiled into one function, so the intermediate results are not passed through handles. If it fails, the functions are
+    //                          executed one by one, so that the errors are reported in their source code. Composed functions are not profiled (see profileSamples)
+    PljitHandle compose(const std::vector<PljitHandle>& handles, const std::vector<size_t>& wiring);
+
+    // isConstant               Returns true, if the function of the given handle returns the same value for all valid arguments (e.g. if it has no parameters), so that its
+    //                          calls can be hoisted. Such functions are evaluated when they are compiled, their calls return the value without executing them.
+    //                          Compiles the function, if it has not been compiled yet
+    bool isConstant(const PljitHandle& handle) const;
+
+    // memoise                  Enables the result cache for the function of the given handle: the results of successful calls are cached for their arguments, calls with
+    //                          cached arguments return the result without executing the function. A cache can only be enabled once for every handle
+    void memoise(const PljitHandle& handle, MemoConfig config = {});
+
+    // getMemoStatistics        Returns the lookups of the result cache of the given handle, or nullopt if the handle is not memoised
+    std::optional<MemoStatistics> getMemoStatistics(const PljitHandle& handle) const;
 
     // printAst                 Prints the abstract syntax tree referenced to by the given handle to the given filename in *.dot format
     void printAst(const PljitHandle& handle, const std::string& filename);
@@ -55,13 +112,74 @@ class Pljit {
     //                          As this method is not officially requested and rather for test purposes, I decided to do it that way
     void printParseTree(const PljitHandle& h, const std::string& filename);
 
+    // getPassStatistics        Returns the statistics of the optimisation passes run to compile the function referenced to by the given handle (empty, if the function has
+    //                          not been compiled yet or is invalid)
+    std::vector<PassStatistics> getPassStatistics(const PljitHandle& h) const;
+
 
     private:
 
-    // compileFunction          Compiles the function corresponding to the source code of the function object and returns a pointer to an AstFunction object
-    static std::unique_ptr<AstFunction> compileFunction(const FunctionObject& functionobj);
+    // compileFunction          Compiles the function corresponding to the source code of the function object and returns a pointer to an AstFunction object.
+    //                          The statistics of the optimisation passes are appended to the given vector
+    std::unique_ptr<AstFunction> compileFunction(FunctionObject& functionobj, std::vector<PassStatistics>& statistics) const;
+
+    // resolveCall              Returns the function registered with the given name, which is called by the given function at the given location. Compiles the called
+    //                          function, if it has not been compiled yet. Prints an error and returns nullopt, if there is no such function, it is invalid, or the
+    //                          call is recursive
+    std::optional<AstCallee> resolveCall(FunctionObject& caller, std::string_view name, SourceCodeReference location) const;
+
+    // compileComposition       Compiles the pipeline of the composed function object into its intermediate representation, which remains a null pointer, if a function
+    //                          of the pipeline is invalid or the wiring refers to a parameter that does not exist
+    void compileComposition(FunctionObject& functionobj) const;
+
+    // ensureCompiled           Compiles the function object, if it has not been compiled yet, and waits until it has been compiled (by any thread)
+    void ensureCompiled(FunctionObject& functionobj) const;
+
+    // compile                  Compiles the function object and stores the optimised Ast and its intermediate representation in the function object.
+    //                          If the source code is invalid, both remain null pointers
+    void compile(FunctionObject& functionobj) const;
+
+    // lower                    Lowers the given Ast into the intermediate representation (binding the parameters with given values) and optimises it.
+    //                          Divisions that always fail are reported as warnings through the given manager (if any), the statistics of the optimisation passes are
+    //                          appended to the given vector (if any)
+    std::unique_ptr<IrFunction> lower(const AstFunction& function, std::vector<std::optional<int64_t>> parameters, const SourceCodeManager* manager = nullptr,
+                                      std::vector<PassStatistics>* statistics = nullptr) const;
+
+    // optimise                 Runs the optimisation passes of the optimisation level on the given intermediate representation (see lower)
+    void optimise(IrFunction& ir, const SourceCodeManager* manager, std::vector<PassStatistics>* statistics) const;
+
+    // execute                  Executes the compiled function object with the given arguments (the guarded function, if the arguments match its guards)
+    std::optional<int64_t> execute(FunctionObject& functionobj, const std::vector<int64_t>& args) const;
+
+    // execute                  Executes the compiled function object like execute above and writes all of its results into the given vector. Returns false, if it fails
+    bool execute(FunctionObject& functionobj, const std::vector<int64_t>& args, std::vector<int64_t>& results) const;
+
+    // executeStages            Executes the functions of the pipeline of the composed function object one by one with the given arguments and writes the results of the
+    //                          last function into the given vector. Returns false, if a function fails
+    bool executeStages(FunctionObject& functionobj, const std::vector<int64_t>& args, std::vector<int64_t>& results) const;
+
+    // fuse                     Returns the fused program of the given compiled functions for the given number of arguments, compiles it on the first call
+    const FusedProgram& fuse(const std::vector<const FunctionObject*>& functions, size_t nofargs);
+
+    // makeInvalid              Returns a handle to an invalid function
+    PljitHandle makeInvalid();
+
+    // profile                  Records the given arguments of a call in the profile of the function object. Evaluates the profile after the configured number
+    //                          of samples and compiles the guarded function, if there are stable parameters
+    void profile(FunctionObject& functionobj, const std::vector<int64_t>& args) const;
+
+    const size_t maxNestingDepth;                                       // The maximal number of nested parentheses in an expression
+    const size_t profileSamples;                                        // The number of calls that are sampled for each function (0 disables the profiling)
+    const OptimisationLevel level;                                      // The optimisation level of the compiled functions
 
     std::vector<std::unique_ptr<FunctionObject>> vecfunctions{};        // Stores the associated data (source code, source code manager ...) for the registered functions.
+    std::map<std::string, FunctionObject*, std::less<>> names{};        // The registered functions with a name, by their names
+
+    mutable std::mutex callMutex{};                                     // Protects the functions the compiling functions wait for (see FunctionObject::waitsFor)
+
+    std::mutex fusedMutex{};                                            // Protects the fused programs
+    std::vector<std::unique_ptr<FusedProgram>> fusedprograms{};         // The fused programs of the groups of functions passed to evaluateMany
+    std::map<std::pair<std::vector<const FunctionObject*>, size_t>, FusedProgram*> fusedindex{};     // The fused programs by their functions and number of arguments
 
 };
 
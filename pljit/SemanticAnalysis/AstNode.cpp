@@ -1,5 +1,9 @@
 #include "AstNode.h"
+#include "../Evaluation/Arithmetic.h"
 #include "../Evaluation/EvalInstance.h"
+#include "../IR/IrFunction.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -15,42 +19,253 @@ optional<int64_t> AstIdentifier::evaluate(EvalInstance& instance) {
     return instance.getValue(index);
 }
 
-optional<int64_t> AstBinaryArithmeticExpression::evaluate(EvalInstance& instance) {
+optional<int64_t> AstArithmeticExpression::evaluateIteratively(const AstArithmeticExpression& root, EvalInstance& instance) {
+
+    // Pairs of a node and a flag that indicates, whether the subexpressions of the node have already been evaluated.
+    // The stacks are owned by the evaluation instance, so that they are allocated only once per instance
+    auto& nodestack = instance.nodestack;
+    auto& valuestack = instance.valuestack;
+
+    nodestack.clear();
+    valuestack.clear();
+
+    nodestack.emplace_back(&root, false);
+
+    while (!nodestack.empty()) {
+
+        auto [node, expanded] = nodestack.back();
+
+        switch (node->subtype) {
+
+            case Subtype::Literal:
+                nodestack.pop_back();
+                valuestack.push_back(static_cast<const AstLiteral&>(*node).value);
+                break;
+
+            case Subtype::Identifier:
+                nodestack.pop_back();
+                valuestack.push_back(instance.getValue(static_cast<const AstIdentifier&>(*node).index));
+                break;
+
+            case Subtype::Unary:
+                if (!expanded) {
+                    nodestack.back().second = true;
+                    nodestack.emplace_back(static_cast<const AstUnaryArithmeticExpression&>(*node).subexpr.get(), false);
+                }
+                else {
+                    nodestack.pop_back();
+                    valuestack.back() = wrappingNeg(valuestack.back());
+                }
+                break;
+
+            case Subtype::Binary: {
+
+                const auto& binexpr = static_cast<const AstBinaryArithmeticExpression&>(*node);
+
+                if (!expanded) {
+                    // Push the right subexpression first, so that the left one is evaluated first
+                    nodestack.back().second = true;
+                    nodestack.emplace_back(binexpr.rhs.get(), false);
+                    nodestack.emplace_back(binexpr.lhs.get(), false);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                int64_t rightvalue = valuestack.back();
+                valuestack.pop_back();
+                int64_t& leftvalue = valuestack.back();
+
+                switch (binexpr.op) {
+
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Plus:
+                        leftvalue = wrappingAdd(leftvalue, rightvalue);
+                        break;
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Minus:
+                        leftvalue = wrappingSub(leftvalue, rightvalue);
+                        break;
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Mul:
+                        leftvalue = wrappingMul(leftvalue, rightvalue);
+                        break;
+                    case AstBinaryArithmeticExpression::ArithmeticOperation::Div:
+                        if (rightvalue == 0) {
+                            instance.printErrorMessage("error: Division by 0", binexpr.rhs->location);
+                            return nullopt;
+                        }
+                        leftvalue = wrappingDiv(leftvalue, rightvalue);
+                        break;
+                }
+                break;
+            }
 
-    auto leftvalue = lhs->evaluate(instance);
-    auto rightvalue = rhs->evaluate(instance);
+            case Subtype::Call: {
 
-    if (!leftvalue || !rightvalue)
-        return nullopt;
+                const auto& call = static_cast<const AstCall&>(*node);
+
+                if (!expanded) {
+                    // Push the arguments in reverse order, so that they are evaluated from left to right
+                    nodestack.back().second = true;
+                    for (auto it = call.arguments.rbegin(); it != call.arguments.rend(); ++it)
+                        nodestack.emplace_back(it->get(), false);
+                    break;
+                }
+
+                nodestack.pop_back();
 
-    switch(op) {
-
-        case ArithmeticOperation::Plus:
-            return leftvalue.value() + rightvalue.value();
-        case ArithmeticOperation::Minus:
-            return leftvalue.value() - rightvalue.value();
-        case ArithmeticOperation::Mul:
-            return leftvalue.value() * rightvalue.value();
-        case ArithmeticOperation::Div:
-            if (rightvalue == 0) {
-                instance.printErrorMessage("error: Division by 0", rhs->location);
-                return nullopt;
+                vector<int64_t> arguments(valuestack.end() - static_cast<ptrdiff_t>(call.arguments.size()), valuestack.end());
+                valuestack.resize(valuestack.size() - call.arguments.size());
+
+                // The called function is evaluated with its own instance, its errors refer to its own source code
+                EvalInstance callee{*call.callee.function, *call.callee.manager};
+                optional<int64_t> result = callee.evaluate(move(arguments));
+
+                if (!result) {
+                    instance.printErrorMessage("... in this call", call.location);
+                    return nullopt;
+                }
+
+                valuestack.push_back(*result);
+                break;
             }
-            else
-                return leftvalue.value() / rightvalue.value();
-        default:
-            return nullopt;
+
+            case Subtype::Intrinsic: {
+
+                const auto& intrinsic = static_cast<const AstIntrinsic&>(*node);
+
+                if (!expanded) {
+                    nodestack.back().second = true;
+                    for (auto it = intrinsic.arguments.rbegin(); it != intrinsic.arguments.rend(); ++it)
+                        nodestack.emplace_back(it->get(), false);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                int64_t second = intrinsic.arguments.size() > 1 ? valuestack.back() : 0;
+                valuestack.resize(valuestack.size() + 1 - intrinsic.arguments.size());
+                valuestack.back() = AstIntrinsic::apply(intrinsic.function, valuestack.back(), second);
+                break;
+            }
+
+            case Subtype::Conditional: {
+
+                const auto& conditional = static_cast<const AstConditional&>(*node);
+
+                if (!expanded) {
+                    nodestack.back().second = true;
+                    nodestack.emplace_back(conditional.operands[AstConditional::rhsIndex].get(), false);
+                    nodestack.emplace_back(conditional.operands[AstConditional::lhsIndex].get(), false);
+                    break;
+                }
+
+                int64_t rightvalue = valuestack.back();
+                valuestack.pop_back();
+                int64_t leftvalue = valuestack.back();
+                valuestack.pop_back();
+
+                // The conditional expression is replaced by the selected alternative, the other one is not evaluated (and cannot fail)
+                size_t selected = AstConditional::compare(conditional.comparison, leftvalue, rightvalue) ? AstConditional::thenIndex : AstConditional::elseIndex;
+                nodestack.back() = {conditional.operands[selected].get(), false};
+                break;
+            }
+        }
     }
 
+    return valuestack.back();
+}
+
+void AstArithmeticExpression::releaseSubexpressions(unique_ptr<AstArithmeticExpression> first, unique_ptr<AstArithmeticExpression> second) {
+
+    auto isLeaf = [](const unique_ptr<AstArithmeticExpression>& e) { return !e || e->subtype == Subtype::Literal || e->subtype == Subtype::Identifier; };
+
+    // Leaves can be destroyed directly (this is the common case, no stack is needed then)
+    if (isLeaf(first) && isLeaf(second))
+        return;
+
+    // Detach the subexpressions of every node before destroying it, so that the destructor calls do not nest
+    vector<unique_ptr<AstArithmeticExpression>> pending{};
+    pending.push_back(move(first));
+    pending.push_back(move(second));
+
+    while (!pending.empty()) {
+
+        unique_ptr<AstArithmeticExpression> e = move(pending.back());
+        pending.pop_back();
+
+        if (isLeaf(e))
+            continue;
+
+        if (e->subtype == Subtype::Binary) {
+            auto& binexpr = static_cast<AstBinaryArithmeticExpression&>(*e);
+            pending.push_back(move(binexpr.lhs));
+            pending.push_back(move(binexpr.rhs));
+        }
+        else if (auto* operands = operandsOf(*e)) {
+            for (auto& operand : *operands)
+                pending.push_back(move(operand));
+        }
+        else
+            pending.push_back(move(static_cast<AstUnaryArithmeticExpression&>(*e).subexpr));
+    }
 }
+
+optional<int64_t> AstBinaryArithmeticExpression::evaluate(EvalInstance& instance) {
+
+    return evaluateIteratively(*this, instance);
+}
+
 optional<int64_t> AstUnaryArithmeticExpression::evaluate(EvalInstance& instance) {
 
-    auto subvalue = subexpr->evaluate(instance);
+    return evaluateIteratively(*this, instance);
+}
 
-    if (!subvalue)
-        return nullopt;
+optional<int64_t> AstCall::evaluate(EvalInstance& instance) {
+
+    return evaluateIteratively(*this, instance);
+}
+
+optional<int64_t> AstIntrinsic::evaluate(EvalInstance& instance) {
 
-    return -subvalue.value();
+    return evaluateIteratively(*this, instance);
+}
+
+int64_t AstIntrinsic::apply(Function function, int64_t first, int64_t second) {
+
+    switch (function) {
+        case Function::Min:
+            return branchFreeMin(first, second);
+        case Function::Max:
+            return branchFreeMax(first, second);
+        case Function::Abs:
+            return wrappingAbs(first);
+    }
+
+    return 0;
+}
+
+optional<int64_t> AstConditional::evaluate(EvalInstance& instance) {
+
+    return evaluateIteratively(*this, instance);
+}
+
+bool AstConditional::compare(Comparison comparison, int64_t lhs, int64_t rhs) {
+
+    switch (comparison) {
+        case Comparison::Equal:
+            return lhs == rhs;
+        case Comparison::NotEqual:
+            return lhs != rhs;
+        case Comparison::Less:
+            return lhs < rhs;
+        case Comparison::LessEqual:
+            return lhs <= rhs;
+        case Comparison::Greater:
+            return lhs > rhs;
+        case Comparison::GreaterEqual:
+            return lhs >= rhs;
+    }
+
+    return false;
 }
 
 optional<int64_t> AstAssignment::evaluate(EvalInstance& instance) {
@@ -67,9 +282,19 @@ optional<int64_t> AstAssignment::evaluate(EvalInstance& instance) {
 }
 optional<int64_t> AstReturn::evaluate(EvalInstance& instance) {
 
-    auto result = returnvalue->evaluate(instance);
+    instance.results.clear();
 
-    return result;
+    for (auto& value : returnvalues) {
+
+        auto result = value->evaluate(instance);
+
+        if (!result)
+            return nullopt;
+
+        instance.results.push_back(*result);
+    }
+
+    return instance.results.front();
 }
 
 optional<int64_t> AstStatementList::evaluate(EvalInstance& instance) {
@@ -90,5 +315,53 @@ optional<int64_t> AstFunction::evaluate(EvalInstance& instance) {
     return statementlist->evaluate(instance);
 }
 
+size_t AstFunction::numberExpressions() {
+
+    size_t nofexpressions = 0;
+    auto number = [&nofexpressions](unique_ptr<AstArithmeticExpression>& expr) { expr->id = nofexpressions++; };
+
+    for (auto& statement : statementlist->statements) {
+
+        if (statement->subtype == AstStatement::SubType::AstAssignment) {
+
+            auto& assignment = static_cast<AstAssignment&>(*statement);
+            forEachPostOrder(assignment.lhs, number);
+            forEachPostOrder(assignment.rhs, number);
+        }
+        else
+            forEachExpression(*statement, [&number](unique_ptr<AstArithmeticExpression>& value) { forEachPostOrder(value, number); });
+    }
+
+    return nofexpressions;
+}
+
+
+bool nodeMayFail(const AstArithmeticExpression& expr) {
+
+    if (expr.subtype == AstArithmeticExpression::Subtype::Call) {
+
+        const auto& instructions = static_cast<const AstCall&>(expr).callee.ir->instructions;
+        return any_of(instructions.begin(), instructions.end(), [](const IrInstruction& instr) { return instr.mayFail(); });
+    }
+
+    if (expr.subtype != AstArithmeticExpression::Subtype::Binary)
+        return false;
+
+    const auto& binexpr = static_cast<const AstBinaryArithmeticExpression&>(expr);
+
+    if (binexpr.op != AstBinaryArithmeticExpression::ArithmeticOperation::Div)
+        return false;
+
+    return binexpr.rhs->subtype != AstArithmeticExpression::Subtype::Literal || static_cast<const AstLiteral&>(*binexpr.rhs).value == 0;
+}
+
+bool mayFail(unique_ptr<AstArithmeticExpression>& expr) {
+
+    bool result = false;
+
+    forEachPostOrder(expr, [&result](unique_ptr<AstArithmeticExpression>& e) { result |= nodeMayFail(*e); });
+
+    return result;
+}
 
 } // namespace jit
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "AstVisitor.h"
 #include "OptimisePass.h"
@@ -13,6 +15,8 @@
 namespace jit {
 
 class EvalInstance;
+class IrFunction;
+class AstFunction;
 
 // AstNode                              Base class for all Abstract-Syntax-Tree nodes
 class AstNode {
@@ -56,13 +60,26 @@ class AstArithmeticExpression : public AstNode {
         Literal,
         Identifier,
         Unary,
-        Binary
+        Binary,
+        Call,
+        Intrinsic,
+        Conditional
     };
 
     // Constructor
     AstArithmeticExpression(SourceCodeReference location, Subtype subtype) : AstNode{location, AstNode::AstType::AstArithmeticExpression}, subtype{subtype} {}
 
     const Subtype subtype{};        // Specifies the type of the arithmetic expression
+    size_t id{0};                   // Dense index of the expression within its function, only valid after AstFunction::numberExpressions
+
+    protected:
+
+    // evaluateIteratively              Evaluates the expression tree rooted at the given node with an explicit stack instead of recursion, so that the depth of the tree
+    //                                  is not limited by the call stack
+    static std::optional<int64_t> evaluateIteratively(const AstArithmeticExpression& root, EvalInstance& instance);
+
+    // releaseSubexpressions            Destroys the given subexpressions (and all of their subexpressions) iteratively, so that deep trees do not exhaust the call stack
+    static void releaseSubexpressions(std::unique_ptr<AstArithmeticExpression> first, std::unique_ptr<AstArithmeticExpression> second = nullptr);
 
 };
 
@@ -83,7 +100,7 @@ class AstLiteral : public AstArithmeticExpression {
     // optimise                 Optimises the literal according to the given Optimisation pass
     void optimise(OptimisePass& opt) override {opt.visit(*this);}
 
-    const int64_t value{};          // The integer value of the literal
+    int64_t value{};                // The integer value of the literal (only changed when a constant expression is folded into the literal)
 
 };
 
@@ -124,6 +141,9 @@ class AstBinaryArithmeticExpression : public AstArithmeticExpression {
                                                                                                                                                                                       lhs{std::move(lhs)},
                                                                                                                                                                                       rhs{std::move(rhs)}, op{op}{}
 
+    // Destructor
+    ~AstBinaryArithmeticExpression() override { releaseSubexpressions(std::move(lhs), std::move(rhs)); }
+
     // evaluate                 Evaluates the expression in context of the given evaulation instance
     std::optional<int64_t> evaluate(EvalInstance& instance) override;
 
@@ -154,6 +174,9 @@ class AstUnaryArithmeticExpression : public AstArithmeticExpression {
     AstUnaryArithmeticExpression(SourceCodeReference location, std::unique_ptr<AstArithmeticExpression> subexpr) : AstArithmeticExpression{location, AstArithmeticExpression::Subtype::Unary},
                                                                                                                    subexpr{std::move(subexpr)} {}
 
+    // Destructor
+    ~AstUnaryArithmeticExpression() override { releaseSubexpressions(std::move(subexpr)); }
+
     // evaluate                 Evaluates the expression in context of the given evaulation instance
     std::optional<int64_t> evaluate(EvalInstance& instance) override;
 
@@ -167,6 +190,143 @@ class AstUnaryArithmeticExpression : public AstArithmeticExpression {
 
 };
 
+// AstCallee                            The function called by a call expression, i.e. a registered function that has already been compiled. It is owned by the Pljit object
+struct AstCallee {
+    const AstFunction* function{nullptr};           // The optimised Ast of the function
+    const IrFunction* ir{nullptr};                  // The intermediate representation of the function
+    const SourceCodeManager* manager{nullptr};      // The source code manager of the function, which reports the errors during its evaluation
+};
+
+// AstCall                              Class representing the call of another registered function in the Ast
+class AstCall : public AstArithmeticExpression {
+
+    public:
+
+    // Constructor
+    AstCall(SourceCodeReference location, AstCallee callee, std::vector<std::unique_ptr<AstArithmeticExpression>> arguments) : AstArithmeticExpression{location, AstArithmeticExpression::Subtype::Call},
+                                                                                                                               callee{callee}, arguments{std::move(arguments)} {}
+
+    // Destructor
+    ~AstCall() override { for (auto& argument : arguments) releaseSubexpressions(std::move(argument)); }
+
+    // evaluate                 Evaluates the arguments and the called function in context of the given evaulation instance
+    std::optional<int64_t> evaluate(EvalInstance& instance) override;
+
+    // accept                   Method to support the visitor pattern
+    void accept(AstVisitor& v) override {v.visit(*this);}
+
+    // optimise                 Optimises the call according to the given Optimisation pass
+    void optimise(OptimisePass& opt) override {opt.visit(*this);}
+
+    const AstCallee callee{};                                           // The called function
+    std::vector<std::unique_ptr<AstArithmeticExpression>> arguments{};  // The arguments, one for every parameter of the called function
+
+};
+
+// AstIntrinsic                         Class representing the call of a built-in function (MIN, MAX or ABS) in the Ast
+class AstIntrinsic : public AstArithmeticExpression {
+
+    public:
+
+    enum class Function {
+        Min,
+        Max,
+        Abs
+    };
+
+    // Constructor
+    AstIntrinsic(SourceCodeReference location, Function function, std::vector<std::unique_ptr<AstArithmeticExpression>> arguments) : AstArithmeticExpression{location, AstArithmeticExpression::Subtype::Intrinsic},
+                                                                                                                                     function{function}, arguments{std::move(arguments)} {}
+
+    // Destructor
+    ~AstIntrinsic() override { for (auto& argument : arguments) releaseSubexpressions(std::move(argument)); }
+
+    // evaluate                 Evaluates the arguments and the function in context of the given evaulation instance
+    std::optional<int64_t> evaluate(EvalInstance& instance) override;
+
+    // accept                   Method to support the visitor pattern
+    void accept(AstVisitor& v) override {v.visit(*this);}
+
+    // optimise                 Optimises the intrinsic according to the given Optimisation pass
+    void optimise(OptimisePass& opt) override {opt.visit(*this);}
+
+    // nofArguments             Returns the number of arguments the given function expects
+    static size_t nofArguments(Function function) { return function == Function::Abs ? 1 : 2; }
+
+    // apply                    Returns the value of the given function for the given arguments (the second one is ignored by ABS)
+    static int64_t apply(Function function, int64_t first, int64_t second);
+
+    const Function function{};                                          // The called function
+    std::vector<std::unique_ptr<AstArithmeticExpression>> arguments{};  // The arguments, one for every parameter of the function
+
+};
+
+// AstConditional                       Class representing a conditional expression 'IF lhs comparison rhs THEN a ELSE b' in the Ast. Only the selected alternative is
+//                                      evaluated, so the other one cannot fail (e.g. 'IF d <> 0 THEN x / d ELSE 0')
+class AstConditional : public AstArithmeticExpression {
+
+    public:
+
+    enum class Comparison {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+
+    // The indices of the operands
+    static constexpr size_t lhsIndex = 0;
+    static constexpr size_t rhsIndex = 1;
+    static constexpr size_t thenIndex = 2;
+    static constexpr size_t elseIndex = 3;
+
+    // Constructor              The operands are the compared expressions and the two alternatives (in this order)
+    AstConditional(SourceCodeReference location, Comparison comparison, std::vector<std::unique_ptr<AstArithmeticExpression>> operands) : AstArithmeticExpression{location, AstArithmeticExpression::Subtype::Conditional},
+                                                                                                                                            comparison{comparison}, operands{std::move(operands)} {}
+
+    // Destructor
+    ~AstConditional() override { for (auto& operand : operands) releaseSubexpressions(std::move(operand)); }
+
+    // evaluate                 Evaluates the comparison and the selected alternative in context of the given evaulation instance
+    std::optional<int64_t> evaluate(EvalInstance& instance) override;
+
+    // accept                   Method to support the visitor pattern
+    void accept(AstVisitor& v) override {v.visit(*this);}
+
+    // optimise                 Optimises the conditional expression according to the given Optimisation pass
+    void optimise(OptimisePass& opt) override {opt.visit(*this);}
+
+    // compare                  Returns the result of the given comparison of the given values
+    static bool compare(Comparison comparison, int64_t lhs, int64_t rhs);
+
+    const Comparison comparison{};                                      // The comparison of the first two operands, which selects the alternative
+    std::vector<std::unique_ptr<AstArithmeticExpression>> operands{};   // The compared expressions, the THEN alternative and the ELSE alternative
+
+};
+
+// operandsOf                           Returns the operands of a call, an intrinsic or a conditional expression, or nullptr for all other expressions (which have at most two
+//                                      subexpressions)
+inline std::vector<std::unique_ptr<AstArithmeticExpression>>* operandsOf(AstArithmeticExpression& expr) {
+
+    switch (expr.subtype) {
+        case AstArithmeticExpression::Subtype::Call:
+            return &static_cast<AstCall&>(expr).arguments;
+        case AstArithmeticExpression::Subtype::Intrinsic:
+            return &static_cast<AstIntrinsic&>(expr).arguments;
+        case AstArithmeticExpression::Subtype::Conditional:
+            return &static_cast<AstConditional&>(expr).operands;
+        default:
+            return nullptr;
+    }
+}
+
+inline const std::vector<std::unique_ptr<AstArithmeticExpression>>* operandsOf(const AstArithmeticExpression& expr) {
+
+    return operandsOf(const_cast<AstArithmeticExpression&>(expr));
+}
+
 // AstStatement                         Base class for statement nodes in the Ast, i.e. assignments and return-statements
 class AstStatement : public AstNode {
 
@@ -214,10 +374,11 @@ class AstReturn : public AstStatement {
     public:
 
     // Constructor
-    AstReturn(SourceCodeReference location, std::unique_ptr<AstArithmeticExpression> returnvalue) : AstStatement{location, AstStatement::SubType::AstReturn},
-                                                                                                    returnvalue{std::move(returnvalue)} {}
+    AstReturn(SourceCodeReference location, std::vector<std::unique_ptr<AstArithmeticExpression>> returnvalues) : AstStatement{location, AstStatement::SubType::AstReturn},
+                                                                                                                  returnvalues{std::move(returnvalues)} {}
 
-    // evaluate                 Executes the return statement in context of the given evaulation instance
+    // evaluate                 Executes the return statement in context of the given evaulation instance, i.e. evaluates all returned values (see EvalInstance::getResults)
+    //                          and returns the first one
     std::optional<int64_t> evaluate(EvalInstance& instance) override;
 
     // accept                   Method to support the visitor pattern
@@ -227,7 +388,7 @@ class AstReturn : public AstStatement {
     void optimise(OptimisePass& opt) override {opt.visit(*this);}
 
 
-    std::unique_ptr<AstArithmeticExpression> returnvalue{};         // The expression to be returned
+    std::vector<std::unique_ptr<AstArithmeticExpression>> returnvalues{};       // The expressions of the returned values (at least one)
 };
 
 // AstStatementList                     Class representing a statement-list (i.e. an ordered collection of statements) node in the Ast
@@ -257,11 +418,13 @@ class AstFunction : public AstNode {
     public:
 
     // Constructor
-    AstFunction(SourceCodeReference location, std::unique_ptr<AstStatementList> statementlist, size_t nofparameters, size_t nofvariables) : AstNode{location, AstType::AstFunction},
+    AstFunction(SourceCodeReference location, std::unique_ptr<AstStatementList> statementlist, size_t nofparameters, size_t nofvariables, size_t nofresults = 1) :
+                                                                                                                                         AstNode{location, AstType::AstFunction},
                                                                                                                                          statementlist{std::move(statementlist)},
                                                                                                                                          nofidentifiers{nofparameters + nofvariables},
                                                                                                                                          nofparameters{nofparameters},
-                                                                                                                                         nofvariables{nofvariables} {}
+                                                                                                                                         nofvariables{nofvariables},
+                                                                                                                                         nofresults{nofresults} {}
 
 
     // evaulate                 Evaluates resp. executes the function in context of the given Evaluation instance
@@ -273,6 +436,10 @@ class AstFunction : public AstNode {
     // optimise                 Optimises the function according to the given Optimisation pass
     void optimise(OptimisePass& opt) override {opt.visit(*this);}
 
+    // numberExpressions        Assigns dense ids to all expressions of the function (in order of the statements, subexpressions first), so that passes can store
+    //                          their state per expression in flat vectors. Returns the number of expressions. Passes replacing nodes invalidate the ids
+    size_t numberExpressions();
+
 
     std::unique_ptr<AstStatementList> statementlist;                // Contains the statements of the function
 
@@ -280,11 +447,70 @@ class AstFunction : public AstNode {
     // CAUTION:
     // In contrast to during the semantical analyisis, constants are not counted as identifiers in this final AstFunction object anymore as they have been turned
     // into AstLiteral ndoes,  i.e. SemanticAnalyser.nofidentifiers != AstFunction.nofidentifiers
-    const size_t nofidentifiers{};
+    // The inlining of calls adds variables to the function
+    size_t nofidentifiers{};
     const size_t nofparameters{};
-    const size_t nofvariables{};
+    size_t nofvariables{};
+
+    const size_t nofresults{};          // The number of values returned by the (first) return statement
 };
 
+// forEachPostOrder                     Traverses the expression tree owned by 'root' and calls 'f' with the owning pointer of every node, the subexpressions before the expression
+//                                      containing them. 'f' may replace the node it is called for (e.g. by a folded literal).
+//                                      The traversal uses an explicit stack instead of recursion, so the depth of the tree is not limited by the call stack.
+template<typename F>
+void forEachPostOrder(std::unique_ptr<AstArithmeticExpression>& root, F&& f) {
+
+    // Pairs of a node and a flag that indicates, whether the subexpressions of the node have already been pushed
+    std::vector<std::pair<std::unique_ptr<AstArithmeticExpression>*, bool>> stack{{&root, false}};
+
+    while (!stack.empty()) {
+
+        std::unique_ptr<AstArithmeticExpression>* slot = stack.back().first;
+
+        if (stack.back().second) {
+            stack.pop_back();
+            f(*slot);
+            continue;
+        }
+
+        stack.back().second = true;
+
+        // Push the right subexpression first, so that the left one is visited first
+        if ((*slot)->subtype == AstArithmeticExpression::Subtype::Binary) {
+
+            auto& binexpr = static_cast<AstBinaryArithmeticExpression&>(**slot);
+            stack.emplace_back(&binexpr.rhs, false);
+            stack.emplace_back(&binexpr.lhs, false);
+        }
+        else if ((*slot)->subtype == AstArithmeticExpression::Subtype::Unary)
+            stack.emplace_back(&static_cast<AstUnaryArithmeticExpression&>(**slot).subexpr, false);
+        else if (auto* operands = operandsOf(**slot)) {
+
+            for (auto it = operands->rbegin(); it != operands->rend(); ++it)
+                stack.emplace_back(&*it, false);
+        }
+    }
+}
+
+// nodeMayFail                          Checks, if evaluating the given node itself (without its subexpressions) may fail: a division by a non-literal or by 0,
+//                                      or a call of a function that may fail
+bool nodeMayFail(const AstArithmeticExpression& expr);
+
+// mayFail                              Checks, if evaluating the given expression tree may fail (see nodeMayFail)
+bool mayFail(std::unique_ptr<AstArithmeticExpression>& expr);
+
+// forEachExpression                    Calls 'f' with the owning pointer of every expression of the given statement, i.e. the right hand side of an assignment or the returned values
+template<typename F>
+void forEachExpression(AstStatement& statement, F&& f) {
+
+    if (statement.subtype == AstStatement::SubType::AstAssignment)
+        f(static_cast<AstAssignment&>(statement).rhs);
+    else
+        for (auto& value : static_cast<AstReturn&>(statement).returnvalues)
+            f(value);
+}
+
 
 } // namespace jit
 
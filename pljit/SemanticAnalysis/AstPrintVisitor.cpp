@@ -92,6 +92,106 @@ void AstPrintVisitor::visit(const AstBinaryArithmeticExpression& node) {
 }
 
 
+void AstPrintVisitor::visit(const AstCall& node) {
+
+    // Print the label of the node
+    of << index << " [label=\"CALL\"]\n";
+
+    // If the node has a parent node, print the edge from the parent node to this node
+    if (!indexstack.empty())
+        of << indexstack.top() << " -> " << index << "\n";
+
+    // Push the index of this node to the stack (as parent node for the direct child nodes)
+    indexstack.push(index++);
+
+    for (const auto& argument : node.arguments)
+        argument->accept(*this);
+
+    // Remove the index of the current node from the stack
+    indexstack.pop();
+
+}
+
+
+void AstPrintVisitor::visit(const AstIntrinsic& node) {
+
+    const char* label{};
+
+    switch (node.function) {
+        case AstIntrinsic::Function::Min:
+            label = "MIN";
+            break;
+        case AstIntrinsic::Function::Max:
+            label = "MAX";
+            break;
+        case AstIntrinsic::Function::Abs:
+            label = "ABS";
+            break;
+    }
+
+    // Print the label of the node
+    of << index << " [label=\"" << label << "\"]\n";
+
+    // If the node has a parent node, print the edge from the parent node to this node
+    if (!indexstack.empty())
+        of << indexstack.top() << " -> " << index << "\n";
+
+    // Push the index of this node to the stack (as parent node for the direct child nodes)
+    indexstack.push(index++);
+
+    for (const auto& argument : node.arguments)
+        argument->accept(*this);
+
+    // Remove the index of the current node from the stack
+    indexstack.pop();
+
+}
+
+
+void AstPrintVisitor::visit(const AstConditional& node) {
+
+    const char* comparison{};
+
+    switch (node.comparison) {
+        case AstConditional::Comparison::Equal:
+            comparison = "=";
+            break;
+        case AstConditional::Comparison::NotEqual:
+            comparison = "<>";
+            break;
+        case AstConditional::Comparison::Less:
+            comparison = "<";
+            break;
+        case AstConditional::Comparison::LessEqual:
+            comparison = "<=";
+            break;
+        case AstConditional::Comparison::Greater:
+            comparison = ">";
+            break;
+        case AstConditional::Comparison::GreaterEqual:
+            comparison = ">=";
+            break;
+    }
+
+    // Print the label of the node, the children are the compared expressions and the two alternatives
+    of << index << " [label=\"IF " << comparison << "\"]\n";
+
+    // If the node has a parent node, print the edge from the parent node to this node
+    if (!indexstack.empty())
+        of << indexstack.top() << " -> " << index << "\n";
+
+    // Push the index of this node to the stack (as parent node for the direct child nodes)
+    indexstack.push(index++);
+
+    for (const auto& operand : node.operands)
+        operand->accept(*this);
+
+    // Remove the index of the current node from the stack
+    indexstack.pop();
+
+}
+
+
 void AstPrintVisitor::visit(const AstReturn& node) {
 
     // Print the label of the node
@@ -104,7 +204,8 @@ void AstPrintVisitor::visit(const AstReturn& node) {
     // Push the index of this node to the stack (as parent node for the direct child nodes)
     indexstack.push(index++);
 
-    node.returnvalue->accept(*this);
+    for (const auto& value : node.returnvalues)
+        value->accept(*this);
 
     // Remove the index of the current node from the stack
     indexstack.pop();
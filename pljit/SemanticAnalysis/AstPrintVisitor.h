@@ -24,6 +24,9 @@ class AstPrintVisitor : public AstVisitor {
     void visit(const AstIdentifier& node) override ;
     void visit(const AstUnaryArithmeticExpression& node) override ;
     void visit(const AstBinaryArithmeticExpression& node) override;
+    void visit(const AstCall& node) override;
+    void visit(const AstIntrinsic& node) override;
+    void visit(const AstConditional& node) override;
     void visit(const AstReturn& node) override ;
     void visit(const AstAssignment& node) override ;
     void visit(const AstStatementList& node) override;
@@ -8,6 +8,9 @@ class AstLiteral;
 class AstIdentifier;
 class AstUnaryArithmeticExpression;
 class AstBinaryArithmeticExpression;
+class AstCall;
+class AstIntrinsic;
+class AstConditional;
 class AstReturn;
 class AstAssignment;
 class AstStatementList;
@@ -21,6 +24,9 @@ class AstVisitor {
     virtual void visit(const AstIdentifier& node) = 0;
     virtual void visit(const AstUnaryArithmeticExpression& node) = 0;
     virtual void visit(const AstBinaryArithmeticExpression& node) = 0;
+    virtual void visit(const AstCall& node) = 0;
+    virtual void visit(const AstIntrinsic& node) = 0;
+    virtual void visit(const AstConditional& node) = 0;
     virtual void visit(const AstReturn& node) = 0;
     virtual void visit(const AstAssignment& node) = 0;
     virtual void visit(const AstStatementList& node) = 0;
@@ -1,139 +1,200 @@
 #include "ConstantPropOpt.h"
+#include "pljit/Evaluation/Arithmetic.h"
 
 using namespace std;
 
 namespace jit {
 
+namespace {
+
+// takeLiteral              Removes a literal node from the expression tree owned by 'root' (not the root itself) and returns it, or returns a null pointer,
+//                          if the tree does not contain a literal. The removed literal leaves an empty pointer in the tree, which must be destroyed afterwards
+unique_ptr<AstArithmeticExpression> takeLiteral(unique_ptr<AstArithmeticExpression>& root) {
+
+    vector<unique_ptr<AstArithmeticExpression>*> stack{&root};
+
+    while (!stack.empty()) {
+
+        unique_ptr<AstArithmeticExpression>& slot = *stack.back();
+        stack.pop_back();
+
+        if (slot->subtype == AstArithmeticExpression::Subtype::Literal && &slot != &root)
+            return move(slot);
+
+        if (slot->subtype == AstArithmeticExpression::Subtype::Binary) {
+
+            auto& binexpr = static_cast<AstBinaryArithmeticExpression&>(*slot);
+            stack.push_back(&binexpr.rhs);
+            stack.push_back(&binexpr.lhs);
+        }
+        else if (slot->subtype == AstArithmeticExpression::Subtype::Unary)
+            stack.push_back(&static_cast<AstUnaryArithmeticExpression&>(*slot).subexpr);
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
 
 void ConstantPropOpt::visit(AstLiteral& node) {
 
     // A literal node is always constant
-    exprmap.insert(pair<AstNode*, int64_t>(&node, node.value));
+    exprvalues[node.id] = node.value;
 }
 
 void ConstantPropOpt::visit(AstIdentifier& node) {
 
     // Check, if the identifier is currently marked as constant. If so, mark the expression as constant
-    if (vartable[node.index])
-        exprmap.insert(pair<AstNode*, int64_t>(&node, *vartable[node.index]));
-
+    exprvalues[node.id] = vartable[node.index];
 }
 
 void ConstantPropOpt::visit(AstUnaryArithmeticExpression& node) {
 
-    if(firstRun) {  // First run
+    // The subexpression has already been visited (see markConstants). If it is marked as constant, mark this unary expression as constant as well
+    const optional<int64_t>& value = exprvalues[node.subexpr->id];
 
-        // Optimise the subexpression
-        node.subexpr->optimise(*this);
+    if (value)
+        exprvalues[node.id] = wrappingNeg(*value);
+}
 
-        // Check if the subexpression is marked as constant. If so, mark this unary expression as constant as well
-        auto it = exprmap.find(node.subexpr.get());
+void ConstantPropOpt::visit(AstBinaryArithmeticExpression& node) {
 
-        if (it != exprmap.end())
-            exprmap.insert(pair<AstNode*, int64_t>(&node, - it->second.value()));
+    // The subexpressions have already been visited (see markConstants)
+    const optional<int64_t>& left = exprvalues[node.lhs->id];
+    const optional<int64_t>& right = exprvalues[node.rhs->id];
+
+    // If both subexpression are constant then the expression is also constant
+    if (left && right) {
+
+        int64_t leftres = *left;
+        int64_t rightres = *right;
+
+        switch(node.op) {
+
+            case AstBinaryArithmeticExpression::ArithmeticOperation::Plus:
+                exprvalues[node.id] = wrappingAdd(leftres, rightres);
+                break;
+            case AstBinaryArithmeticExpression::ArithmeticOperation::Minus:
+                exprvalues[node.id] = wrappingSub(leftres, rightres);
+                break;
+            case AstBinaryArithmeticExpression::ArithmeticOperation::Mul:
+                exprvalues[node.id] = wrappingMul(leftres, rightres);
+                break;
+            case AstBinaryArithmeticExpression::ArithmeticOperation::Div:
+                // A division by zero is not constant, it fails when the function is called
+                if (rightres != 0)
+                    exprvalues[node.id] = wrappingDiv(leftres, rightres);
+                break;
+        }
     }
-    else {  // Second run
-
-        // If this unary expression (referred to by the node reference) cannot be made constant, it is impossible that the subexpression can be made constant.
-        // So just descend into the subexpression and check if subexpressions of the subexpression can be optimised
-        node.subexpr->optimise(*this);
+}
 
-    }
+void ConstantPropOpt::visit(AstCall&) {
 
+    // The result of a call is not known, its arguments have already been visited (see markConstants). Calls of small functions become constant after inlining
 }
 
-void ConstantPropOpt::visit(AstBinaryArithmeticExpression& node) {
+void ConstantPropOpt::visit(AstIntrinsic& node) {
 
-    if (firstRun) { // First run
+    // The arguments have already been visited (see markConstants). If all of them are constant, the intrinsic is constant as well
+    for (const auto& argument : node.arguments)
+        if (!exprvalues[argument->id])
+            return;
 
-        // Optimise the subexpressions
-        node.lhs->optimise(*this);
-        node.rhs->optimise(*this);
-
-        auto itleft = exprmap.find(node.lhs.get());
-        auto itright = exprmap.find(node.rhs.get());
-
-        bool divbyzero{false};
-
-        // If both subexpression are constant then the expression is also constant
-        if (itleft != exprmap.end() && itright != exprmap.end()) {
-
-            int64_t leftres = itleft->second.value();
-            int64_t rightres = itright->second.value();
-            int64_t result{};
-
-            switch(node.op) {
-
-                case AstBinaryArithmeticExpression::ArithmeticOperation::Plus:
-                    result = leftres + rightres;
-                    break;
-                case AstBinaryArithmeticExpression::ArithmeticOperation::Minus:
-                    result = leftres - rightres;
-                    break;
-                case AstBinaryArithmeticExpression::ArithmeticOperation::Mul:
-                    result = leftres * rightres;
-                    break;
-                case AstBinaryArithmeticExpression::ArithmeticOperation::Div:
-                    if (rightres == 0)
-                        divbyzero = true;
-                    else
-                        result = leftres / rightres;
-                    break;
-            }
+    int64_t second = node.arguments.size() > 1 ? *exprvalues[node.arguments[1]->id] : 0;
+    exprvalues[node.id] = AstIntrinsic::apply(node.function, *exprvalues[node.arguments[0]->id], second);
+}
 
-            if (!divbyzero)
-                exprmap.insert(pair<AstNode*, optional<int64_t>>(&node, result));
-        }
-    }
-    else {  // Second run
+void ConstantPropOpt::visit(AstConditional& node) {
 
-        // Check if the left subexpression can be made constant, otherwise descend into it
-        auto it = exprmap.find(node.lhs.get());
+    // The operands have already been visited (see markConstants). If the comparison is constant, the expression has the value of the selected alternative
+    optional<size_t> selected = selectedOperand(node);
 
-        if (it != exprmap.end()) {
+    if (selected)
+        exprvalues[node.id] = exprvalues[node.operands[*selected]->id];
+}
 
-            SourceCodeReference ref = node.lhs->location;
-            node.lhs = make_unique<AstLiteral>(ref, it->second.value());
-        }
-        else
-            node.lhs->optimise(*this);
+optional<size_t> ConstantPropOpt::selectedOperand(const AstConditional& node) const {
 
+    const optional<int64_t>& left = exprvalues[node.operands[AstConditional::lhsIndex]->id];
+    const optional<int64_t>& right = exprvalues[node.operands[AstConditional::rhsIndex]->id];
 
-        // Check if the right subexpression can be made constant, otherwise descend into it
-        it = exprmap.find(node.rhs.get());
+    if (!left || !right)
+        return nullopt;
 
-        if (it != exprmap.end()) {
+    return AstConditional::compare(node.comparison, *left, *right) ? AstConditional::thenIndex : AstConditional::elseIndex;
+}
 
-            SourceCodeReference ref = node.rhs->location;
-            node.rhs = make_unique<AstLiteral>(ref, it->second.value());
-        }
-        else
-            node.rhs->optimise(*this);
-    }
+void ConstantPropOpt::markConstants(unique_ptr<AstArithmeticExpression>& expr) {
 
+    // Visit all nodes bottom-up, so that the subexpressions of a node are marked before the node itself
+    forEachPostOrder(expr, [this](unique_ptr<AstArithmeticExpression>& e) { e->optimise(*this); });
 }
 
-void ConstantPropOpt::visit(AstReturn& node) {
+void ConstantPropOpt::foldConstants(unique_ptr<AstArithmeticExpression>& expr) {
 
-    if (firstRun) { // First run
+    // Replace the largest constant subexpressions by literal nodes (top-down, with an explicit stack instead of recursion)
+    vector<unique_ptr<AstArithmeticExpression>*> stack{&expr};
 
-        // Optimise the return value of the return statement
-        node.returnvalue->optimise(*this);
-    }
-    else {  // Second run
+    while (!stack.empty()) {
+
+        unique_ptr<AstArithmeticExpression>& slot = *stack.back();
+        stack.pop_back();
 
-        // Check if the return value expression can be merged into a literal node, otherwise descend into it
-        auto it = exprmap.find(node.returnvalue.get());
+        const optional<int64_t>& value = exprvalues[slot->id];
 
-        if (it != exprmap.end()) {
+        if (value) {
 
-            SourceCodeReference location = node.returnvalue->location;
-            node.returnvalue = make_unique<AstLiteral>(location, it->second.value());
+            // Literals are already folded
+            if (slot->subtype == AstArithmeticExpression::Subtype::Literal)
+                continue;
+
+            unique_ptr<AstArithmeticExpression> literal = takeLiteral(slot);
+            SourceCodeReference location = slot->location;
+
+            if (literal) {
+                static_cast<AstLiteral&>(*literal).value = *value;
+                literal->location = location;
+            }
+            else
+                literal = make_unique<AstLiteral>(location, *value);
+
+            literal->id = slot->id;
+            slot = move(literal);
+            ++nofchanges;
+        }
+        else if (slot->subtype == AstArithmeticExpression::Subtype::Binary) {
+
+            auto& binexpr = static_cast<AstBinaryArithmeticExpression&>(*slot);
+            stack.push_back(&binexpr.rhs);
+            stack.push_back(&binexpr.lhs);
+        }
+        else if (slot->subtype == AstArithmeticExpression::Subtype::Unary)
+            stack.push_back(&static_cast<AstUnaryArithmeticExpression&>(*slot).subexpr);
+        else if (slot->subtype == AstArithmeticExpression::Subtype::Conditional && selectedOperand(static_cast<AstConditional&>(*slot))) {
+
+            // A conditional expression with a constant comparison is replaced by the selected alternative, which is folded afterwards
+            auto& conditional = static_cast<AstConditional&>(*slot);
+            slot = move(conditional.operands[*selectedOperand(conditional)]);
+            stack.push_back(&slot);
+            ++nofchanges;
         }
-        else
-            node.returnvalue->optimise(*this);
+        else if (auto* operands = operandsOf(*slot))
+            for (auto& operand : *operands)
+                stack.push_back(&operand);
     }
+}
+
+void ConstantPropOpt::visit(AstReturn& node) {
+
+    for (auto& value : node.returnvalues) {
 
+        if (firstRun) // First run: Mark the constant subexpressions of the returned values
+            markConstants(value);
+        else          // Second run: Merge the constant subexpressions into literal nodes
+            foldConstants(value);
+    }
 }
 
 void ConstantPropOpt::visit(AstAssignment& node) {
@@ -141,32 +202,15 @@ void ConstantPropOpt::visit(AstAssignment& node) {
     if (firstRun) { // First run
 
         // optimise the expression on the right hand side
-        node.rhs->optimise(*this);
+        markConstants(node.rhs);
 
         // Check if the right hand side expression is a constant value
-        auto it = exprmap.find(node.rhs.get());
-
-        // if the expression is a constant value, mark the identifier on the left hand side as constant
-        if (it != exprmap.end())
-            vartable[static_cast<AstIdentifier&>(*node.lhs).index] = it->second.value();
-        else    // Otherwise mark the identifier on the left hand side as non-constant
-            vartable[static_cast<AstIdentifier&>(*node.lhs).index] = nullopt;
-
-    }
-    else { // Second run
-
-        // Check if the expression on the right hand side can be merged into a literal node, otherwise descend into it
-        auto it = exprmap.find(node.rhs.get());
+        // if the expression is a constant value, mark the identifier on the left hand side as constant, otherwise as non-constant
+        vartable[static_cast<AstIdentifier&>(*node.lhs).index] = exprvalues[node.rhs->id];
 
-        if (it != exprmap.end()) {
-
-            SourceCodeReference location = node.rhs->location;
-            node.rhs = make_unique<AstLiteral>(location, it->second.value());
-        }
-        else
-            node.rhs->optimise(*this);
     }
-
+    else // Second run: Merge the constant subexpressions of the right hand side into literal nodes
+        foldConstants(node.rhs);
 }
 
 void ConstantPropOpt::visit(AstStatementList& node) {
@@ -180,7 +224,13 @@ void ConstantPropOpt::visit(AstStatementList& node) {
 void ConstantPropOpt::visit(AstFunction& node) {
 
     vartable = vector<optional<int64_t>>(node.nofidentifiers, nullopt);
-    exprmap.clear();
+
+    // The parameters are the first identifiers
+    for (size_t i = 0; i < parameters.size() && i < node.nofparameters; ++i)
+        vartable[i] = parameters[i];
+
+    // The passes before may have replaced nodes, so the expressions are numbered again
+    exprvalues.assign(node.numberExpressions(), nullopt);
 
     // Do the first run over the nodes
     firstRun = true;
@@ -2,7 +2,6 @@
 #define PLJIT_CONSTANTPROPOPT_H
 
 #include <vector>
-#include <map>
 #include <memory>
 #include <optional>
 
@@ -21,11 +20,17 @@ class ConstantPropOpt : public OptimisePass {
     // Constructor
     ConstantPropOpt() = default;
 
+    // Constructor              The given values of the parameters are propagated as constants (nullopt for parameters without known value)
+    explicit ConstantPropOpt(std::vector<std::optional<int64_t>> parameters) : parameters{std::move(parameters)} {}
+
     // The visit methods to support the visitor pattern
     void visit(AstLiteral& node) override;
     void visit(AstIdentifier& node) override ;
     void visit(AstUnaryArithmeticExpression& node) override ;
     void visit(AstBinaryArithmeticExpression& node) override;
+    void visit(AstCall& node) override;
+    void visit(AstIntrinsic& node) override;
+    void visit(AstConditional& node) override;
     void visit(AstReturn& node) override ;
     void visit(AstAssignment& node) override ;
     void visit(AstStatementList& node) override;
@@ -33,16 +38,28 @@ class ConstantPropOpt : public OptimisePass {
 
     private:
 
-    // Maps an AstNode (its address) to an optional<int64_t> value.
-    // nullopt        ==> The AstNode is currently marked as non-constant
-    // int64_t value  ==> The AstNode is currently marked as constant with the specified integer value
-    std::map<AstNode*, std::optional<int64_t>> exprmap{};
+    // markConstants            Marks all constant subexpressions of the given expression in exprmap (first run)
+    void markConstants(std::unique_ptr<AstArithmeticExpression>& expr);
+
+    // foldConstants            Replaces the largest constant subexpressions of the given expression by literal nodes (second run). A literal of the subexpression is
+    //                          reused for the folded value, new literal nodes are only allocated for subexpressions without literals
+    void foldConstants(std::unique_ptr<AstArithmeticExpression>& expr);
+
+    // selectedOperand          Returns the index of the alternative selected by the given conditional expression, if its comparison is constant
+    std::optional<size_t> selectedOperand(const AstConditional& node) const;
+
+    // For all expressions (in order of their ids, see AstFunction::numberExpressions) an optional<int64_t> value.
+    // nullopt        ==> The expression is currently marked as non-constant
+    // int64_t value  ==> The expression is currently marked as constant with the specified integer value
+    std::vector<std::optional<int64_t>> exprvalues{};
 
     // For all identifiers (parameters and variables), if they are currently marked as constant,
     // stores their current values in order of the index that was given to the identifiers during the sem. analysis
     // [P1, P2, ... , V1, V2, ...]
     std::vector<std::optional<int64_t>> vartable{};
 
+    std::vector<std::optional<int64_t>> parameters{};          // The known values of the parameters
+
     bool firstRun{true};        // The optimisation is done in two runs over the nodes. This flag specifies for the visit methods, which run should be performed
 
 };
@@ -15,6 +15,7 @@ void DeadCodeOpt::visit(AstStatementList& node) {
 
     assert(it <= node.statements.end());    // Return statement must exist
 
+    nofchanges += static_cast<size_t>(node.statements.end() - it);
     node.statements.erase(it, node.statements.end());
 }
 
@@ -18,6 +18,9 @@ class DeadCodeOpt : public OptimisePass {
     void visit(AstIdentifier&) override {};
     void visit(AstUnaryArithmeticExpression&) override {};
     void visit(AstBinaryArithmeticExpression&) override {};
+    void visit(AstCall&) override {};
+    void visit(AstIntrinsic&) override {};
+    void visit(AstConditional&) override {};
     void visit(AstReturn&) override {};
     void visit(AstAssignment&) override {};
     void visit(AstStatementList& node) override;
@@ -0,0 +1,170 @@
+#include "ForwardSubstitutionOpt.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace jit {
+
+namespace {
+
+// assignedIdentifier       Returns the index of the identifier on the left hand side of the given assignment
+size_t assignedIdentifier(AstStatement& statement) {
+
+    return static_cast<AstIdentifier&>(*static_cast<AstAssignment&>(statement).lhs).index;
+}
+
+// readIdentifiers          Returns the indices of the identifiers read by the given expression (may contain duplicates)
+vector<size_t> readIdentifiers(unique_ptr<AstArithmeticExpression>& expr) {
+
+    vector<size_t> result{};
+
+    forEachPostOrder(expr, [&result](unique_ptr<AstArithmeticExpression>& e) {
+        if (e->subtype == AstArithmeticExpression::Subtype::Identifier)
+            result.push_back(static_cast<AstIdentifier&>(*e).index);
+    });
+
+    return result;
+}
+
+} // namespace
+
+void ForwardSubstitutionOpt::countUses(AstStatementList& node) {
+
+    current.assign(nofidentifiers, nullopt);
+
+    for (size_t s = 0; s < node.statements.size(); ++s) {
+
+        forEachExpression(*node.statements[s], [this](unique_ptr<AstArithmeticExpression>& expr) {
+            for (size_t index : readIdentifiers(expr))
+                if (current[index])
+                    ++definitions[*current[index]].uses;
+        });
+
+        if (node.statements[s]->subtype == AstStatement::SubType::AstReturn)
+            break;
+
+        current[assignedIdentifier(*node.statements[s])] = s;
+    }
+}
+
+void ForwardSubstitutionOpt::forward(unique_ptr<AstArithmeticExpression>& expr, bool divisor) {
+
+    if (expr->subtype != AstArithmeticExpression::Subtype::Identifier)
+        return;
+
+    optional<size_t> def = current[static_cast<AstIdentifier&>(*expr).index];
+
+    if (!def || !definitions[*def].forwardable)
+        return;
+
+    unique_ptr<AstArithmeticExpression>& rhs = static_cast<AstAssignment&>(*statements[*def]).rhs;
+
+    // Literals and identifiers are copied, the copies keep the location of the replaced use (errors of a division refer to the divisor)
+    if (rhs->subtype == AstArithmeticExpression::Subtype::Literal)
+        expr = make_unique<AstLiteral>(expr->location, static_cast<AstLiteral&>(*rhs).value);
+    else if (rhs->subtype == AstArithmeticExpression::Subtype::Identifier)
+        expr = make_unique<AstIdentifier>(expr->location, static_cast<AstIdentifier&>(*rhs).index);
+    else {
+
+        // Other expressions are used only once and are moved. They do not replace divisors, as errors would refer to another location
+        if (divisor)
+            return;
+
+        expr = move(rhs);
+        definitions[*def].forwardable = false;
+    }
+
+    --definitions[*def].uses;
+    ++nofchanges;
+}
+
+void ForwardSubstitutionOpt::substitute(unique_ptr<AstArithmeticExpression>& expr) {
+
+    // Replace the subexpressions of each node, so that it is known, whether they are divisors
+    forEachPostOrder(expr, [this](unique_ptr<AstArithmeticExpression>& e) {
+
+        if (e->subtype == AstArithmeticExpression::Subtype::Binary) {
+
+            auto& binexpr = static_cast<AstBinaryArithmeticExpression&>(*e);
+            forward(binexpr.lhs, false);
+            forward(binexpr.rhs, binexpr.op == AstBinaryArithmeticExpression::ArithmeticOperation::Div);
+        }
+        else if (e->subtype == AstArithmeticExpression::Subtype::Unary)
+            forward(static_cast<AstUnaryArithmeticExpression&>(*e).subexpr, false);
+        else if (auto* operands = operandsOf(*e))
+            for (auto& operand : *operands)
+                forward(operand, false);
+    });
+
+    forward(expr, false);
+}
+
+void ForwardSubstitutionOpt::visit(AstStatementList& node) {
+
+    statements.clear();
+    for (auto& st : node.statements)
+        statements.push_back(st.get());
+
+    definitions.assign(statements.size(), Definition{});
+    readers.assign(nofidentifiers, {});
+
+    // First run: Count the uses of the definitions
+    countUses(node);
+
+    // Second run: Replace the uses in order of the statements
+    current.assign(nofidentifiers, nullopt);
+
+    for (size_t s = 0; s < statements.size(); ++s) {
+
+        if (statements[s]->subtype == AstStatement::SubType::AstReturn) {
+            forEachExpression(*statements[s], [this](unique_ptr<AstArithmeticExpression>& value) { substitute(value); });
+            break;
+        }
+
+        unique_ptr<AstArithmeticExpression>& expr = static_cast<AstAssignment&>(*statements[s]).rhs;
+
+        substitute(expr);
+
+        size_t identifier = assignedIdentifier(*statements[s]);
+
+        // The definitions reading the assigned identifier must not be moved behind this assignment
+        for (size_t r : readers[identifier])
+            definitions[r].forwardable = false;
+        readers[identifier].clear();
+
+        Definition& def = definitions[s];
+        vector<size_t> reads = readIdentifiers(expr);
+
+        def.mayFail = mayFail(expr);
+
+        bool copy = expr->subtype == AstArithmeticExpression::Subtype::Literal || expr->subtype == AstArithmeticExpression::Subtype::Identifier;
+        def.forwardable = (copy || (def.uses == 1 && !def.mayFail)) && find(reads.begin(), reads.end(), identifier) == reads.end();
+
+        for (size_t index : reads)
+            readers[index].push_back(s);
+
+        current[identifier] = s;
+    }
+
+    // Remove the assignments, whose uses have all been replaced (or that are not used at all)
+    vector<unique_ptr<AstStatement>> kept{};
+
+    for (size_t s = 0; s < node.statements.size(); ++s)
+        if (node.statements[s]->subtype == AstStatement::SubType::AstReturn || definitions[s].uses != 0 || definitions[s].mayFail)
+            kept.push_back(move(node.statements[s]));
+
+    nofchanges += node.statements.size() - kept.size();
+    node.statements = move(kept);
+    statements.clear();
+}
+
+void ForwardSubstitutionOpt::visit(AstFunction& node) {
+
+    nofidentifiers = node.nofidentifiers;
+
+    node.statementlist->optimise(*this);
+
+}
+
+} // namespace jit
@@ -0,0 +1,66 @@
+#ifndef PLJIT_FORWARDSUBSTITUTIONOPT_H
+#define PLJIT_FORWARDSUBSTITUTIONOPT_H
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "OptimisePass.h"
+#include "AstNode.h"
+
+namespace jit {
+
+// ForwardSubstitutionOpt               Performs a Copy-Propagation and Forward-Substitution optimisation on an Ast:
+//                                      The right hand side of an assignment replaces the uses of its variable, if it is a literal or an identifier (copy), or if it is
+//                                      used only once. Assignments, whose uses have all been replaced, are removed. Expressions that may fail (i.e. that contain a division
+//                                      by a non-literal) are never moved, so that division-by-zero errors are reported as before
+class ForwardSubstitutionOpt : public OptimisePass {
+
+    public:
+
+    // Constructor
+    ForwardSubstitutionOpt() = default;
+
+    // The visit methods to support the visitor pattern
+    void visit(AstLiteral&) override {};
+    void visit(AstIdentifier&) override {};
+    void visit(AstUnaryArithmeticExpression&) override {};
+    void visit(AstBinaryArithmeticExpression&) override {};
+    void visit(AstCall&) override {};
+    void visit(AstIntrinsic&) override {};
+    void visit(AstConditional&) override {};
+    void visit(AstReturn&) override {};
+    void visit(AstAssignment&) override {};
+    void visit(AstStatementList& node) override;
+    void visit(AstFunction& node) override;
+
+    private:
+
+    // Definition               An assignment to a variable
+    struct Definition {
+        size_t uses{0};                 // The number of uses of the assigned value, that have not been replaced
+        bool mayFail{false};            // Specifies, whether the right hand side may fail (contains a division by a non-literal)
+        bool forwardable{false};        // Specifies, whether the right hand side may currently replace the uses of the variable
+    };
+
+    // countUses                Counts the uses of each definition (first run)
+    void countUses(AstStatementList& node);
+
+    // substitute               Replaces the uses of forwardable definitions in the given expression
+    void substitute(std::unique_ptr<AstArithmeticExpression>& expr);
+
+    // forward                  Replaces the given expression by the right hand side of its definition, if it is an identifier with a forwardable definition.
+    //                          'divisor' specifies, whether the expression is the divisor of a division
+    void forward(std::unique_ptr<AstArithmeticExpression>& expr, bool divisor);
+
+    std::vector<AstStatement*> statements{};                    // The statements of the function
+    std::vector<Definition> definitions{};                      // The definitions, in order of the statements (unused for return statements)
+    std::vector<std::optional<size_t>> current{};               // For all identifiers, the statement index of their current definition, if any
+    std::vector<std::vector<size_t>> readers{};                 // For all identifiers, the statement indices of the definitions reading the identifier
+    size_t nofidentifiers{0};                                   // The number of identifiers (parameters and variables) of the function
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_FORWARDSUBSTITUTIONOPT_H
@@ -0,0 +1,267 @@
+#include "InliningOpt.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace jit {
+
+namespace {
+
+// countExpressions         Returns the number of expressions of the given expression tree, but stops counting when the given limit is exceeded
+size_t countExpressions(const AstArithmeticExpression& expr, size_t limit) {
+
+    vector<const AstArithmeticExpression*> stack{&expr};
+    size_t count = 0;
+
+    while (!stack.empty() && count <= limit) {
+
+        const AstArithmeticExpression* node = stack.back();
+        stack.pop_back();
+        ++count;
+
+        if (node->subtype == AstArithmeticExpression::Subtype::Binary) {
+            stack.push_back(static_cast<const AstBinaryArithmeticExpression&>(*node).lhs.get());
+            stack.push_back(static_cast<const AstBinaryArithmeticExpression&>(*node).rhs.get());
+        }
+        else if (node->subtype == AstArithmeticExpression::Subtype::Unary)
+            stack.push_back(static_cast<const AstUnaryArithmeticExpression&>(*node).subexpr.get());
+        else if (const auto* operands = operandsOf(*node))
+            for (const auto& operand : *operands)
+                stack.push_back(operand.get());
+    }
+
+    return count;
+}
+
+// guardedCalls             Returns the calls within the alternatives of the conditional expressions of the given expression tree. They are only evaluated, if their
+//                          alternative is selected, so they must not be inlined: the statements of the called function would be executed in any case
+vector<const AstArithmeticExpression*> guardedCalls(const AstArithmeticExpression& expr) {
+
+    // Pairs of a node and a flag that indicates, whether the node is part of an alternative
+    vector<pair<const AstArithmeticExpression*, bool>> stack{{&expr, false}};
+    vector<const AstArithmeticExpression*> calls{};
+
+    while (!stack.empty()) {
+
+        auto [node, guarded] = stack.back();
+        stack.pop_back();
+
+        if (node->subtype == AstArithmeticExpression::Subtype::Call && guarded)
+            calls.push_back(node);
+
+        if (node->subtype == AstArithmeticExpression::Subtype::Binary) {
+            stack.emplace_back(static_cast<const AstBinaryArithmeticExpression&>(*node).lhs.get(), guarded);
+            stack.emplace_back(static_cast<const AstBinaryArithmeticExpression&>(*node).rhs.get(), guarded);
+        }
+        else if (node->subtype == AstArithmeticExpression::Subtype::Unary)
+            stack.emplace_back(static_cast<const AstUnaryArithmeticExpression&>(*node).subexpr.get(), guarded);
+        else if (const auto* operands = operandsOf(*node))
+            for (size_t i = 0; i < operands->size(); ++i)
+                stack.emplace_back((*operands)[i].get(), guarded || (node->subtype == AstArithmeticExpression::Subtype::Conditional && i >= AstConditional::thenIndex));
+    }
+
+    return calls;
+}
+
+// copyExpression           Returns a copy of the given expression tree, whose nodes refer to the given location. The identifiers are renamed to the given indices.
+//                          Works with an explicit stack instead of recursion
+unique_ptr<AstArithmeticExpression> copyExpression(const AstArithmeticExpression& expr, SourceCodeReference location, const vector<size_t>& renamed) {
+
+    // Pairs of a node and a flag that indicates, whether the subexpressions of the node have already been copied
+    vector<pair<const AstArithmeticExpression*, bool>> nodestack{{&expr, false}};
+    vector<unique_ptr<AstArithmeticExpression>> copies{};
+
+    while (!nodestack.empty()) {
+
+        auto [node, expanded] = nodestack.back();
+
+        switch (node->subtype) {
+
+            case AstArithmeticExpression::Subtype::Literal:
+                nodestack.pop_back();
+                copies.push_back(make_unique<AstLiteral>(location, static_cast<const AstLiteral&>(*node).value));
+                break;
+
+            case AstArithmeticExpression::Subtype::Identifier:
+                nodestack.pop_back();
+                copies.push_back(make_unique<AstIdentifier>(location, renamed[static_cast<const AstIdentifier&>(*node).index]));
+                break;
+
+            case AstArithmeticExpression::Subtype::Unary:
+                if (!expanded) {
+                    nodestack.back().second = true;
+                    nodestack.emplace_back(static_cast<const AstUnaryArithmeticExpression&>(*node).subexpr.get(), false);
+                }
+                else {
+                    nodestack.pop_back();
+                    copies.back() = make_unique<AstUnaryArithmeticExpression>(location, move(copies.back()));
+                }
+                break;
+
+            case AstArithmeticExpression::Subtype::Binary: {
+
+                const auto& binexpr = static_cast<const AstBinaryArithmeticExpression&>(*node);
+
+                if (!expanded) {
+                    nodestack.back().second = true;
+                    nodestack.emplace_back(binexpr.rhs.get(), false);
+                    nodestack.emplace_back(binexpr.lhs.get(), false);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                auto rhs = move(copies.back());
+                copies.pop_back();
+                copies.back() = make_unique<AstBinaryArithmeticExpression>(location, move(copies.back()), move(rhs), binexpr.op);
+                break;
+            }
+
+            case AstArithmeticExpression::Subtype::Call:
+            case AstArithmeticExpression::Subtype::Intrinsic:
+            case AstArithmeticExpression::Subtype::Conditional: {
+
+                const auto& operands = *operandsOf(*node);
+
+                if (!expanded) {
+                    nodestack.back().second = true;
+                    for (auto it = operands.rbegin(); it != operands.rend(); ++it)
+                        nodestack.emplace_back(it->get(), false);
+                    break;
+                }
+
+                nodestack.pop_back();
+
+                vector<unique_ptr<AstArithmeticExpression>> copiedoperands{};
+                for (auto it = copies.end() - static_cast<ptrdiff_t>(operands.size()); it != copies.end(); ++it)
+                    copiedoperands.push_back(move(*it));
+
+                copies.resize(copies.size() - operands.size());
+
+                if (node->subtype == AstArithmeticExpression::Subtype::Call)
+                    copies.push_back(make_unique<AstCall>(location, static_cast<const AstCall&>(*node).callee, move(copiedoperands)));
+                else if (node->subtype == AstArithmeticExpression::Subtype::Intrinsic)
+                    copies.push_back(make_unique<AstIntrinsic>(location, static_cast<const AstIntrinsic&>(*node).function, move(copiedoperands)));
+                else
+                    copies.push_back(make_unique<AstConditional>(location, static_cast<const AstConditional&>(*node).comparison, move(copiedoperands)));
+                break;
+            }
+        }
+    }
+
+    return move(copies.back());
+}
+
+} // namespace
+
+
+bool InliningOpt::isSmall(const AstFunction& callee) {
+
+    auto [it, inserted] = small.emplace(&callee, false);
+
+    if (!inserted)
+        return it->second;
+
+    size_t size = 0;
+
+    for (const auto& statement : callee.statementlist->statements) {
+
+        forEachExpression(*statement, [this, &size](unique_ptr<AstArithmeticExpression>& expr) { size += countExpressions(*expr, maxSize); });
+
+        if (size > maxSize || statement->subtype == AstStatement::SubType::AstReturn)
+            break;
+    }
+
+    it->second = size <= maxSize;
+
+    return it->second;
+}
+
+unique_ptr<AstArithmeticExpression> InliningOpt::inlineCall(AstCall& call, vector<unique_ptr<AstStatement>>& statements) {
+
+    const AstFunction& callee = *call.callee.function;
+    SourceCodeReference location = call.location;
+
+    // The parameters and variables of the called function become new variables of the optimised function
+    vector<size_t> renamed(callee.nofidentifiers);
+
+    for (size_t i = 0; i < callee.nofidentifiers; ++i)
+        renamed[i] = function->nofidentifiers + i;
+
+    function->nofidentifiers += callee.nofidentifiers;
+    function->nofvariables += callee.nofidentifiers;
+
+    // The arguments are evaluated once, before the statements of the called function
+    for (size_t i = 0; i < call.arguments.size(); ++i)
+        statements.push_back(make_unique<AstAssignment>(location, make_unique<AstIdentifier>(location, renamed[i]), move(call.arguments[i])));
+
+    for (const auto& statement : callee.statementlist->statements) {
+
+        // Called functions return a single value (see SemanticAnalyser::analyseCall)
+        if (statement->subtype == AstStatement::SubType::AstReturn)
+            return copyExpression(*static_cast<const AstReturn&>(*statement).returnvalues.front(), location, renamed);
+
+        const auto& assignment = static_cast<const AstAssignment&>(*statement);
+        size_t index = renamed[static_cast<const AstIdentifier&>(*assignment.lhs).index];
+
+        statements.push_back(make_unique<AstAssignment>(location, make_unique<AstIdentifier>(location, index), copyExpression(*assignment.rhs, location, renamed)));
+    }
+
+    // A function without return statement returns 0 (this cannot happen for functions that passed the semantic analysis)
+    return make_unique<AstLiteral>(location, 0);
+}
+
+void InliningOpt::visit(AstStatementList& node) {
+
+    vector<unique_ptr<AstStatement>> statements{};
+
+    for (auto& statement : node.statements) {
+
+        // Specifies, whether the part of the statement evaluated so far may fail
+        bool failed = false;
+
+        // The calls are inlined bottom-up (i.e. in order of evaluation), so that calls in the arguments of a call are computed before its statements
+        forEachExpression(*statement, [this, &statements, &failed](unique_ptr<AstArithmeticExpression>& expr) {
+
+            vector<const AstArithmeticExpression*> guarded = guardedCalls(*expr);
+
+            forEachPostOrder(expr, [this, &statements, &failed, &guarded](unique_ptr<AstArithmeticExpression>& e) {
+
+                if (e->subtype == AstArithmeticExpression::Subtype::Call && find(guarded.begin(), guarded.end(), e.get()) == guarded.end()) {
+
+                    auto& call = static_cast<AstCall&>(*e);
+
+                    // The arguments and the statements of the called function are moved in front of the statement. If they may fail, the errors must not overtake
+                    // the ones of the part evaluated before the call, otherwise the call is left to the IrBuilder
+                    bool moved = nodeMayFail(call) || any_of(call.arguments.begin(), call.arguments.end(), [](auto& argument) { return mayFail(argument); });
+
+                    if (isSmall(*call.callee.function) && !(failed && moved)) {
+
+                        e = inlineCall(call, statements);
+                        failed |= moved || mayFail(e);
+                        ++nofchanges;
+                        return;
+                    }
+                }
+
+                failed |= nodeMayFail(*e);
+            });
+        });
+
+        statements.push_back(move(statement));
+    }
+
+    node.statements = move(statements);
+}
+
+void InliningOpt::visit(AstFunction& node) {
+
+    function = &node;
+
+    node.statementlist->optimise(*this);
+
+    function = nullptr;
+}
+
+} // namespace jit
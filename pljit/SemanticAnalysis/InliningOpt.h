@@ -0,0 +1,58 @@
+#ifndef PLJIT_INLININGOPT_H
+#define PLJIT_INLININGOPT_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "OptimisePass.h"
+#include "AstNode.h"
+
+namespace jit {
+
+// InliningOpt                          Replaces the calls of small functions by their statements: The arguments are assigned to new variables, the statements of the called
+//                                      function are copied in front of the statement containing the call (its parameters and variables become the new variables) and the call
+//                                      is replaced by a copy of the returned expression. Thereby the constant propagation and the forward substitution work across calls.
+//                                      The copies refer to the location of the call, so errors are reported in the source code of the calling function.
+//                                      Calls of larger functions remain, they are inlined into the intermediate representation (see IrBuilder). So do calls that may fail,
+//                                      if a part of the statement evaluated before them may fail as well, as the errors have to be reported in the order of evaluation
+class InliningOpt : public OptimisePass {
+
+    public:
+
+    static constexpr size_t defaultMaxSize = 64;       // Default for the maximal number of expressions of an inlined function
+
+    // Constructor              Functions with more than 'maxSize' expressions are not inlined
+    explicit InliningOpt(size_t maxSize = defaultMaxSize) : maxSize{maxSize} {}
+
+    // The visit methods to support the visitor pattern
+    void visit(AstLiteral&) override {};
+    void visit(AstIdentifier&) override {};
+    void visit(AstUnaryArithmeticExpression&) override {};
+    void visit(AstBinaryArithmeticExpression&) override {};
+    void visit(AstCall&) override {};
+    void visit(AstIntrinsic&) override {};
+    void visit(AstConditional&) override {};
+    void visit(AstReturn&) override {};
+    void visit(AstAssignment&) override {};
+    void visit(AstStatementList& node) override;
+    void visit(AstFunction& node) override;
+
+    private:
+
+    // inlineCall               Appends the statements of the called function (with its arguments assigned to its parameters) to 'statements' and returns the expression
+    //                          replacing the call
+    std::unique_ptr<AstArithmeticExpression> inlineCall(AstCall& call, std::vector<std::unique_ptr<AstStatement>>& statements);
+
+    // isSmall                  Returns whether the given function has at most maxSize expressions
+    bool isSmall(const AstFunction& callee);
+
+    const size_t maxSize;                                       // The maximal number of expressions of an inlined function
+    AstFunction* function{nullptr};                             // The function that is optimised (the new variables are added to it)
+    std::unordered_map<const AstFunction*, bool> small{};       // Whether the called functions are small enough to be inlined
+
+};
+
+} // namespace jit
+
+#endif //PLJIT_INLININGOPT_H
@@ -1,6 +1,8 @@
 #ifndef PLJIT_OPTIMISEPASS_H
 #define PLJIT_OPTIMISEPASS_H
 
+#include <cstddef>
+
 namespace jit {
 
 class AstNode;
@@ -8,6 +10,9 @@ class AstLiteral;
 class AstIdentifier;
 class AstUnaryArithmeticExpression;
 class AstBinaryArithmeticExpression;
+class AstCall;
+class AstIntrinsic;
+class AstConditional;
 class AstReturn;
 class AstAssignment;
 class AstStatementList;
@@ -18,15 +23,27 @@ class OptimisePass {
 
     public:
 
+    // Destructor
+    virtual ~OptimisePass() = default;
+
     virtual void visit(AstLiteral& node) = 0;
     virtual void visit(AstIdentifier& node) = 0;
     virtual void visit(AstUnaryArithmeticExpression& node) = 0;
     virtual void visit(AstBinaryArithmeticExpression& node) = 0;
+    virtual void visit(AstCall& node) = 0;
+    virtual void visit(AstIntrinsic& node) = 0;
+    virtual void visit(AstConditional& node) = 0;
     virtual void visit(AstReturn& node) = 0;
     virtual void visit(AstAssignment& node) = 0;
     virtual void visit(AstStatementList& node) = 0;
     virtual void visit(AstFunction& node) = 0;
 
+    // getNofChanges            Returns the number of nodes that have been replaced or removed by the pass so far
+    size_t getNofChanges() const { return nofchanges; }
+
+    protected:
+
+    size_t nofchanges{0};       // The number of nodes that have been replaced or removed so far
 
 };
 
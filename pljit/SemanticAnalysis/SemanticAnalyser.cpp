@@ -1,12 +1,25 @@
 #include "SemanticAnalyser.h"
 
-#include <map>
 
 using namespace std;
 
 namespace jit{
 
 
+size_t SemanticAnalyser::insertName(size_t id, size_t index) {
+
+    if (id >= nametable.size())
+        nametable.resize(id + 1, undeclared);
+
+    if (nametable[id] != undeclared)
+        return nametable[id];
+
+    nametable[id] = index;
+
+    return undeclared;
+}
+
+
 bool SemanticAnalyser::createTable() {
 
     table = SymbolTable{};
@@ -31,13 +44,13 @@ bool SemanticAnalyser::createTable() {
             const IdentifierNode& identifier = static_cast<IdentifierNode&>(*decllist.nodes[i]);
 
             // Try to insert the name of the identifier into the nametable
-            auto res = nametable.insert(pair<string_view, size_t>(manager.getString(identifier.location), nofidentifiers));
+            size_t previous = insertName(identifier.id, nofidentifiers);
 
             // Check, if identifier already exists
-            if (!res.second)
+            if (previous != undeclared)
             {
                 manager.printErrorMessage("error: Parameter already declared ...", identifier.location);
-                manager.printErrorMessage("... first declared here", table.table[res.first->second].declaration);
+                manager.printErrorMessage("... first declared here", table.getDeclaration(previous));
                 return false;
             }
 
@@ -62,13 +75,13 @@ bool SemanticAnalyser::createTable() {
             const IdentifierNode& identifier = static_cast<IdentifierNode&>(*decllist.nodes[i]);
 
             // Try to insert the name of the identifier into the nametable
-            auto res = nametable.insert(pair<string_view, size_t>(manager.getString(identifier.location), nofidentifiers));
+            size_t previous = insertName(identifier.id, nofidentifiers);
 
             // Check, if identifier already exists
-            if (!res.second)
+            if (previous != undeclared)
             {
                 manager.printErrorMessage("error: Variable already declared ...", identifier.location);
-                manager.printErrorMessage("... first declared here", table.table[res.first->second].declaration);
+                manager.printErrorMessage("... first declared here", table.getDeclaration(previous));
                 return false;
             }
 
@@ -95,13 +108,13 @@ bool SemanticAnalyser::createTable() {
             const LiteralNode& literal = static_cast<LiteralNode&>(*decl.nodes[2]);
 
             // Try to insert the name of the identifier into the nametable
-            auto res = nametable.insert(pair<string_view, size_t>(manager.getString(identifier.location), nofidentifiers));
+            size_t previous = insertName(identifier.id, nofidentifiers);
 
             // Check, if identifier already exists
-            if (!res.second)
+            if (previous != undeclared)
             {
                 manager.printErrorMessage("error: Constant already declared ...", identifier.location);
-                manager.printErrorMessage("... first declared here", table.table[res.first->second].declaration);
+                manager.printErrorMessage("... first declared here", table.getDeclaration(previous));
                 return false;
             }
 
@@ -120,15 +133,13 @@ bool SemanticAnalyser::createTable() {
 
 unique_ptr<AstArithmeticExpression> SemanticAnalyser::analyseIdentifier(const IdentifierNode& id, bool lhs) {
 
-    auto res = nametable.find(manager.getString(id.location));
+    size_t index = id.id < nametable.size() ? nametable[id.id] : undeclared;
 
-    if (res == nametable.end()) {
+    if (index == undeclared) {
         manager.printErrorMessage("error: undeclared identifier", id.location);
         return nullptr;
     }
 
-    size_t index = res->second;
-
     // If identifier appears on the left hand side, check if it is non-constant
     if (lhs && table.isConst(index)) {
 
@@ -152,106 +163,252 @@ unique_ptr<AstArithmeticExpression> SemanticAnalyser::analyseIdentifier(const Id
 
 unique_ptr<AstArithmeticExpression> SemanticAnalyser::analyseExpression(const ParseTreeNode& expression) {
 
-    switch(expression.nodetype) {
+    /*
+     * The parse tree is traversed with an explicit stack instead of recursion, so that long expressions cannot exhaust the call stack.
+     * Every stack entry consists of a parse tree node and a flag indicating whether the subexpressions of the node have already been analysed. The resulting Ast nodes
+     * are collected on a second stack, from which the binary and unary expressions take their operands.
+     */
+    vector<pair<const ParseTreeNode*, bool>> stack{{&expression, false}};
+    vector<unique_ptr<AstArithmeticExpression>> results{};
 
-        case ParseTreeNode::Type::Literal:
-            return make_unique<AstLiteral>(expression.location, static_cast<const LiteralNode&>(expression).value);
+    while (!stack.empty()) {
 
-        case ParseTreeNode::Type::Identifier:
-            return analyseIdentifier(static_cast<const IdentifierNode&>(expression),false);
+        auto [node, expanded] = stack.back();
 
-        case ParseTreeNode::Type::PrimaryExpr: {
+        switch(node->nodetype) {
 
-            const auto& primexpr = static_cast<const PrimaryExprNode&>(expression);
+            case ParseTreeNode::Type::Literal:
+                stack.pop_back();
+                results.push_back(make_unique<AstLiteral>(node->location, static_cast<const LiteralNode&>(*node).value));
+                break;
 
-            // Literal
-            if (primexpr.subtype == PrimaryExprNode::SubType::Literal)
-                return make_unique<AstLiteral>(primexpr.location, static_cast<const LiteralNode&>(*primexpr.nodes[0]).value);
-            // Identifier
-            else if (primexpr.subtype == PrimaryExprNode::SubType::Identifier)
-                return analyseIdentifier(static_cast<const IdentifierNode&>(*primexpr.nodes[0]), false);
-            // Arithmetic expression in parentheses
-            else
-                return analyseExpression(*primexpr.nodes[1]);
-        }
-        case ParseTreeNode::Type::UnaryExpr: {
+            case ParseTreeNode::Type::Identifier: {
 
-            auto& unaryexpr = static_cast<const UnaryExprNode&>(expression);
+                stack.pop_back();
 
-            if (unaryexpr.subtype == UnaryExprNode::SubType::Plus)
-                return analyseExpression(*unaryexpr.nodes[1]);
-            else if (unaryexpr.subtype == UnaryExprNode::SubType::NoSign)
-                return analyseExpression(*unaryexpr.nodes[0]);
-            else {
-                auto subexpr = analyseExpression(*unaryexpr.nodes[1]);
-                if (!subexpr)
+                auto id = analyseIdentifier(static_cast<const IdentifierNode&>(*node), false);
+                if (!id)
                     return nullptr;
 
-                return make_unique<AstUnaryArithmeticExpression>(unaryexpr.location, move(subexpr));
+                results.push_back(move(id));
+                break;
             }
-        }
-        case ParseTreeNode::Type::MultExpr: {
+            case ParseTreeNode::Type::PrimaryExpr: {
+
+                const auto& primexpr = static_cast<const PrimaryExprNode&>(*node);
+
+                // Literal
+                if (primexpr.subtype == PrimaryExprNode::SubType::Literal) {
+                    stack.pop_back();
+                    results.push_back(make_unique<AstLiteral>(primexpr.location, static_cast<const LiteralNode&>(*primexpr.nodes[0]).value));
+                }
+                // Identifier
+                else if (primexpr.subtype == PrimaryExprNode::SubType::Identifier)
+                    stack.back() = {primexpr.nodes[0].get(), false};
+                // Arithmetic expression in parentheses
+                else if (primexpr.subtype == PrimaryExprNode::SubType::AdditiveExpr)
+                    stack.back() = {primexpr.nodes[1].get(), false};
+                // Call, intrinsic or conditional expression, the operands are every second node starting at 'first' (skip all ',' resp. the keywords)
+                else {
+                    size_t first = primexpr.subtype == PrimaryExprNode::SubType::Call ? 3 : (primexpr.subtype == PrimaryExprNode::SubType::Intrinsic ? 2 : 1);
+                    size_t end = primexpr.subtype == PrimaryExprNode::SubType::Conditional ? primexpr.nodes.size() : primexpr.nodes.size() - 1;
+                    size_t nofoperands = (end - first + 1) / 2;
+
+                    if (!expanded) {
+                        stack.back().second = true;
+                        for (size_t i = first + 2 * nofoperands; i > first; i -= 2)
+                            stack.emplace_back(primexpr.nodes[i - 2].get(), false);
+                        break;
+                    }
+
+                    stack.pop_back();
+
+                    vector<unique_ptr<AstArithmeticExpression>> operands{};
+
+                    for (auto it = results.end() - static_cast<ptrdiff_t>(nofoperands); it != results.end(); ++it)
+                        operands.push_back(move(*it));
+
+                    results.resize(results.size() - nofoperands);
+
+                    unique_ptr<AstArithmeticExpression> expr{};
+
+                    if (primexpr.subtype == PrimaryExprNode::SubType::Call)
+                        expr = analyseCall(primexpr, move(operands));
+                    else if (primexpr.subtype == PrimaryExprNode::SubType::Intrinsic)
+                        expr = analyseIntrinsic(primexpr, move(operands));
+                    else
+                        expr = analyseConditional(primexpr, move(operands));
+
+                    if (!expr)
+                        return nullptr;
+
+                    results.push_back(move(expr));
+                }
+
+                break;
+            }
+            case ParseTreeNode::Type::UnaryExpr: {
+
+                const auto& unaryexpr = static_cast<const UnaryExprNode&>(*node);
+
+                if (unaryexpr.subtype == UnaryExprNode::SubType::Plus)
+                    stack.back() = {unaryexpr.nodes[1].get(), false};
+                else if (unaryexpr.subtype == UnaryExprNode::SubType::NoSign)
+                    stack.back() = {unaryexpr.nodes[0].get(), false};
+                else if (!expanded) {
+                    stack.back().second = true;
+                    stack.emplace_back(unaryexpr.nodes[1].get(), false);
+                }
+                else {
+                    stack.pop_back();
+                    results.back() = make_unique<AstUnaryArithmeticExpression>(unaryexpr.location, move(results.back()));
+                }
+                break;
+            }
+            case ParseTreeNode::Type::MultExpr:
+            case ParseTreeNode::Type::AdditiveExpr: {
 
-            auto& multexpr = static_cast<const MultExprNode&>(expression);
+                const auto& binexpr = static_cast<const NonTerminalTreeNode&>(*node);
 
-            if (multexpr.subtype == MultExprNode::SubType::Unary)
-                return analyseExpression(*multexpr.nodes[0]);
-            else {
-                auto lhs = analyseExpression(*multexpr.nodes[0]);
-                if (!lhs)
-                    return nullptr;
+                bool isUnary = node->nodetype == ParseTreeNode::Type::MultExpr ? static_cast<const MultExprNode&>(*node).subtype == MultExprNode::SubType::Unary
+                                                                               : static_cast<const AdditiveExprNode&>(*node).subtype == AdditiveExprNode::SubType::Unary;
 
-                auto rhs = analyseExpression(*multexpr.nodes[2]);
-                if (!rhs)
-                    return nullptr;
+                if (isUnary) {
+                    stack.back() = {binexpr.nodes[0].get(), false};
+                    break;
+                }
+
+                if (!expanded) {
+                    // Push the right subexpression first, so that the left one is analysed first
+                    stack.back().second = true;
+                    stack.emplace_back(binexpr.nodes[2].get(), false);
+                    stack.emplace_back(binexpr.nodes[0].get(), false);
+                    break;
+                }
 
-                auto op = static_cast<GenericTerminalNode&>(*multexpr.nodes[1]).subtype;
+                stack.pop_back();
 
-                assert(op == GenericTerminalNode::SubType::Mul || op == GenericTerminalNode::SubType::Div);
+                auto rhs = move(results.back());
+                results.pop_back();
+                auto lhs = move(results.back());
+                results.pop_back();
 
-                auto astop = AstBinaryArithmeticExpression::ArithmeticOperation::Mul;
+                auto op = static_cast<GenericTerminalNode&>(*binexpr.nodes[1]).subtype;
 
-                if (op == GenericTerminalNode::SubType::Div)
-                    astop = AstBinaryArithmeticExpression::ArithmeticOperation::Div;
+                auto astop = AstBinaryArithmeticExpression::ArithmeticOperation::Plus;
 
-                return make_unique<AstBinaryArithmeticExpression>(multexpr.location, move(lhs), move(rhs), astop);
+                switch (op) {
+                    case GenericTerminalNode::SubType::Plus:
+                        astop = AstBinaryArithmeticExpression::ArithmeticOperation::Plus;
+                        break;
+                    case GenericTerminalNode::SubType::Minus:
+                        astop = AstBinaryArithmeticExpression::ArithmeticOperation::Minus;
+                        break;
+                    case GenericTerminalNode::SubType::Mul:
+                        astop = AstBinaryArithmeticExpression::ArithmeticOperation::Mul;
+                        break;
+                    case GenericTerminalNode::SubType::Div:
+                        astop = AstBinaryArithmeticExpression::ArithmeticOperation::Div;
+                        break;
+                    default:
+                        assert(false);
+                }
+
+                results.push_back(make_unique<AstBinaryArithmeticExpression>(binexpr.location, move(lhs), move(rhs), astop));
+                break;
             }
+            default:
+                cerr << "Compiler error\n";
+                exit(EXIT_FAILURE);
         }
-        case ParseTreeNode::Type::AdditiveExpr: {
+    }
 
-            auto& addexpr = static_cast<const AdditiveExprNode&>(expression);
+    assert(results.size() == 1);
 
-            if (addexpr.subtype == AdditiveExprNode::SubType::Unary)
-                return analyseExpression(*addexpr.nodes[0]);
-            else {
-                auto lhs = analyseExpression(*addexpr.nodes[0]);
-                if (!lhs)
-                    return nullptr;
+    return move(results.back());
+}
 
-                auto rhs = analyseExpression(*addexpr.nodes[2]);
-                if(!rhs)
-                    return nullptr;
 
+unique_ptr<AstArithmeticExpression> SemanticAnalyser::analyseCall(const PrimaryExprNode& call, vector<unique_ptr<AstArithmeticExpression>> arguments) {
 
-                auto op = static_cast<GenericTerminalNode&>(*addexpr.nodes[1]).subtype;
+    const IdentifierNode& name = static_cast<const IdentifierNode&>(*call.nodes[1]);
 
-                assert(op == GenericTerminalNode::SubType::Plus || op == GenericTerminalNode::SubType::Minus);
+    if (!resolver) {
+        manager.printErrorMessage("error: unknown function", name.location);
+        return nullptr;
+    }
 
-                auto astop = AstBinaryArithmeticExpression::ArithmeticOperation::Plus;
+    optional<AstCallee> callee = resolver(manager.getString(name.location), name.location);
 
-                if (op == GenericTerminalNode::SubType::Minus)
-                    astop = AstBinaryArithmeticExpression::ArithmeticOperation::Minus;
+    if (!callee)
+        return nullptr;
 
-                return make_unique<AstBinaryArithmeticExpression>(addexpr.location, move(lhs), move(rhs), astop);
-            }
-        }
+    // The value of a call is the only value returned by the called function
+    if (callee->function->nofresults != 1) {
+        manager.printErrorMessage("error: called function returns " + to_string(callee->function->nofresults) + " values, but a call has only one value",
+                                  call.location);
+        return nullptr;
+    }
+
+    if (callee->function->nofparameters != arguments.size()) {
+        manager.printErrorMessage("error: function expects " + to_string(callee->function->nofparameters) + " argument(s), but " + to_string(arguments.size()) +
+                                  " are given", call.location);
+        return nullptr;
+    }
+
+    return make_unique<AstCall>(call.location, *callee, move(arguments));
+}
+
+unique_ptr<AstArithmeticExpression> SemanticAnalyser::analyseIntrinsic(const PrimaryExprNode& intrinsic, vector<unique_ptr<AstArithmeticExpression>> arguments) {
+
+    auto function = AstIntrinsic::Function::Abs;
+
+    switch (static_cast<const GenericTerminalNode&>(*intrinsic.nodes[0]).subtype) {
+        case GenericTerminalNode::SubType::Min:
+            function = AstIntrinsic::Function::Min;
+            break;
+        case GenericTerminalNode::SubType::Max:
+            function = AstIntrinsic::Function::Max;
+            break;
         default:
-            cerr << "Compiler error\n";
-            exit(EXIT_FAILURE);
+            function = AstIntrinsic::Function::Abs;
+    }
+
+    if (AstIntrinsic::nofArguments(function) != arguments.size()) {
+        manager.printErrorMessage("error: function expects " + to_string(AstIntrinsic::nofArguments(function)) + " argument(s), but " + to_string(arguments.size()) +
+                                  " are given", intrinsic.location);
+        return nullptr;
     }
 
+    return make_unique<AstIntrinsic>(intrinsic.location, function, move(arguments));
 }
 
+unique_ptr<AstArithmeticExpression> SemanticAnalyser::analyseConditional(const PrimaryExprNode& conditional, vector<unique_ptr<AstArithmeticExpression>> operands) {
+
+    auto comparison = AstConditional::Comparison::Equal;
+
+    switch (static_cast<const GenericTerminalNode&>(*conditional.nodes[2]).subtype) {
+        case GenericTerminalNode::SubType::NotEqual:
+            comparison = AstConditional::Comparison::NotEqual;
+            break;
+        case GenericTerminalNode::SubType::Less:
+            comparison = AstConditional::Comparison::Less;
+            break;
+        case GenericTerminalNode::SubType::LessEqual:
+            comparison = AstConditional::Comparison::LessEqual;
+            break;
+        case GenericTerminalNode::SubType::Greater:
+            comparison = AstConditional::Comparison::Greater;
+            break;
+        case GenericTerminalNode::SubType::GreaterEqual:
+            comparison = AstConditional::Comparison::GreaterEqual;
+            break;
+        default:
+            comparison = AstConditional::Comparison::Equal;
+    }
+
+    return make_unique<AstConditional>(conditional.location, comparison, move(operands));
+}
 
 unique_ptr<AstStatement> SemanticAnalyser::analyseStatement(const Statement& statement) {
 
@@ -260,13 +417,20 @@ unique_ptr<AstStatement> SemanticAnalyser::analyseStatement(const Statement& sta
         return analyseAssignment(static_cast<const AssignExprNode&>(*statement.nodes[0]));
     else {
 
-        // analyse the additive expression of the return statement
-        auto addexpr = analyseExpression(*statement.nodes[1]);
+        // analyse the additive expressions of the returned values (the nodes in between are the separating commas)
+        vector<unique_ptr<AstArithmeticExpression>> returnvalues{};
 
-        if (!addexpr)
-            return nullptr;
+        for (size_t i = 1; i < statement.nodes.size(); i += 2) {
+
+            auto addexpr = analyseExpression(*statement.nodes[i]);
+
+            if (!addexpr)
+                return nullptr;
 
-        return make_unique<AstReturn>(statement.location, move(addexpr));
+            returnvalues.push_back(move(addexpr));
+        }
+
+        return make_unique<AstReturn>(statement.location, move(returnvalues));
     }
 }
 
@@ -292,7 +456,7 @@ unique_ptr<AstAssignment> SemanticAnalyser::analyseAssignment(const AssignExprNo
 
 
     // Update the symbol table (identifier on the left hand side is now initialised)
-    table.table[static_cast<AstIdentifier&>(*id).index].hasValue = true;
+    table.setHasValue(static_cast<AstIdentifier&>(*id).index);
 
 
     return make_unique<AstAssignment>(expr.location, move(id), move(addexpr));
@@ -306,6 +470,7 @@ unique_ptr<AstFunction> SemanticAnalyser::analyseFunction() {
         return nullptr;
 
     bool hasreturn{false};
+    size_t nofresults{0};
 
     // Vector to store the statements of the AstFunction object
     vector<unique_ptr<AstStatement>> aststatements{};
@@ -324,8 +489,11 @@ unique_ptr<AstFunction> SemanticAnalyser::analyseFunction() {
         if(!aststatement)
             return nullptr;
 
-        if (aststatement->subtype == AstStatement::SubType::AstReturn)
+        // The first return statement determines the returned values, the following statements are never executed
+        if (aststatement->subtype == AstStatement::SubType::AstReturn && !hasreturn) {
             hasreturn = true;
+            nofresults = static_cast<AstReturn&>(*aststatement).returnvalues.size();
+        }
 
 
         aststatements.push_back(move(aststatement));
@@ -341,7 +509,7 @@ unique_ptr<AstFunction> SemanticAnalyser::analyseFunction() {
 
 
     SourceCodeReference ref = SourceCodeReference{function.nodes.front()->location};
-    return make_unique<AstFunction>(ref, move(stlist), nofparameters, nofvariables);
+    return make_unique<AstFunction>(ref, move(stlist), nofparameters, nofvariables, nofresults);
 }
 
 } // namespace jit
\ No newline at end of file
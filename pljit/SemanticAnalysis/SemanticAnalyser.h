@@ -1,7 +1,11 @@
 #ifndef PLJIT_SEMANTICANALYSER_H
 #define PLJIT_SEMANTICANALYSER_H
 
-#include <map>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 #include "pljit/Parser/ParseTreeNode.h"
 #include "pljit/SemanticAnalysis/AstNode.h"
@@ -13,8 +17,13 @@ class SemanticAnalyser {
 
     public:
 
-    // Constructor
-    SemanticAnalyser(const SourceCodeManager& manager, const FuncDeclNode& function) : manager{manager}, function{function} {}
+    // CalleeResolver               Returns the function that is called with the given name at the given location. If there is none (or it cannot be called),
+    //                              prints an error and returns nullopt
+    using CalleeResolver = std::function<std::optional<AstCallee>(std::string_view name, SourceCodeReference location)>;
+
+    // Constructor                  Calls are resolved by the given resolver, without resolver every call is an error
+    SemanticAnalyser(const SourceCodeManager& manager, const FuncDeclNode& function, CalleeResolver resolver = nullptr) : manager{manager}, function{function},
+                                                                                                                          resolver{std::move(resolver)} {}
 
 
     // analyseFunction              Semantically analyses the parsed function and, if all is ok, returns an AstFunction object
@@ -26,10 +35,24 @@ class SemanticAnalyser {
     // createTable                  Creates the symbol table by inspecting the declarations of the parameters, variables and constants from the parse tree
     bool createTable();
 
-    // analyseExpression            Checks, if the expression is a valid arithmetic expression with valid identifiers by recursively checking its sub expressions.
-    //                              If successfull, returns an AstArithmeticExpression node.
+    // insertName                   Maps the interned name id to the given symbol index. If the name already is mapped to an index, returns that index without changing it,
+    //                              otherwise returns 'undeclared'
+    size_t insertName(size_t id, size_t index);
+
+    // analyseExpression            Checks, if the expression is a valid arithmetic expression with valid identifiers by checking all of its sub expressions.
+    //                              If successfull, returns an AstArithmeticExpression node. Works with an explicit stack instead of recursion
     std::unique_ptr<AstArithmeticExpression> analyseExpression(const ParseTreeNode& expression);
 
+    // analyseCall                  Resolves the function called by the given call expression and checks the number of the given (already analysed) arguments.
+    //                              If successfull, returns an AstCall node
+    std::unique_ptr<AstArithmeticExpression> analyseCall(const PrimaryExprNode& call, std::vector<std::unique_ptr<AstArithmeticExpression>> arguments);
+
+    // analyseIntrinsic             Checks the number of the given (already analysed) arguments of the given intrinsic. If successfull, returns an AstIntrinsic node
+    std::unique_ptr<AstArithmeticExpression> analyseIntrinsic(const PrimaryExprNode& intrinsic, std::vector<std::unique_ptr<AstArithmeticExpression>> arguments);
+
+    // analyseConditional           Creates the AstConditional node of the given conditional expression from its (already analysed) operands
+    std::unique_ptr<AstArithmeticExpression> analyseConditional(const PrimaryExprNode& conditional, std::vector<std::unique_ptr<AstArithmeticExpression>> operands);
+
     // analyseStatement             If the statment is a return statement, checks whether the return value is a valid expression.
     //                              If it is an assignment expression, checks for a valid assignment.
     //                              In both cases, if successfull, returns a AstStatement node.
@@ -49,6 +72,7 @@ class SemanticAnalyser {
 
     const SourceCodeManager& manager;       // Reference to the associated source code manager
     const FuncDeclNode& function;           // The given parse tree of the function
+    const CalleeResolver resolver;          // Resolves the names of called functions
 
     SymbolTable table;                      // Symbol table
 
@@ -60,7 +84,9 @@ class SemanticAnalyser {
     size_t nofparameters{0};
     size_t nofvariables{0};
 
-    std::map<std::string_view, size_t> nametable{};     // A map to create indices for the identifiers
+    static constexpr size_t undeclared = std::numeric_limits<size_t>::max();     // Marks names without a declaration in the nametable
+
+    std::vector<size_t> nametable{};                    // Maps the interned id of a name (directly indexed) to the index of the identifier in the symbol table
     std::vector<int64_t> constantTable{};               // Vector to store the values of constants during the semantical analysis
 };
 
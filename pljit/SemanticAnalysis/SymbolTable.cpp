@@ -7,22 +7,8 @@ namespace jit {
 
 void SymbolTable::insertEntry(SourceCodeReference declaration, bool isConst, bool hasValue) {
 
-    table.emplace_back(TableEntry{declaration, isConst, hasValue});
+    declarations.push_back(declaration);
+    flags.push_back(static_cast<uint8_t>((isConst ? IsConst : 0) | (hasValue ? HasValue : 0)));
 }
 
-bool SymbolTable::hasValue(size_t index) const {
-
-    assert(index < table.size());
-
-    return table[index].hasValue;
-
-}
-
-bool SymbolTable::isConst(size_t index) const {
-
-    assert(index < table.size());
-
-    return table[index].isConst;
-}
-
-} // namespace jit
\ No newline at end of file
+} // namespace jit
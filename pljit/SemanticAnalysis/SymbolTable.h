@@ -1,6 +1,7 @@
 #ifndef PLJIT_SYMBOLTABLE_H
 #define PLJIT_SYMBOLTABLE_H
 
+#include <cstdint>
 #include <optional>
 #include <cassert>
 
@@ -12,38 +13,42 @@ namespace jit {
 class SemanticAnalyser;
 
 // SymbolTable                          Represents a symbol table used during the semantic analysis to detect semantic errors in the source code
+//                                      The entries are stored column-wise (declarations and flags in separate arrays) and are directly indexed by the symbol index
 class SymbolTable {
 
     public:
 
     friend class SemanticAnalyser;
 
-    struct TableEntry {
-
-        TableEntry(SourceCodeReference declaration, bool isConst, bool hasValue) : declaration{declaration}, isConst{isConst}, hasValue{hasValue} {}
-
-        SourceCodeReference declaration;    // Reference to the position in the source code
-        bool isConst{false};                // Indicates whether the variable is constant
-        bool hasValue{false};               // Indicates whether the variable has a valid value (whether it is initialised)
-    };
-
     // Constructor
     SymbolTable() = default;
 
     // hasValue         Returns whether the variable at the given index has a valid value
-    bool hasValue(size_t index) const;
+    bool hasValue(size_t index) const { assert(index < flags.size()); return flags[index] & HasValue; }
 
     // isConst          Returns whether the variable at the given index is a constant
-    bool isConst(size_t index) const;
+    bool isConst(size_t index) const { assert(index < flags.size()); return flags[index] & IsConst; }
+
+    // getDeclaration   Returns the reference to the declaration of the variable at the given index
+    const SourceCodeReference& getDeclaration(size_t index) const { assert(index < declarations.size()); return declarations[index]; }
 
 
     private:
 
-    // insertEntry      Inserts an object of type TableEntry constructed with the given values at the end of the symbol table
+    // Bits of the flags entries
+    enum Flag : uint8_t {
+        IsConst = 1,        // Indicates whether the variable is constant
+        HasValue = 2        // Indicates whether the variable has a valid value (whether it is initialised)
+    };
+
+    // insertEntry      Inserts an entry constructed with the given values at the end of the symbol table
     void insertEntry(SourceCodeReference declaration, bool isConst, bool hasValue);
 
-    std::vector<TableEntry> table{};        // The internal representation of the symbol table
-    std::vector<int64_t> constants{};       // Stores the values for the constants
+    // setHasValue      Marks the variable at the given index as initialised
+    void setHasValue(size_t index) { assert(index < flags.size()); flags[index] |= HasValue; }
+
+    std::vector<SourceCodeReference> declarations{};    // References to the declarations in the source code
+    std::vector<uint8_t> flags{};                       // The flags (see enum Flag) of the entries
 };
 
 } // namespace jit
@@ -90,4 +90,62 @@ TEST(Evaluation, code2) {
 
 
 
+TEST(Evaluation, Call) {
+
+    string callee = "PARAM x, y;\nBEGIN\nRETURN x / y\nEND.\n";
+    string caller = "PARAM a;\nBEGIN\nRETURN CALL divide(a * 3, a - 1) + 1\nEND.\n";
+
+    SourceCodeManager calleeManager{callee};
+    Parser calleeParser{callee, calleeManager};
+    auto calleeTree = calleeParser.parseFunction();
+    ASSERT_NE(calleeTree, nullptr);
+    auto calleeAst = SemanticAnalyser{calleeManager, *calleeTree}.analyseFunction();
+    ASSERT_NE(calleeAst, nullptr);
+
+    SourceCodeManager manager{caller};
+    Parser p{caller, manager};
+    auto f = p.parseFunction();
+    ASSERT_NE(f, nullptr);
+
+    // Without resolver, calls are invalid
+    EXPECT_EQ(SemanticAnalyser(manager, *f).analyseFunction(), nullptr);
+
+    auto resolver = [&](string_view name, SourceCodeReference) -> optional<AstCallee> {
+        if (name != "divide")
+            return nullopt;
+        return AstCallee{calleeAst.get(), nullptr, &calleeManager};
+    };
+
+    auto ast = SemanticAnalyser{manager, *f, resolver}.analyseFunction();
+    ASSERT_NE(ast, nullptr);
+
+    EvalInstance ev{*ast, manager};
+
+    EXPECT_EQ(ev.evaluate({3}), 9 / 2 + 1);
+    EXPECT_EQ(ev.evaluate({-2}), -6 / -3 + 1);
+    EXPECT_EQ(ev.evaluate({1}), nullopt);
+}
+
+TEST(Evaluation, MultipleResults) {
+
+    string code = "PARAM a, b;\nVAR s;\nBEGIN\ns := a + b;\nRETURN s * 2, s / b, 7\nEND.\n";
+
+    SourceCodeManager manager{code};
+    Parser p{code, manager};
+    auto f = p.parseFunction();
+    ASSERT_NE(f, nullptr);
+
+    auto ast = SemanticAnalyser{manager, *f}.analyseFunction();
+    ASSERT_NE(ast, nullptr);
+    EXPECT_EQ(ast->nofresults, 3u);
+
+    // The first value is the result, all values are available afterwards
+    EvalInstance ev{*ast, manager};
+
+    EXPECT_EQ(ev.evaluate({5, 3}), 16);
+    EXPECT_EQ(ev.getResults(), (vector<int64_t>{16, 8 / 3, 7}));
+
+    EXPECT_EQ(ev.evaluate({5, 0}), nullopt);
+}
+
 } // namespace jit::Tester_Evaluation
\ No newline at end of file
@@ -0,0 +1,815 @@
+#include "gtest/gtest.h"
+
+#include <limits>
+#include <sstream>
+
+#include "../pljit/Evaluation/Arithmetic.h"
+#include "../pljit/Evaluation/EvalInstance.h"
+#include "../pljit/Evaluation/IrEvalInstance.h"
+#include "../pljit/IR/AlgebraicSimplifyOpt.h"
+#include "../pljit/IR/DeadValueOpt.h"
+#include "../pljit/IR/IrBuilder.h"
+#include "../pljit/IR/PolynomialOpt.h"
+#include "../pljit/IR/RangeAnalysisOpt.h"
+#include "../pljit/IR/StrengthReductionOpt.h"
+#include "../pljit/IR/TreeBalancingOpt.h"
+#include "../pljit/IR/ValueNumberingOpt.h"
+#include "../pljit/Parser/Parser.h"
+#include "../pljit/SemanticAnalysis/SemanticAnalyser.h"
+
+using namespace std;
+using namespace jit;
+
+namespace jit::Tester_IR {
+
+string code1 = "PARAM a, b;\n"
+               "VAR c;\n"
+               "CONST d = 220;\n"
+               "BEGIN\n"
+               "c := (a + b) * d;\n"
+               "RETURN (a - 2 * b) + 3 * c\n"
+               "END.\n";
+
+string code2 = "PARAM a, b;\n"
+               "VAR c;\n"
+               "BEGIN\n"
+               "c := a;\n"
+               "a := b;\n"
+               "b := c;\n"
+               "RETURN a / b\n"
+               "END.\n";
+
+string code3 = "PARAM a;\n"
+               "VAR c;\n"
+               "BEGIN\n"
+               "c := a - 4;\n"
+               "RETURN a * (-c) / (c + 3)\n"
+               "END.\n";
+
+// lower                Parses, analyses and lowers the given source code into the intermediate representation
+unique_ptr<IrFunction> lower(const string& code, const SourceCodeManager& manager, unique_ptr<AstFunction>& ast) {
+
+    Parser parser{code, manager};
+    auto parsetree = parser.parseFunction();
+
+    if (!parsetree)
+        return nullptr;
+
+    SemanticAnalyser seman{manager, *parsetree};
+    ast = seman.analyseFunction();
+
+    if (!ast)
+        return nullptr;
+
+    return IrBuilder{*ast}.buildFunction();
+}
+
+TEST(IR, Lowering) {
+
+    SourceCodeManager manager{code1};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code1, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    ostringstream out{};
+    ir->print(out);
+
+    EXPECT_EQ(out.str(), "%0 = param 0\n"
+                         "%1 = param 1\n"
+                         "%2 = const 0\n"
+                         "%3 = add %0, %1\n"
+                         "%4 = const 220\n"
+                         "%5 = mul %3, %4\n"
+                         "%6 = const 2\n"
+                         "%7 = mul %6, %1\n"
+                         "%8 = sub %0, %7\n"
+                         "%9 = const 3\n"
+                         "%10 = mul %9, %5\n"
+                         "%11 = add %8, %10\n"
+                         "return %11\n");
+}
+
+TEST(IR, AssignmentsDefineNewValues) {
+
+    SourceCodeManager manager{code2};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code2, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    // The assignments only rename values, no instructions are needed for them: a / b computes the original b / a
+    ASSERT_EQ(ir->instructions.size(), 4u);
+    const IrInstruction& div = ir->instructions[ir->results.front()];
+    EXPECT_EQ(div.opcode, IrInstruction::Opcode::Div);
+    EXPECT_EQ(div.lhs, 1u);
+    EXPECT_EQ(div.rhs, 0u);
+
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({3, 12}), 4);
+    EXPECT_EQ(ev.evaluate({0, 12}), nullopt);
+    EXPECT_EQ(ev.evaluate({1}), nullopt);
+}
+
+TEST(IR, SameResultsAsAst) {
+
+    for (const string& code : {code1, code2, code3}) {
+
+        SourceCodeManager manager{code};
+        unique_ptr<AstFunction> ast{};
+
+        auto ir = lower(code, manager, ast);
+        ASSERT_NE(ir, nullptr);
+
+        size_t nofparameters = ast->nofparameters;
+        EvalInstance astev{*ast, manager};
+        IrEvalInstance irev{*ir, manager};
+
+        for (int64_t a : {-7, 1, 5, 42}) {
+            for (int64_t b : {-3, 2, 17}) {
+
+                vector<int64_t> args{a, b};
+                args.resize(nofparameters);
+                EXPECT_EQ(astev.evaluate(args), irev.evaluate(args));
+            }
+        }
+    }
+}
+
+TEST(IR, WrappingArithmetic) {
+
+    string code = "PARAM a, b;\n"
+                  "BEGIN\n"
+                  "RETURN a / b + a * a\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    int64_t min = numeric_limits<int64_t>::min();
+
+    // min / -1 and min * min overflow, the results wrap around
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({min, -1}), min);
+}
+
+TEST(IR, ValueNumbering) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c, d;\n"
+                  "CONST e = 220;\n"
+                  "BEGIN\n"
+                  "c := (a + b) * e;\n"
+                  "d := ((b + a) * e) / b;\n"
+                  "a := 1;\n"
+                  "RETURN c + d + ((a + b) * e) / b\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    IrEvalInstance before{*ir, manager};
+    auto expected = before.evaluate({5, 3});
+    ASSERT_TRUE(expected);
+
+    ValueNumberingOpt valuenumbering{};
+    EXPECT_EQ(valuenumbering.run(*ir), 4u);
+
+    ostringstream out{};
+    ir->print(out);
+
+    // '(b + a) * e' is the same value as 'c', the literal 220 is only loaded once. After the assignment to a, '(a + b) * e' is a different value
+    EXPECT_EQ(out.str(), "%0 = param 0\n"
+                         "%1 = param 1\n"
+                         "%2 = const 0\n"
+                         "%3 = add %0, %1\n"
+                         "%4 = const 220\n"
+                         "%5 = mul %3, %4\n"
+                         "%6 = div %5, %1\n"
+                         "%7 = const 1\n"
+                         "%8 = add %7, %1\n"
+                         "%9 = mul %8, %4\n"
+                         "%10 = div %9, %1\n"
+                         "%11 = add %6, %10\n"
+                         "%12 = add %5, %11\n"
+                         "return %12\n");
+
+    IrEvalInstance after{*ir, manager};
+    EXPECT_EQ(after.evaluate({5, 3}), expected);
+    EXPECT_EQ(after.evaluate({5, 0}), nullopt);
+}
+
+TEST(IR, ValueNumberingDivision) {
+
+    string code = "PARAM a, b;\n"
+                  "BEGIN\n"
+                  "RETURN a / b - b / a + a / b\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    ValueNumberingOpt valuenumbering{};
+    EXPECT_EQ(valuenumbering.run(*ir), 1u);
+
+    // Only the repeated division is removed, the first division by zero is still reported
+    ASSERT_EQ(ir->instructions.size(), 6u);
+    EXPECT_EQ(ir->instructions[2].opcode, IrInstruction::Opcode::Div);
+    EXPECT_EQ(ir->instructions[3].opcode, IrInstruction::Opcode::Div);
+
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({6, 3}), 0);
+    EXPECT_EQ(ev.evaluate({6, 0}), nullopt);
+    EXPECT_EQ(ev.evaluate({0, 6}), nullopt);
+}
+
+TEST(IR, DeadValues) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c, d, e;\n"
+                  "BEGIN\n"
+                  "c := a * b;\n"
+                  "d := a / 2;\n"
+                  "e := b / (a - 1);\n"
+                  "RETURN a + 1\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    DeadValueOpt deadvalue{};
+    EXPECT_EQ(deadvalue.run(*ir), 4u);
+
+    ostringstream out{};
+    ir->print(out);
+
+    // The unused variables and 'a / 2' are removed, 'b / (a - 1)' is kept as it can fail
+    EXPECT_EQ(out.str(), "%0 = param 0\n"
+                         "%1 = param 1\n"
+                         "%2 = const 1\n"
+                         "%3 = sub %0, %2\n"
+                         "%4 = div %1, %3\n"
+                         "%5 = const 1\n"
+                         "%6 = add %0, %5\n"
+                         "return %6\n");
+
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({4, 3}), 5);
+    EXPECT_EQ(ev.evaluate({1, 3}), nullopt);
+}
+
+TEST(IR, FrameSlots) {
+
+    // A long chain of assignments only needs a few slots, as every value is dead after its next use
+    string code = "PARAM a;\n"
+                  "VAR b;\n"
+                  "BEGIN\n";
+
+    for (size_t i = 0; i < 30; ++i)
+        code += "b := a * 3;\na := b + 1;\n";
+
+    code += "RETURN a\nEND.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    DeadValueOpt deadvalue{};
+    deadvalue.run(*ir);
+
+    EXPECT_EQ(ir->instructions.size(), 121u);
+    EXPECT_EQ(ir->nofslots, 2u);
+
+    int64_t expected = 2;
+    for (size_t i = 0; i < 30; ++i)
+        expected = expected * 3 + 1;
+
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({2}), expected);
+}
+
+TEST(IR, StrengthReduction) {
+
+    string code = "PARAM a;\n"
+                  "BEGIN\n"
+                  "RETURN (a * 8) - (4 * a) + (a / 7) / a\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    StrengthReductionOpt strengthreduction{};
+    EXPECT_EQ(strengthreduction.run(*ir), 3u);
+
+    // Only the division by a remains, which still reports a division by zero
+    size_t nofmul = 0;
+    size_t nofdiv = 0;
+    for (const IrInstruction& instr : ir->instructions) {
+        nofmul += instr.opcode == IrInstruction::Opcode::Mul;
+        nofdiv += instr.opcode == IrInstruction::Opcode::Div;
+    }
+
+    EXPECT_EQ(nofmul, 0u);
+    EXPECT_EQ(nofdiv, 1u);
+
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({100}), 800 - 400);
+    EXPECT_EQ(ev.evaluate({-100}), -800 + 400);
+    EXPECT_EQ(ev.evaluate({0}), nullopt);
+}
+
+TEST(IR, DivisionByConstant) {
+
+    int64_t min = numeric_limits<int64_t>::min();
+    int64_t max = numeric_limits<int64_t>::max();
+
+    vector<int64_t> numerators{0, 1, -1, 2, -2, 6, -6, 7, -7, 100, -100, 12345678, -12345678, 1ll << 40, -(1ll << 40), max, max - 1, min, min + 1};
+    vector<int64_t> divisors{min, max, min + 1, 1ll << 62, -(1ll << 62), 1000000007, -1000000007};
+
+    for (int64_t d = -1000; d <= 1000; ++d)
+        if (d != 0)
+            divisors.push_back(d);
+
+    // Known magic numbers (Hacker's Delight, table 10-2)
+    MagicNumber magic = StrengthReductionOpt::computeMagicNumber(7);
+    EXPECT_EQ(magic.factor, 0x4924924924924925);
+    EXPECT_EQ(magic.shift, 1);
+    EXPECT_EQ(magic.adjust, 0);
+
+    magic = StrengthReductionOpt::computeMagicNumber(3);
+    EXPECT_EQ(magic.factor, 0x5555555555555556);
+    EXPECT_EQ(magic.shift, 0);
+
+    StrengthReductionOpt strengthreduction{};
+    SourceCodeManager manager{""};
+
+    for (int64_t d : divisors) {
+
+        // param 0 / d
+        IrFunction ir{1};
+        IrFunction::ValueId n = ir.addParameter(0);
+        ir.results = {ir.addDivision(n, ir.addConstant(d), SourceCodeReference{0})};
+        ir.assignSlots();
+
+        EXPECT_EQ(strengthreduction.run(ir), 1u);
+
+        IrEvalInstance ev{ir, manager};
+        for (int64_t x : numerators)
+            EXPECT_EQ(ev.evaluate({x}), wrappingDiv(x, d)) << x << " / " << d;
+    }
+}
+
+TEST(IR, MagicNumberTable) {
+
+    StrengthReductionOpt strengthreduction{};
+    SourceCodeManager manager{""};
+
+    // param 0 / 7, reduced
+    IrFunction callee{1};
+    IrFunction::ValueId x = callee.addParameter(0);
+    callee.results = {callee.addDivision(x, callee.addConstant(7), SourceCodeReference{0})};
+    callee.assignSlots();
+
+    EXPECT_EQ(strengthreduction.run(callee), 1u);
+    ASSERT_EQ(callee.magicnumbers.size(), 1u);
+    EXPECT_EQ(callee.magicnumbers.front().divisor, 7);
+
+    // A division by the same divisor reduced in a later run shares the magic number, the one of a removed division is dropped
+    IrFunction::ValueId quotient = callee.results.front();
+    callee.addDivision(quotient, callee.addConstant(9), SourceCodeReference{0});
+    callee.results = {callee.addDivision(quotient, callee.addConstant(7), SourceCodeReference{0})};
+    callee.assignSlots();
+
+    EXPECT_EQ(strengthreduction.run(callee), 2u);
+    EXPECT_EQ(callee.magicnumbers.size(), 2u);
+
+    DeadValueOpt deadvalue{};
+    EXPECT_GT(deadvalue.run(callee), 0u);
+    ASSERT_EQ(callee.magicnumbers.size(), 1u);
+    EXPECT_EQ(callee.magicnumbers.front().divisor, 7);
+
+    IrEvalInstance calleeev{callee, manager};
+    EXPECT_EQ(calleeev.evaluate({-1000}), -1000 / 7 / 7);
+
+    // Inlining the function many times keeps a single magic number per divisor
+    IrFunction fused{1};
+    IrFunction::ValueId sum = fused.addParameter(0);
+    for (int i = 0; i < 200; ++i)
+        sum = fused.addBinary(IrInstruction::Opcode::Add, sum, fused.inlineFunction(callee, {fused.addConstant(i * 100)}).front());
+    fused.results = {sum};
+    fused.assignSlots();
+
+    EXPECT_EQ(fused.magicnumbers.size(), 1u);
+
+    int64_t expected = 5;
+    for (int64_t i = 0; i < 200; ++i)
+        expected += i * 100 / 7 / 7;
+
+    IrEvalInstance fusedev{fused, manager};
+    EXPECT_EQ(fusedev.evaluate({5}), expected);
+}
+
+TEST(IR, AlgebraicSimplification) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c;\n"
+                  "BEGIN\n"
+                  "c := ((a + 1) + 2) * 1;\n"
+                  "c := c - a + (0 * b) - -(-a);\n"
+                  "RETURN c + (b - b) + 4 * (a + 1) - 4\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    AlgebraicSimplifyOpt algebraicsimplify{};
+    EXPECT_GT(algebraicsimplify.run(*ir), 0u);
+
+    // c = a + 3, so the result is 5 * a + 3
+    stringstream out{};
+    ir->print(out);
+
+    EXPECT_EQ(out.str(), "%0 = param 0\n"
+                         "%1 = param 1\n"
+                         "%2 = const 5\n"
+                         "%3 = mul %0, %2\n"
+                         "%4 = const 3\n"
+                         "%5 = add %3, %4\n"
+                         "return %5\n");
+
+    IrEvalInstance ev{*ir, manager};
+    EvalInstance astev{*ast, manager};
+
+    for (int64_t a : {-7, 0, 5, 123456})
+        for (int64_t b : {-3, 0, 9})
+            EXPECT_EQ(ev.evaluate({a, b}), astev.evaluate({a, b}));
+}
+
+TEST(IR, AlgebraicSimplificationKeepsDivisions) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c;\n"
+                  "BEGIN\n"
+                  "c := (a - a) / (b - b);\n"
+                  "c := (6 + 2) / (3 - 1);\n"
+                  "RETURN c + a / (b + 1)\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    AlgebraicSimplifyOpt algebraicsimplify{};
+    algebraicsimplify.run(*ir);
+
+    // The constant division by zero still fails, the division by 2 is folded
+    size_t nofdiv = 0;
+    for (const IrInstruction& instr : ir->instructions)
+        nofdiv += instr.opcode == IrInstruction::Opcode::Div;
+
+    EXPECT_EQ(nofdiv, 2u);
+
+    IrEvalInstance ev{*ir, manager};
+    EXPECT_EQ(ev.evaluate({10, 4}), nullopt);
+}
+
+TEST(IR, Polynomial) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c;\n"
+                  "BEGIN\n"
+                  "c := (a + b) * (a - b);\n"
+                  "c := c + b * b + 6 / 3;\n"
+                  "RETURN c * a\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    // (a^2 + 2) * a = a^3 + 2a
+    auto polynomial = PolynomialOpt::analyse(*ir);
+    ASSERT_TRUE(polynomial);
+    EXPECT_EQ(*polynomial, (PolynomialOpt::Polynomial{{{0}, 2}, {{0, 0, 0}, 1}}));
+
+    PolynomialOpt polynomialopt{};
+    EXPECT_GT(polynomialopt.run(*ir), 0u);
+    EXPECT_FALSE(ir->affine);
+
+    stringstream out{};
+    ir->print(out);
+
+    EXPECT_EQ(out.str(), "%0 = param 0\n"
+                         "%1 = const 2\n"
+                         "%2 = mul %0, %1\n"
+                         "%3 = mul %0, %0\n"
+                         "%4 = mul %3, %0\n"
+                         "%5 = add %2, %4\n"
+                         "return %5\n");
+
+    IrEvalInstance ev{*ir, manager};
+    EvalInstance astev{*ast, manager};
+
+    for (int64_t a : vector<int64_t>{-7, 0, 5, 3037000500})
+        for (int64_t b : {-3, 0, 9})
+            EXPECT_EQ(ev.evaluate({a, b}), astev.evaluate({a, b}));
+}
+
+TEST(IR, AffinePolynomial) {
+
+    string code = "PARAM a, b, c;\n"
+                  "VAR d;\n"
+                  "BEGIN\n"
+                  "d := 3 * (a - 2 * c) + 1;\n"
+                  "RETURN d - (c - 4) * 5\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    PolynomialOpt polynomialopt{};
+    polynomialopt.run(*ir);
+
+    // 21 + 3a - 11c
+    ASSERT_TRUE(ir->affine);
+    EXPECT_EQ(*ir->affine, (vector<int64_t>{21, 3, 0, -11}));
+
+    IrEvalInstance ev{*ir, manager};
+    EvalInstance astev{*ast, manager};
+
+    for (int64_t a : {-7, 0, 5})
+        for (int64_t c : {-3, 0, 9})
+            EXPECT_EQ(ev.evaluate({a, 1, c}), astev.evaluate({a, 1, c}));
+
+    // Storing the coefficients is a change, storing them again is none
+    EXPECT_EQ(polynomialopt.run(*ir), 0u);
+}
+
+TEST(IR, AffinePolynomialManyParameters) {
+
+    // A weighted sum of 40 parameters has more terms than maxTerms, but the number of affine terms is not limited
+    auto name = [](size_t i) { return string{'p', static_cast<char>('a' + i / 26), static_cast<char>('a' + i % 26)}; };
+
+    string code = "PARAM " + name(0);
+    for (size_t i = 1; i < 40; ++i)
+        code += ", " + name(i);
+
+    code += ";\nBEGIN\nRETURN 7";
+    for (size_t i = 0; i < 40; ++i)
+        code += " + " + to_string(i + 1) + " * " + name(i);
+    code += "\nEND.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    PolynomialOpt polynomialopt{};
+    EXPECT_GT(polynomialopt.run(*ir), 0u);
+
+    ASSERT_TRUE(ir->affine);
+    ASSERT_EQ(ir->affine->size(), 41u);
+    EXPECT_EQ(ir->affine->front(), 7);
+    EXPECT_EQ(ir->affine->back(), 40);
+
+    vector<int64_t> args(40);
+    for (size_t i = 0; i < args.size(); ++i)
+        args[i] = static_cast<int64_t>(i) - 13;
+
+    IrEvalInstance ev{*ir, manager};
+    EvalInstance astev{*ast, manager};
+    EXPECT_EQ(ev.evaluate(args), astev.evaluate(args));
+}
+
+TEST(IR, PolynomialFallback) {
+
+    // Divisions by parameters and too large polynomials are not normalised
+    vector<string> codes{"PARAM a, b;\n"
+                         "BEGIN\n"
+                         "RETURN (a + 1) / b\n"
+                         "END.\n",
+
+                         "PARAM a;\n"
+                         "BEGIN\n"
+                         "RETURN (a / 2) * a\n"
+                         "END.\n",
+
+                         "PARAM a, b;\n"
+                         "VAR c;\n"
+                         "BEGIN\n"
+                         "c := (a + b + 1) * (a + b + 1);\n"
+                         "c := c * c;\n"
+                         "RETURN c * c\n"
+                         "END.\n"};
+
+    for (const string& code : codes) {
+
+        SourceCodeManager manager{code};
+        unique_ptr<AstFunction> ast{};
+
+        auto ir = lower(code, manager, ast);
+        ASSERT_NE(ir, nullptr);
+
+        size_t nofinstructions = ir->instructions.size();
+
+        EXPECT_FALSE(PolynomialOpt::analyse(*ir));
+
+        PolynomialOpt polynomialopt{};
+        EXPECT_EQ(polynomialopt.run(*ir), 0u);
+        EXPECT_EQ(ir->instructions.size(), nofinstructions);
+        EXPECT_FALSE(ir->affine);
+    }
+}
+
+TEST(IR, TreeBalancing) {
+
+    // p0 + (p1 + (p2 + ... (p6 + p7 * (p0 * (p1 * p2)))))
+    IrFunction ir{8};
+
+    vector<IrFunction::ValueId> parameters{};
+    for (size_t i = 0; i < 8; ++i)
+        parameters.push_back(ir.addParameter(i));
+
+    IrFunction::ValueId product = ir.addBinary(IrInstruction::Opcode::Mul, parameters[1], parameters[2]);
+    product = ir.addBinary(IrInstruction::Opcode::Mul, parameters[0], product);
+    product = ir.addBinary(IrInstruction::Opcode::Mul, parameters[7], product);
+
+    IrFunction::ValueId sum = product;
+    for (size_t i = 7; i-- > 0;)
+        sum = ir.addBinary(IrInstruction::Opcode::Add, parameters[i], sum);
+
+    ir.results.push_back(sum);
+    ir.assignSlots();
+
+    SourceCodeManager manager{""};
+    vector<int64_t> args{3, -5, 7, 11, 13, -17, 19, 23};
+
+    IrEvalInstance before{ir, manager};
+    optional<int64_t> expected = before.evaluate(args);
+
+    TreeBalancingOpt treebalancing{};
+    EXPECT_EQ(treebalancing.run(ir), 2u);
+    EXPECT_EQ(treebalancing.run(ir), 0u);
+
+    // Both chains have the minimal depth now, the number of operations does not change
+    vector<size_t> depth(ir.instructions.size(), 0);
+    for (size_t i = 0; i < ir.instructions.size(); ++i)
+        if (ir.instructions[i].isBinary())
+            depth[i] = 1 + max(depth[ir.instructions[i].lhs], depth[ir.instructions[i].rhs]);
+
+    EXPECT_EQ(ir.instructions.size(), 18u);
+    EXPECT_EQ(depth[ir.results.front()], 3u + 2u);
+
+    IrEvalInstance after{ir, manager};
+    EXPECT_EQ(after.evaluate(args), expected);
+}
+
+TEST(IR, RangeAnalysis) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c, d;\n"
+                  "BEGIN\n"
+                  "c := a / (a * a + 1);\n"
+                  "d := b / (a / 1000 + 10000000000000000);\n"
+                  "RETURN c + d + a / b\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    // 'a * a + 1' is never 0 modulo 16, 1000 and 'a / 1000 + 10000000000000000' are positive, only the parameter b may be 0
+    vector<ValueRange> ranges = RangeAnalysisOpt::analyse(*ir);
+    EXPECT_EQ(ranges[ir->results.front()].min, numeric_limits<int64_t>::min());
+
+    IrEvalInstance before{*ir, manager};
+    vector<vector<int64_t>> args{{7, 3}, {-1000, 0}, {numeric_limits<int64_t>::min(), 5}, {3037000500, -9}};
+    vector<optional<int64_t>> expected{};
+    for (const auto& arg : args)
+        expected.push_back(before.evaluate(arg));
+
+    RangeAnalysisOpt rangeanalysis{};
+    EXPECT_EQ(rangeanalysis.run(*ir), 3u);
+    EXPECT_TRUE(rangeanalysis.getZeroDivisors().empty());
+
+    size_t nofdiv = 0;
+    for (const IrInstruction& instr : ir->instructions)
+        nofdiv += instr.opcode == IrInstruction::Opcode::Div;
+
+    EXPECT_EQ(nofdiv, 1u);
+
+    IrEvalInstance after{*ir, manager};
+    for (size_t i = 0; i < args.size(); ++i)
+        EXPECT_EQ(after.evaluate(args[i]), expected[i]);
+}
+
+TEST(IR, RangeAnalysisZeroDivisor) {
+
+    string code = "PARAM a;\n"
+                  "BEGIN\n"
+                  "RETURN a / (3 - 3)\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    RangeAnalysisOpt rangeanalysis{};
+    EXPECT_EQ(rangeanalysis.run(*ir), 0u);
+    ASSERT_EQ(rangeanalysis.getZeroDivisors().size(), 1u);
+    EXPECT_EQ(manager.getString(rangeanalysis.getZeroDivisors().front()), "3 - 3");
+}
+
+TEST(IR, Conditional) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c;\n"
+                  "BEGIN\n"
+                  "c := IF b <> 0 THEN a / b ELSE IF a >= 0 THEN MAX(a, 7) / a ELSE ABS(a) / (b + 1);\n"
+                  "RETURN MIN(c, 100) + (IF 2 > 1 THEN a ELSE a / 0)\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    unique_ptr<AstFunction> ast{};
+
+    auto ir = lower(code, manager, ast);
+    ASSERT_NE(ir, nullptr);
+
+    // Both alternatives are computed and selected without a branch, the divisions of an alternative cannot fail while it is not selected
+    size_t nofselect = 0;
+    for (const IrInstruction& instr : ir->instructions)
+        nofselect += instr.opcode == IrInstruction::Opcode::Select;
+    EXPECT_GE(nofselect, 3u);
+
+    int64_t min = numeric_limits<int64_t>::min();
+    vector<vector<int64_t>> args{{7, 2}, {7, 0}, {-9, 0}, {3, 0}, {0, 0}, {500, 1}, {min, 0}, {min, -1}};
+
+    EvalInstance astev{*ast, manager};
+    IrEvalInstance before{*ir, manager};
+
+    vector<optional<int64_t>> expected{};
+    for (const auto& arg : args) {
+        expected.push_back(astev.evaluate(arg));
+        EXPECT_EQ(before.evaluate(arg), expected.back());
+    }
+
+    EXPECT_EQ(expected[0], 3 + 7);
+    EXPECT_EQ(expected[1], 1 + 7);
+    EXPECT_EQ(expected[2], 9 + -9);
+    EXPECT_EQ(expected[3], 2 + 3);
+    EXPECT_EQ(expected[4], nullopt);
+    EXPECT_EQ(expected[5], 100 + 500);
+
+    // The optimisations fold the constant condition and keep the results
+    AlgebraicSimplifyOpt algebraicsimplify{};
+    ValueNumberingOpt valuenumbering{};
+    RangeAnalysisOpt rangeanalysis{};
+    DeadValueOpt deadvalue{};
+    TreeBalancingOpt treebalancing{};
+
+    algebraicsimplify.run(*ir);
+    valuenumbering.run(*ir);
+    rangeanalysis.run(*ir);
+    deadvalue.run(*ir);
+    treebalancing.run(*ir);
+
+    EXPECT_TRUE(rangeanalysis.getZeroDivisors().empty());
+
+    IrEvalInstance after{*ir, manager};
+    for (size_t i = 0; i < args.size(); ++i)
+        EXPECT_EQ(after.evaluate(args[i]), expected[i]);
+}
+
+} // namespace jit::Tester_IR
@@ -17,6 +17,10 @@ string codeKeyword = "PARAM   BEGIN    VAR CONST RETURN END\n";
 string codeSeparator = ".,;()\n";
 string codeArithmetic = "+/:==-*\n";
 string codeLiteral = "220 00284\n\n  \n\n\n 00000013\n";
+string codeLiteralMax = "9223372036854775807 9223372036854775808\n";
+string codeKeywordLike = "PARAMS BEGI Var ENDE RETURNS CONSTANT PARAM\n";
+string codeConditional = "IF THEN ELSE MIN MAX ABS IFS MINI\n";
+string codeComparison = "< <= <> > >= =\n";
 
 
 TEST(Lexer, TestTokenType) {
@@ -138,6 +142,96 @@ TEST(Lexer, TestLiteral) {
 
 }
 
+TEST(Lexer, TestTokenPosition) {
+
+    SourceCodeManager manager{codeLiteral};
+    Lexer lex{codeLiteral, manager};
+
+    auto tk = lex.nextToken();
+    EXPECT_EQ(manager.getabsolutePosition(tk->location), 0u);
+    EXPECT_EQ(manager.getLine(tk->location), 1u);
+    EXPECT_EQ(manager.getPosition(tk->location), 1u);
+
+    tk = lex.nextToken();
+    EXPECT_EQ(manager.getabsolutePosition(tk->location), 4u);
+    EXPECT_EQ(manager.getLine(tk->location), 1u);
+    EXPECT_EQ(manager.getPosition(tk->location), 5u);
+
+    tk = lex.nextToken();
+    EXPECT_EQ(manager.getString(tk->location), "00000013");
+    EXPECT_EQ(manager.getLine(tk->location), 6u);
+    EXPECT_EQ(manager.getPosition(tk->location), 2u);
+
+}
+
+TEST(Lexer, TestLiteralOverflow) {
+
+    SourceCodeManager manager{codeLiteralMax};
+    Lexer lex{codeLiteralMax, manager};
+
+    // Largest value representable as int64_t
+    auto tk = lex.nextToken();
+    ASSERT_NE(tk, nullptr);
+    ASSERT_EQ(tk->tokentype, Token::TokenType::Literal);
+    EXPECT_EQ(static_cast<Literal&>(*tk).value, 9223372036854775807);
+
+    // One more does not fit anymore
+    tk = lex.nextToken();
+    EXPECT_EQ(tk, nullptr);
+}
+
+TEST(Lexer, TestKeywordLikeIdentifier) {
+
+    SourceCodeManager manager{codeKeywordLike};
+    Lexer lex{codeKeywordLike, manager};
+
+    for (int i = 0; i < 6; ++i) {
+        auto tk = lex.nextToken();
+        ASSERT_NE(tk, nullptr);
+        EXPECT_EQ(tk->tokentype, Token::TokenType::Identifier);
+    }
+
+    auto tk = lex.nextToken();
+    ASSERT_EQ(tk->tokentype, Token::TokenType::Keyword);
+    EXPECT_EQ(static_cast<Keyword&>(*tk).keywordtype, Keyword::KeywordType::Parameter);
+}
+
+TEST(Lexer, TestIdentifierIds) {
+
+    string code = "abc x abc y x\n";
+    SourceCodeManager manager{code};
+    Lexer lex{code, manager};
+
+    vector<size_t> ids{};
+    for (int i = 0; i < 5; ++i) {
+        auto tk = lex.nextToken();
+        ASSERT_EQ(tk->tokentype, Token::TokenType::Identifier);
+        ids.push_back(static_cast<Identifier&>(*tk).id);
+    }
+
+    // Equal names get equal ids, distinct names get dense distinct ids
+    EXPECT_EQ(ids, (vector<size_t>{0, 1, 0, 2, 1}));
+    EXPECT_EQ(lex.getIdentifierTable().size(), 3u);
+    EXPECT_EQ(lex.getIdentifierTable().getName(2), "y");
+}
+
+TEST(Lexer, TestIdentifierTableGrowth) {
+
+    IdentifierTable table{};
+    vector<string> names{};
+
+    for (int i = 0; i < 1000; ++i)
+        names.push_back("v" + to_string(i));
+
+    for (size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(table.intern(names[i]), i);
+
+    for (size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(table.intern(names[i]), i);
+
+    EXPECT_EQ(table.size(), names.size());
+}
+
 
 TEST(Lexer, TestKeyword) {
 
@@ -232,4 +326,43 @@ TEST(Lexer, TestArithmeticOperator) {
 }
 
 
+TEST(Lexer, TestConditionalKeyword) {
+
+    SourceCodeManager manager{codeConditional};
+    Lexer lex{codeConditional, manager};
+
+    for (Keyword::KeywordType type : {Keyword::KeywordType::If, Keyword::KeywordType::Then, Keyword::KeywordType::Else, Keyword::KeywordType::Min,
+                                      Keyword::KeywordType::Max, Keyword::KeywordType::Abs}) {
+
+        auto tk = lex.nextToken();
+        ASSERT_EQ(tk->tokentype, Token::TokenType::Keyword);
+        EXPECT_EQ(static_cast<Keyword&>(*tk).keywordtype, type);
+    }
+
+    // Keywords are only recognised as whole words
+    for (string name : {"IFS", "MINI"}) {
+
+        auto tk = lex.nextToken();
+        ASSERT_EQ(tk->tokentype, Token::TokenType::Identifier);
+        EXPECT_EQ(manager.getString(tk->location), name);
+    }
+}
+
+
+TEST(Lexer, TestComparisonOperator) {
+
+    SourceCodeManager manager{codeComparison};
+    Lexer lex{codeComparison, manager};
+
+    for (ArithmeticOperator::ArithmeticType type : {ArithmeticOperator::ArithmeticType::Less, ArithmeticOperator::ArithmeticType::LessEqual,
+                                                    ArithmeticOperator::ArithmeticType::NotEqual, ArithmeticOperator::ArithmeticType::Greater,
+                                                    ArithmeticOperator::ArithmeticType::GreaterEqual, ArithmeticOperator::ArithmeticType::Assign}) {
+
+        auto tk = lex.nextToken();
+        ASSERT_EQ(tk->tokentype, Token::TokenType::ArithmeticOperator);
+        EXPECT_EQ(static_cast<ArithmeticOperator&>(*tk).arithmetictype, type);
+    }
+}
+
+
 } // namespace jit::Tester
\ No newline at end of file
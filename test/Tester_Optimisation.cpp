@@ -1,8 +1,18 @@
 #include "gtest/gtest.h"
 
+#include "../pljit/Evaluation/EvalInstance.h"
+#include "../pljit/Evaluation/IrEvalInstance.h"
+#include "../pljit/IR/AlgebraicSimplifyOpt.h"
+#include "../pljit/IR/DeadValueOpt.h"
+#include "../pljit/IR/IrBuilder.h"
+#include "../pljit/IR/RangeAnalysisOpt.h"
+#include "../pljit/IR/StrengthReductionOpt.h"
+#include "../pljit/IR/ValueNumberingOpt.h"
 #include "../pljit/Parser/Parser.h"
+#include "../pljit/Pljit/PassManager.h"
 #include "../pljit/SemanticAnalysis/ConstantPropOpt.h"
 #include "../pljit/SemanticAnalysis/DeadCodeOpt.h"
+#include "../pljit/SemanticAnalysis/ForwardSubstitutionOpt.h"
 #include "../pljit/SemanticAnalysis/SemanticAnalyser.h"
 #include "pljit/Pljit/Pljit.h"
 
@@ -75,13 +85,53 @@ TEST(ConstantPropagationOptimisation, Test1) {
     // RETURN (a - 2 * b) + 3 * c + d ==> Check, if '3 * c + d' has been merged into a single literal node
     st = statements.statements[2].get();
     EXPECT_EQ(st->subtype, AstStatement::SubType::AstReturn);
-    ae = static_cast<AstReturn*>(st)->returnvalue.get();    // ae == '(a - 2 * b) + 3 * c + d' ==> Binary arithmetic expression
+    ae = static_cast<AstReturn*>(st)->returnvalues.front().get();    // ae == '(a - 2 * b) + 3 * c + d' ==> Binary arithmetic expression
     ASSERT_EQ(ae->subtype, AstArithmeticExpression::Subtype::Binary);
     ae = static_cast<AstBinaryArithmeticExpression*>(ae)->rhs.get(); // ae == '3 * c + d' ==> Check, if this is a literal
     EXPECT_EQ(ae->subtype, AstArithmeticExpression::Subtype::Literal);
 
 }
 
+TEST(ConstantPropagationOptimisation, FoldInPlace) {
+
+    string code = "PARAM a;\n"
+                  "VAR b;\n"
+                  "BEGIN\n"
+                  "b := a / (3 - 3);\n"
+                  "RETURN b + 2 * 5\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    Parser parser{code, manager};
+    auto parsetree = parser.parseFunction();
+    ASSERT_NE(parsetree, nullptr);
+
+    SemanticAnalyser seman{manager, *parsetree};
+    auto function = seman.analyseFunction();
+    ASSERT_NE(function, nullptr);
+
+    // The ids are dense: b, a, 3, 3, 3 - 3, a / (3 - 3) in the assignment, b, 2, 5, 2 * 5, b + 2 * 5 in the return statement
+    EXPECT_EQ(function->numberExpressions(), 11u);
+
+    auto& assignment = static_cast<AstAssignment&>(*function->statementlist->statements[0]);
+    auto& divisor = static_cast<AstBinaryArithmeticExpression&>(*assignment.rhs).rhs;
+    AstArithmeticExpression* three = static_cast<AstBinaryArithmeticExpression&>(*divisor).lhs.get();
+    EXPECT_EQ(divisor->id, 4u);
+
+    ConstantPropOpt constopt{};
+    function->optimise(constopt);
+    EXPECT_EQ(constopt.getNofChanges(), 2u);
+
+    // The literal '3' is reused for the folded divisor, which keeps the location of the whole divisor
+    ASSERT_EQ(divisor->subtype, AstArithmeticExpression::Subtype::Literal);
+    EXPECT_EQ(divisor.get(), three);
+    EXPECT_EQ(static_cast<AstLiteral&>(*divisor).value, 0);
+    EXPECT_EQ(manager.getString(divisor->location), "3 - 3");
+
+    EvalInstance ev{*function, manager};
+    EXPECT_EQ(ev.evaluate({7}), nullopt);
+}
+
 /*TEST(ConstantPropagationOptimisation, Test2) {
 
     // Parse the sourcecode
@@ -175,6 +225,185 @@ TEST(DeadCodeOptimisation, DeadCodeTest) {
 
 }
 
+// forwardSubstitution  Analyses the given source code, performs the Forward-Substitution optimisation and checks, that the results for the given arguments do not change.
+//                      Returns the number of remaining statements
+size_t forwardSubstitution(const string& code, const vector<vector<int64_t>>& arguments) {
+
+    SourceCodeManager manager{code};
+    Parser parser{code, manager};
+
+    auto parsetree = parser.parseFunction();
+    EXPECT_NE(parsetree, nullptr);
+
+    SemanticAnalyser seman{manager, *parsetree};
+    auto function = seman.analyseFunction();
+    EXPECT_NE(function, nullptr);
+
+    if (!function)
+        return 0;
+
+    vector<optional<int64_t>> expected{};
+    EvalInstance before{*function, manager};
+    for (const auto& args : arguments)
+        expected.push_back(before.evaluate(args));
+
+    ForwardSubstitutionOpt forwardopt{};
+    function->optimise(forwardopt);
+
+    EvalInstance after{*function, manager};
+    for (size_t i = 0; i < arguments.size(); ++i)
+        EXPECT_EQ(after.evaluate(arguments[i]), expected[i]);
+
+    return function->statementlist->statements.size();
+}
+
+TEST(ForwardSubstitutionOptimisation, SingleUseChain) {
+
+    string code = "PARAM a, b;\n"
+                  "VAR c, d;\n"
+                  "BEGIN\n"
+                  "c := a * 2;\n"
+                  "d := c + b;\n"
+                  "RETURN d\n"
+                  "END.\n";
 
+    EXPECT_EQ(forwardSubstitution(code, {{1, 2}, {-5, 7}}), 1u);
+}
+
+TEST(ForwardSubstitutionOptimisation, Copies) {
+
+    string code = "PARAM a;\n"
+                  "VAR c, d;\n"
+                  "BEGIN\n"
+                  "c := a;\n"
+                  "d := 3;\n"
+                  "RETURN c * c + d * c\n"
+                  "END.\n";
+
+    EXPECT_EQ(forwardSubstitution(code, {{1}, {-4}}), 1u);
+}
+
+TEST(ForwardSubstitutionOptimisation, ReassignedOperand) {
+
+    // 'a + 1' must not be moved behind the assignment to a, 'd' is used twice and is kept as well
+    string code = "PARAM a;\n"
+                  "VAR c, d;\n"
+                  "BEGIN\n"
+                  "c := a + 1;\n"
+                  "a := 5;\n"
+                  "d := c * a;\n"
+                  "RETURN d * d\n"
+                  "END.\n";
+
+    EXPECT_EQ(forwardSubstitution(code, {{1}, {-4}}), 3u);
+}
+
+TEST(ForwardSubstitutionOptimisation, Divisions) {
+
+    // Divisions by variables stay in place, so that the errors do not change
+    string code = "PARAM a, b;\n"
+                  "VAR c, d, e;\n"
+                  "BEGIN\n"
+                  "c := a / b;\n"
+                  "d := a / 2;\n"
+                  "e := d - 1;\n"
+                  "RETURN (c + e) / e\n"
+                  "END.\n";
+
+    EXPECT_EQ(forwardSubstitution(code, {{10, 3}, {10, 0}, {2, 1}}), 3u);
+}
+
+TEST(PassManager, FixedPoint) {
+
+    // The constant propagation replaces the uses of b and c, afterwards the forward substitution removes their assignments
+    string code = "PARAM a;\n"
+                  "VAR b, c;\n"
+                  "BEGIN\n"
+                  "b := 2 * 3;\n"
+                  "c := b + b;\n"
+                  "RETURN a * c + c\n"
+                  "END.\n";
+
+    SourceCodeManager manager{code};
+    Parser parser{code, manager};
+    auto parsetree = parser.parseFunction();
+    ASSERT_NE(parsetree, nullptr);
+
+    SemanticAnalyser seman{manager, *parsetree};
+    auto function = seman.analyseFunction();
+    ASSERT_NE(function, nullptr);
+
+    PassManager passmanager{};
+    passmanager.addPass("deadcode", make_unique<DeadCodeOpt>());
+    passmanager.addPass("forwardsubstitution", make_unique<ForwardSubstitutionOpt>(), true);
+    passmanager.addPass("constantprop", make_unique<ConstantPropOpt>(), true);
+    passmanager.run(*function);
+
+    EXPECT_EQ(function->statementlist->statements.size(), 1u);
+
+    EvalInstance ev{*function, manager};
+    EXPECT_EQ(ev.evaluate({5}), 5 * 12 + 12);
+
+    // The group is repeated until a run without changes
+    vector<PassStatistics> statistics = passmanager.getStatistics();
+    ASSERT_EQ(statistics.size(), 3u);
+
+    EXPECT_EQ(statistics[0].name, "deadcode");
+    EXPECT_EQ(statistics[0].runs, 1u);
+    EXPECT_EQ(statistics[0].changes, 0u);
+    EXPECT_EQ(statistics[1].runs, 3u);
+    EXPECT_EQ(statistics[1].changes, 2u);
+    EXPECT_EQ(statistics[2].runs, 3u);
+    EXPECT_EQ(statistics[2].changes, 4u);
+}
+
+TEST(PassManager, IrFixedPoint) {
+
+    // Multiplications by powers of two are reduced to shifts, which the algebraic simplification keeps, so the passes do not undo each other
+    for (string code : {"PARAM a, b;\nBEGIN\nRETURN a / 7 + b * 8\nEND.\n", "PARAM a, b, c;\nBEGIN\nRETURN a * 4 + b * 4 + c * 4 + a / 3\nEND.\n",
+                        "PARAM a, b;\nBEGIN\nRETURN 3 - b * 8 + (a + 1) * -16\nEND.\n"}) {
+
+        SourceCodeManager manager{code};
+        Parser parser{code, manager};
+        auto parsetree = parser.parseFunction();
+        ASSERT_NE(parsetree, nullptr);
+
+        SemanticAnalyser seman{manager, *parsetree};
+        auto function = seman.analyseFunction();
+        ASSERT_NE(function, nullptr);
+
+        auto ir = IrBuilder{*function}.buildFunction();
+        ASSERT_NE(ir, nullptr);
+
+        PassManager passmanager{};
+        passmanager.addPass("algebraicsimplify", make_unique<AlgebraicSimplifyOpt>(), true);
+        passmanager.addPass("valuenumbering", make_unique<ValueNumberingOpt>(), true);
+        passmanager.addPass("strengthreduction", make_unique<StrengthReductionOpt>(), true);
+        passmanager.addPass("rangeanalysis", make_unique<RangeAnalysisOpt>(), true);
+        passmanager.addPass("deadvalue", make_unique<DeadValueOpt>(), true);
+        passmanager.run(*ir);
+
+        // The second round does not change the function anymore (far less than the maximal number of rounds)
+        static_assert(PassManager::defaultMaxIterations > 2);
+        for (const PassStatistics& statistics : passmanager.getStatistics())
+            EXPECT_EQ(statistics.runs, 2u);
+
+        size_t nofmul = 0;
+        for (const IrInstruction& instr : ir->instructions)
+            nofmul += instr.opcode == IrInstruction::Opcode::Mul;
+        EXPECT_EQ(nofmul, 0u);
+
+        EvalInstance ev{*function, manager};
+        IrEvalInstance irev{*ir, manager};
+
+        for (int64_t a : {-9, 0, 5})
+            for (int64_t b : {-2, 7})
+                for (int64_t c : {3}) {
+                    vector<int64_t> args{a, b, c};
+                    args.resize(ir->nofparameters);
+                    EXPECT_EQ(irev.evaluate(args), ev.evaluate(args));
+                }
+    }
+}
 
-} // namespace jit::Tester_Optimisation
\ No newline at end of file
+} // namespace jit::Tester_Optimisation
@@ -170,4 +170,181 @@ TEST(Parser, code7) {
 
 
 
-} // namespace jit::Tester_Parser
\ No newline at end of file
+string code8 = "PARAM a, b, c;\n"
+               "BEGIN\n"
+               "RETURN -(a - b) * c - b - (c)\n"
+               "END.\n";
+
+TEST(Parser, ExpressionShape) {
+
+    SourceCodeManager manager{code8};
+    Parser parser{code8, manager};
+
+    auto f = parser.parseFunction();
+    ASSERT_NE(f, nullptr);
+
+    const StatementList* sl = f->getStatements();
+    ASSERT_NE(sl, nullptr);
+
+    // RETURN additive-expr
+    const Statement& st = static_cast<const Statement&>(*sl->nodes[0]);
+    ASSERT_EQ(st.nodes[1]->nodetype, ParseTreeNode::Type::AdditiveExpr);
+
+    // The additive expression is right recursive: (-(a - b) * c) - (b - (c))
+    const AdditiveExprNode& add = static_cast<const AdditiveExprNode&>(*st.nodes[1]);
+    ASSERT_EQ(add.subtype, AdditiveExprNode::SubType::Binary);
+    ASSERT_EQ(add.nodes.size(), 3);
+    EXPECT_EQ(manager.getString(add.location), "-(a - b) * c - b - (c)");
+    EXPECT_EQ(manager.getString(add.nodes[0]->location), "-(a - b) * c");
+    EXPECT_EQ(manager.getString(add.nodes[2]->location), "b - (c)");
+
+    // -(a - b) * c
+    const MultExprNode& mult = static_cast<const MultExprNode&>(*add.nodes[0]);
+    ASSERT_EQ(mult.subtype, MultExprNode::SubType::Binary);
+    const UnaryExprNode& unary = static_cast<const UnaryExprNode&>(*mult.nodes[0]);
+    EXPECT_EQ(unary.subtype, UnaryExprNode::SubType::Minus);
+    EXPECT_EQ(manager.getString(unary.location), "-(a - b)");
+
+    // (a - b)
+    const PrimaryExprNode& primary = static_cast<const PrimaryExprNode&>(*unary.nodes[1]);
+    EXPECT_EQ(primary.subtype, PrimaryExprNode::SubType::AdditiveExpr);
+    EXPECT_EQ(manager.getString(primary.location), "(a - b)");
+}
+
+string code9 = "PARAM a;\n"
+               "BEGIN\n"
+               "RETURN ((a + 1) * (a)\n"        // Error: missing ')'
+               "END.\n";
+
+TEST(Parser, MissingParenthesis) {
+
+    SourceCodeManager manager{code9};
+    Parser parser{code9, manager};
+
+    auto f = parser.parseFunction();
+    ASSERT_EQ(f, nullptr);
+}
+
+TEST(Parser, NestingLimit) {
+
+    string code = "PARAM a;\nBEGIN\nRETURN ((((a))))\nEND.\n";
+
+    SourceCodeManager manager{code};
+
+    Parser parser1{code, manager, 4};
+    EXPECT_NE(parser1.parseFunction(), nullptr);
+
+    Parser parser2{code, manager, 3};
+    EXPECT_EQ(parser2.parseFunction(), nullptr);
+}
+
+TEST(Parser, Call) {
+
+    string code = "PARAM a;\nBEGIN\nRETURN 1 + CALL f(a * 2, CALL g()) * 3\nEND.\n";
+
+    SourceCodeManager manager{code};
+    Parser parser{code, manager};
+
+    auto f = parser.parseFunction();
+    ASSERT_NE(f, nullptr);
+
+    // 1 + (CALL ... * 3)
+    const Statement& st = static_cast<const Statement&>(*f->getStatements()->nodes[0]);
+    const AdditiveExprNode& add = static_cast<const AdditiveExprNode&>(*st.nodes[1]);
+    const AdditiveExprNode& rhs = static_cast<const AdditiveExprNode&>(*add.nodes[2]);
+    const MultExprNode& mult = static_cast<const MultExprNode&>(*rhs.nodes[0]);
+    const UnaryExprNode& unary = static_cast<const UnaryExprNode&>(*mult.nodes[0]);
+
+    // CALL f ( a * 2 , CALL g ( ) )
+    const PrimaryExprNode& call = static_cast<const PrimaryExprNode&>(*unary.nodes[0]);
+    ASSERT_EQ(call.subtype, PrimaryExprNode::SubType::Call);
+    ASSERT_EQ(call.nodes.size(), 7);
+    EXPECT_EQ(manager.getString(call.location), "CALL f(a * 2, CALL g())");
+    EXPECT_EQ(manager.getString(call.nodes[1]->location), "f");
+    EXPECT_EQ(manager.getString(call.nodes[3]->location), "a * 2");
+    EXPECT_EQ(manager.getString(call.nodes[5]->location), "CALL g()");
+
+    // Invalid calls
+    for (string invalid : {"BEGIN\nRETURN CALL f\nEND.\n", "BEGIN\nRETURN CALL (1)\nEND.\n", "BEGIN\nRETURN CALL f(1,)\nEND.\n", "BEGIN\nRETURN CALL f(1\nEND.\n"}) {
+
+        SourceCodeManager m{invalid};
+        Parser p{invalid, m};
+        EXPECT_EQ(p.parseFunction(), nullptr);
+    }
+
+    // Nested calls count against the nesting limit
+    string nested = "BEGIN\nRETURN CALL f(CALL f(CALL f(1)))\nEND.\n";
+    SourceCodeManager m{nested};
+
+    Parser parser1{nested, m, 3};
+    EXPECT_NE(parser1.parseFunction(), nullptr);
+
+    Parser parser2{nested, m, 2};
+    EXPECT_EQ(parser2.parseFunction(), nullptr);
+}
+
+TEST(Parser, MultipleResults) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN a + b, a * b, 1\nEND.\n";
+
+    SourceCodeManager manager{code};
+    Parser parser{code, manager};
+
+    auto f = parser.parseFunction();
+    ASSERT_NE(f, nullptr);
+
+    // RETURN a + b , a * b , 1
+    const Statement& st = static_cast<const Statement&>(*f->getStatements()->nodes[0]);
+    ASSERT_EQ(st.subtype, Statement::SubType::Return);
+    ASSERT_EQ(st.nodes.size(), 6);
+    EXPECT_EQ(manager.getString(st.location), "RETURN a + b, a * b, 1");
+    EXPECT_EQ(manager.getString(st.nodes[1]->location), "a + b");
+    EXPECT_EQ(manager.getString(st.nodes[3]->location), "a * b");
+    EXPECT_EQ(manager.getString(st.nodes[5]->location), "1");
+
+    // Invalid return statements
+    for (string invalid : {"BEGIN\nRETURN 1,\nEND.\n", "BEGIN\nRETURN , 1\nEND.\n", "BEGIN\nRETURN 1 2\nEND.\n"}) {
+
+        SourceCodeManager m{invalid};
+        Parser p{invalid, m};
+        EXPECT_EQ(p.parseFunction(), nullptr);
+    }
+}
+
+TEST(Parser, Conditional) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN IF a + 1 <> b THEN MAX(a, ABS(b)) ELSE MIN(a, 0) * 2\nEND.\n";
+
+    SourceCodeManager manager{code};
+    Parser parser{code, manager};
+
+    auto f = parser.parseFunction();
+    ASSERT_NE(f, nullptr);
+
+    // The alternatives extend as far as possible: IF ... ELSE (MIN(a, 0) * 2)
+    const Statement& st = static_cast<const Statement&>(*f->getStatements()->nodes[0]);
+    const AdditiveExprNode& add = static_cast<const AdditiveExprNode&>(*st.nodes[1]);
+    const MultExprNode& mult = static_cast<const MultExprNode&>(*add.nodes[0]);
+    const UnaryExprNode& unary = static_cast<const UnaryExprNode&>(*mult.nodes[0]);
+
+    // IF a + 1 <> b THEN MAX(a, ABS(b)) ELSE MIN(a, 0) * 2
+    const PrimaryExprNode& conditional = static_cast<const PrimaryExprNode&>(*unary.nodes[0]);
+    ASSERT_EQ(conditional.subtype, PrimaryExprNode::SubType::Conditional);
+    ASSERT_EQ(conditional.nodes.size(), 8);
+    EXPECT_EQ(manager.getString(conditional.nodes[1]->location), "a + 1");
+    EXPECT_EQ(static_cast<const GenericTerminalNode&>(*conditional.nodes[2]).subtype, GenericTerminalNode::SubType::NotEqual);
+    EXPECT_EQ(manager.getString(conditional.nodes[3]->location), "b");
+    EXPECT_EQ(manager.getString(conditional.nodes[5]->location), "MAX(a, ABS(b))");
+    EXPECT_EQ(manager.getString(conditional.nodes[7]->location), "MIN(a, 0) * 2");
+
+    // Invalid conditional expressions and intrinsics
+    for (string invalid : {"BEGIN\nRETURN IF 1 THEN 2 ELSE 3\nEND.\n", "BEGIN\nRETURN IF 1 < 2 THEN 2\nEND.\n", "BEGIN\nRETURN IF 1 < 2 ELSE 3\nEND.\n",
+                           "BEGIN\nRETURN IF 1 := 2 THEN 2 ELSE 3\nEND.\n", "BEGIN\nRETURN MIN 1, 2\nEND.\n", "BEGIN\nRETURN ABS(1,)\nEND.\n"}) {
+
+        SourceCodeManager m{invalid};
+        Parser p{invalid, m};
+        EXPECT_EQ(p.parseFunction(), nullptr);
+    }
+}
+
+} // namespace jit::Tester_Parser
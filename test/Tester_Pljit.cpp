@@ -2,6 +2,7 @@
 #include "gtest/gtest.h"
 #include "pljit/Pljit/Pljit.h"
 
+#include <limits>
 #include <thread>
 
 using namespace std;
@@ -99,4 +100,630 @@ TEST(Pljit, test2) {
 
 }
 
-} // namespace jit::Tester_Pljit
\ No newline at end of file
+string makeLongSum(size_t terms) {
+
+    string code = "PARAM a, b;\nBEGIN\nRETURN a";
+
+    for (size_t i = 1; i < terms; ++i)
+        code += (i % 2) ? " + b * a" : " - a";
+
+    return code + "\nEND.\n";
+}
+
+string makeNestedParentheses(size_t depth) {
+
+    return "PARAM a;\nBEGIN\nRETURN " + string(depth, '(') + "a" + string(depth, ')') + "\nEND.\n";
+}
+
+TEST(Pljit, LongExpression) {
+
+    Pljit jit{};
+
+    // 100000 terms result in an Ast of depth 100000 (the grammar is right recursive)
+    auto h = jit.registerFunction(makeLongSum(100000));
+
+    auto result = h({3, 2});
+    ASSERT_TRUE(result);
+
+    // The terms alternate between 'a' and 'b * a', the operators between '+' and '-'. As the grammar is right recursive, the expression is evaluated from the right
+    auto term = [](size_t i) -> int64_t { return (i % 2) ? 2 * 3 : 3; };
+
+    int64_t expected = term(99999);
+    for (size_t i = 99999; i-- > 0;)
+        expected = ((i + 1) % 2) ? term(i) + expected : term(i) - expected;
+
+    EXPECT_EQ(result.value(), expected);
+}
+
+TEST(Pljit, NestingLimit) {
+
+    Pljit jit{50};
+
+    auto h1 = jit.registerFunction(makeNestedParentheses(50));
+    auto h2 = jit.registerFunction(makeNestedParentheses(51));
+
+    EXPECT_EQ(h1({7}), 7);
+    EXPECT_EQ(h2({7}), nullopt);
+}
+
+TEST(Pljit, Specialize) {
+
+    Pljit jit{};
+
+    string code = "PARAM a, b, c;\n"
+                  "VAR d;\n"
+                  "BEGIN\n"
+                  "d := (a + b) * c;\n"
+                  "RETURN d / (b - 2)\n"
+                  "END.\n";
+
+    auto h = jit.registerFunction(code);
+
+    // b = 4: (a + 4) * c / 2
+    auto hb = jit.specialize(h, {{1, 4}});
+    EXPECT_EQ(hb({1, 6}), (1 + 4) * 6 / 2);
+    EXPECT_EQ(hb({1, 6, 7}), nullopt);
+
+    // The indices of specialised handles refer to their remaining parameters: c = 3 is the second parameter of hb
+    auto hbc = jit.specialize(hb, {{1, 3}});
+    EXPECT_EQ(hbc({5}), (5 + 4) * 3 / 2);
+
+    // Several parameters at once, the original handle is unchanged
+    auto hac = jit.specialize(h, {{0, 10}, {2, -1}});
+    EXPECT_EQ(hac({7}), (10 + 7) * -1 / 5);
+    EXPECT_EQ(h({10, 7, -1}), (10 + 7) * -1 / 5);
+
+    // Division by zero is still reported
+    auto hzero = jit.specialize(h, {{1, 2}});
+    EXPECT_EQ(hzero({1, 1}), nullopt);
+
+    // Invalid bindings and handles
+    auto hinvalid = jit.specialize(h, {{3, 1}});
+    EXPECT_EQ(hinvalid({1, 2, 3}), nullopt);
+
+    Pljit other{};
+    auto hother = other.specialize(h, {{0, 1}});
+    EXPECT_EQ(hother({1, 2}), nullopt);
+}
+
+TEST(Pljit, ValueProfile) {
+
+    Pljit jit{Pljit::defaultMaxNestingDepth, 10};
+
+    string code = "PARAM a, b;\n"
+                  "BEGIN\n"
+                  "RETURN a * b + a / b\n"
+                  "END.\n";
+
+    auto h = jit.registerFunction(code);
+
+    // b is stable while the function is profiled, a is not
+    for (int64_t a = 0; a < 10; ++a)
+        EXPECT_EQ(h({a, 3}), a * 3 + a / 3);
+
+    // Calls matching the guard and calls falling back to the generic function
+    EXPECT_EQ(h({100, 3}), 100 * 3 + 100 / 3);
+    EXPECT_EQ(h({100, 7}), 100 * 7 + 100 / 7);
+    EXPECT_EQ(h({100, 0}), nullopt);
+    EXPECT_EQ(h({100}), nullopt);
+
+    // Concurrent calls while the profile is recorded
+    auto h2 = jit.registerFunction(code);
+
+    vector<thread> threads{};
+    for (int64_t t = 0; t < 8; ++t)
+        threads.emplace_back([h2, t]() mutable {
+            for (int64_t a = 0; a < 100; ++a)
+                EXPECT_EQ(h2({a, t % 2 + 1}), a * (t % 2 + 1) + a / (t % 2 + 1));
+        });
+
+    for (auto& th : threads)
+        th.join();
+}
+
+TEST(Pljit, OptimisationLevels) {
+
+    Pljit jit0{Pljit::defaultMaxNestingDepth, 0, OptimisationLevel::O0};
+    Pljit jit1{Pljit::defaultMaxNestingDepth, 0, OptimisationLevel::O1};
+    Pljit jit2{};
+
+    string code = "PARAM a, b;\n"
+                  "VAR c, d;\n"
+                  "BEGIN\n"
+                  "c := (a + b) * (a + b);\n"
+                  "d := c / 8 - c / (b - 1);\n"
+                  "RETURN d + 2 * 3\n"
+                  "END.\n";
+
+    auto h0 = jit0.registerFunction(code);
+    auto h1 = jit1.registerFunction(code);
+    auto h2 = jit2.registerFunction(code);
+
+    // No statistics before the function has been compiled
+    EXPECT_TRUE(jit2.getPassStatistics(h2).empty());
+
+    for (int64_t a = -3; a <= 3; ++a) {
+        for (int64_t b = -3; b <= 3; ++b) {
+            optional<int64_t> expected = b == 1 ? nullopt : optional<int64_t>{(a + b) * (a + b) / 8 - (a + b) * (a + b) / (b - 1) + 6};
+            EXPECT_EQ(h0({a, b}), expected);
+            EXPECT_EQ(h1({a, b}), expected);
+            EXPECT_EQ(h2({a, b}), expected);
+        }
+    }
+
+    EXPECT_TRUE(jit0.getPassStatistics(h0).empty());
+    EXPECT_EQ(jit1.getPassStatistics(h1).size(), 6u);
+
+    vector<PassStatistics> statistics = jit2.getPassStatistics(h2);
+    ASSERT_FALSE(statistics.empty());
+    EXPECT_EQ(statistics.front().name, "deadcode");
+    EXPECT_EQ(statistics.back().name, "treebalancing");
+
+    size_t changes = 0;
+    for (const PassStatistics& s : statistics)
+        changes += s.changes;
+    EXPECT_GT(changes, 0u);
+
+    EXPECT_TRUE(jit1.getPassStatistics(h2).empty());
+}
+
+TEST(Pljit, Memoisation) {
+
+    Pljit jit{};
+
+    string code = "PARAM a, b;\n"
+                  "BEGIN\n"
+                  "RETURN a / b + a * b\n"
+                  "END.\n";
+
+    auto h = jit.registerFunction(code);
+    EXPECT_EQ(jit.getMemoStatistics(h), nullopt);
+
+    jit.memoise(h, MemoConfig{2, 1, EvictionPolicy::LeastRecentlyUsed, 0, 0});
+
+    EXPECT_EQ(h({1, 2}), 0 + 2);        // miss
+    EXPECT_EQ(h({1, 2}), 0 + 2);        // hit
+    EXPECT_EQ(h({3, 4}), 0 + 12);       // miss
+    EXPECT_EQ(h({1, 2}), 0 + 2);        // hit, (3, 4) is the least recently used result now
+    EXPECT_EQ(h({5, 6}), 0 + 30);       // miss, evicts (3, 4)
+    EXPECT_EQ(h({5, 6}), 0 + 30);       // hit
+    EXPECT_EQ(h({3, 4}), 0 + 12);       // miss, evicts (1, 2)
+
+    // Failed calls are not cached
+    EXPECT_EQ(h({1, 0}), nullopt);
+    EXPECT_EQ(h({1, 0}), nullopt);
+    EXPECT_EQ(h({1}), nullopt);
+
+    optional<MemoStatistics> statistics = jit.getMemoStatistics(h);
+    ASSERT_NE(statistics, nullopt);
+    EXPECT_EQ(statistics->hits, 3u);
+    EXPECT_EQ(statistics->misses, 6u);
+    EXPECT_EQ(statistics->evictions, 2u);
+    EXPECT_TRUE(statistics->enabled);
+
+    // The cache can only be enabled once
+    jit.memoise(h);
+    EXPECT_EQ(jit.getMemoStatistics(h)->misses, 6u);
+
+    // First in first out: lookups do not change the evicted result
+    auto hfifo = jit.registerFunction(code);
+    jit.memoise(hfifo, MemoConfig{2, 1, EvictionPolicy::FirstInFirstOut, 0, 0});
+
+    for (const vector<int64_t>& args : vector<vector<int64_t>>{{1, 2}, {3, 4}, {1, 2}, {5, 6}, {3, 4}, {1, 2}})
+        EXPECT_EQ(hfifo(args), args[0] / args[1] + args[0] * args[1]);
+
+    EXPECT_EQ(jit.getMemoStatistics(hfifo)->hits, 2u);
+    EXPECT_EQ(jit.getMemoStatistics(hfifo)->evictions, 2u);
+}
+
+TEST(Pljit, MemoisationDisabled) {
+
+    Pljit jit{};
+
+    string code = "PARAM a;\n"
+                  "BEGIN\n"
+                  "RETURN a * a\n"
+                  "END.\n";
+
+    auto h = jit.registerFunction(code);
+    jit.memoise(h, MemoConfig{1024, 4, EvictionPolicy::LeastRecentlyUsed, 50, 100});
+
+    // Distinct arguments only, the cache is disabled after 100 lookups
+    for (int64_t a = 0; a < 200; ++a)
+        EXPECT_EQ(h({a}), a * a);
+
+    MemoStatistics statistics = *jit.getMemoStatistics(h);
+    EXPECT_FALSE(statistics.enabled);
+    EXPECT_EQ(statistics.hits + statistics.misses, 100u);
+
+    // Concurrent calls with repeated arguments
+    auto h2 = jit.registerFunction(code);
+    jit.memoise(h2);
+
+    vector<thread> threads{};
+    for (int64_t t = 0; t < 8; ++t)
+        threads.emplace_back([h2]() mutable {
+            for (int64_t a = 0; a < 1000; ++a)
+                EXPECT_EQ(h2({a % 10}), (a % 10) * (a % 10));
+        });
+
+    for (auto& th : threads)
+        th.join();
+
+    statistics = *jit.getMemoStatistics(h2);
+    EXPECT_EQ(statistics.hits + statistics.misses, 8000u);
+    EXPECT_GE(statistics.hits, 8000u - 8u * 10u);
+    EXPECT_TRUE(statistics.enabled);
+}
+
+TEST(Pljit, ConstantFunctions) {
+
+    Pljit jit{};
+
+    auto hconst = jit.registerFunction("CONST x = 3;\nBEGIN\nRETURN x * 7\nEND.\n");
+    EXPECT_TRUE(jit.isConstant(hconst));
+    EXPECT_EQ(hconst({}), 21);
+    EXPECT_EQ(hconst({1}), nullopt);
+
+    // The result does not depend on the parameter after the optimisation
+    auto hcancel = jit.registerFunction("PARAM a;\nBEGIN\nRETURN 5 + a - a\nEND.\n");
+    EXPECT_EQ(hcancel({9}), 5);
+    EXPECT_TRUE(jit.isConstant(hcancel));
+    EXPECT_EQ(hcancel({-4}), 5);
+
+    // Functions that fail are not constant, their errors are reported on every call
+    auto hfail = jit.registerFunction("BEGIN\nRETURN 1 / 0\nEND.\n");
+    EXPECT_FALSE(jit.isConstant(hfail));
+    EXPECT_EQ(hfail({}), nullopt);
+
+    auto hparam = jit.registerFunction("PARAM a;\nBEGIN\nRETURN a / 2 + 1\nEND.\n");
+    EXPECT_FALSE(jit.isConstant(hparam));
+    EXPECT_EQ(hparam({6}), 4);
+
+    // Binding all parameters results in a constant function
+    auto hbound = jit.specialize(hparam, {{0, 10}});
+    EXPECT_TRUE(jit.isConstant(hbound));
+    EXPECT_EQ(hbound({}), 6);
+
+    auto hinvalid = jit.registerFunction("BEGIN\nRETURN x\nEND.\n");
+    EXPECT_FALSE(jit.isConstant(hinvalid));
+
+    // Without optimisations, functions without parameters are still evaluated once
+    Pljit jit0{Pljit::defaultMaxNestingDepth, 0, OptimisationLevel::O0};
+    auto h0 = jit0.registerFunction("BEGIN\nRETURN 1 + 2 * 3\nEND.\n");
+    EXPECT_TRUE(jit0.isConstant(h0));
+    EXPECT_EQ(h0({}), 7);
+}
+
+TEST(Pljit, EvaluateMany) {
+
+    Pljit jit{};
+
+    vector<Pljit::PljitHandle> handles{};
+    handles.push_back(jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN (a + b) * (a - b) + 1\nEND.\n"));
+    handles.push_back(jit.registerFunction("PARAM x, y;\nVAR z;\nBEGIN\nz := (x + y) * (x - y);\nRETURN z / 3\nEND.\n"));
+    handles.push_back(jit.registerFunction("PARAM a;\nBEGIN\nRETURN a\nEND.\n"));
+    handles.push_back(jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN c\nEND.\n"));
+    handles.push_back(jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN a / b\nEND.\n"));
+    handles.push_back(jit.registerFunction("CONST c = 4;\nBEGIN\nRETURN c * c\nEND.\n"));
+
+    vector<optional<int64_t>> results{};
+
+    // Functions with another number of parameters and invalid functions fail on their own
+    for (int64_t a = -3; a <= 3; ++a) {
+        for (int64_t b = 1; b <= 3; ++b) {
+
+            jit.evaluateMany(handles, {a, b}, results);
+
+            ASSERT_EQ(results.size(), handles.size());
+            EXPECT_EQ(results[0], (a + b) * (a - b) + 1);
+            EXPECT_EQ(results[1], (a + b) * (a - b) / 3);
+            EXPECT_EQ(results[2], nullopt);
+            EXPECT_EQ(results[3], nullopt);
+            EXPECT_EQ(results[4], a / b);
+            EXPECT_EQ(results[5], nullopt);
+        }
+    }
+
+    // If a function fails, the others are evaluated one by one
+    jit.evaluateMany(handles, {5, 0}, results);
+    EXPECT_EQ(results[0], 26);
+    EXPECT_EQ(results[1], 8);
+    EXPECT_EQ(results[4], nullopt);
+
+    // Another group (and another number of arguments) is fused on its own
+    jit.evaluateMany({handles[5], handles[2]}, {}, results);
+    EXPECT_EQ(results, (vector<optional<int64_t>>{16, nullopt}));
+
+    jit.evaluateMany({handles[2], handles[0]}, {7}, results);
+    EXPECT_EQ(results, (vector<optional<int64_t>>{7, nullopt}));
+
+    jit.evaluateMany({}, {1, 2}, results);
+    EXPECT_TRUE(results.empty());
+
+    Pljit other{};
+    other.evaluateMany(handles, {1, 2}, results);
+    EXPECT_EQ(results, vector<optional<int64_t>>(handles.size(), nullopt));
+}
+
+TEST(Pljit, Calls) {
+
+    string square = "PARAM x;\nBEGIN\nRETURN x * x\nEND.\n";
+    string distance = "PARAM a, b;\nVAR d;\nBEGIN\nd := CALL square(a) + CALL square(b);\nRETURN d / 2\nEND.\n";
+    string caller = "PARAM p, q;\nBEGIN\nRETURN CALL distance(p + 1, q) - CALL distance(p + 1, q) / (q - 3)\nEND.\n";
+
+    // A function that is too large to be inlined into the Ast
+    string wide = "PARAM a;\nBEGIN\nRETURN a";
+    for (int i = 1; i <= 100; ++i)
+        wide += " + a / " + to_string(i);
+    wide += "\nEND.\n";
+
+    for (OptimisationLevel level : {OptimisationLevel::O0, OptimisationLevel::O1, OptimisationLevel::O2}) {
+
+        Pljit jit{Pljit::defaultMaxNestingDepth, 0, level};
+
+        jit.registerFunction(square, "square");
+        jit.registerFunction(distance, "distance");
+        jit.registerFunction(wide, "wide");
+
+        auto h = jit.registerFunction(caller);
+        auto hconst = jit.registerFunction("BEGIN\nRETURN CALL distance(3, 4) + CALL square(2)\nEND.\n");
+        auto hwide = jit.registerFunction("PARAM a;\nBEGIN\nRETURN CALL wide(a) - CALL wide(a + 1)\nEND.\n");
+
+        for (int64_t p = -3; p <= 3; ++p) {
+            for (int64_t q = -3; q <= 3; ++q) {
+                int64_t d = ((p + 1) * (p + 1) + q * q) / 2;
+                EXPECT_EQ(h({p, q}), q == 3 ? nullopt : optional<int64_t>{d - d / (q - 3)});
+            }
+        }
+
+        EXPECT_EQ(hconst({}), 12 + 4);
+
+        int64_t expected = 0;
+        for (int64_t a : {5, 6}) {
+            int64_t sum = a;
+            for (int64_t i = 1; i <= 100; ++i)
+                sum += a / i;
+            expected = a == 5 ? sum : expected - sum;
+        }
+        EXPECT_EQ(hwide({5}), expected);
+
+        // The small functions are inlined into the Ast, so the constant propagation folds their calls (the call of 'square' in 'distance' has been inlined already)
+        if (level != OptimisationLevel::O0) {
+
+            EXPECT_TRUE(jit.isConstant(hconst));
+
+            vector<PassStatistics> statistics = jit.getPassStatistics(hconst);
+            ASSERT_EQ(statistics[1].name, "inlining");
+            EXPECT_EQ(statistics[1].changes, 2u);
+
+            statistics = jit.getPassStatistics(hwide);
+            ASSERT_EQ(statistics[1].name, "inlining");
+            EXPECT_EQ(statistics[1].changes, 0u);
+        }
+    }
+}
+
+TEST(Pljit, CallErrors) {
+
+    Pljit jit{};
+
+    jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN a / b\nEND.\n", "divide");
+    jit.registerFunction("PARAM a;\nBEGIN\nRETURN CALL odd(a - 1)\nEND.\n", "even");
+    jit.registerFunction("PARAM a;\nBEGIN\nRETURN CALL even(a - 1)\nEND.\n", "odd");
+    jit.registerFunction("BEGIN\nRETURN CALL self()\nEND.\n", "self");
+    jit.registerFunction("BEGIN\nRETURN x\nEND.\n", "invalid");
+
+    // The name is already used, the function can only be called by its handle
+    auto duplicate = jit.registerFunction("BEGIN\nRETURN 1\nEND.\n", "divide");
+    EXPECT_EQ(duplicate({}), 1);
+
+    // Divisions by 0 in the called function are reported at the call
+    auto h = jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN CALL divide(a, b) + 1\nEND.\n");
+    EXPECT_EQ(h({7, 2}), 4);
+    EXPECT_EQ(h({7, 0}), nullopt);
+
+    EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN CALL unknown(1)\nEND.\n")({}), nullopt);
+    EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN CALL divide(1)\nEND.\n")({}), nullopt);
+    EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN CALL invalid()\nEND.\n")({}), nullopt);
+    EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN CALL self()\nEND.\n")({}), nullopt);
+    EXPECT_EQ(jit.registerFunction("PARAM a;\nBEGIN\nRETURN CALL even(a)\nEND.\n")({4}), nullopt);
+}
+
+TEST(Pljit, CallErrorOrder) {
+
+    string callee = "PARAM y;\nVAR t;\nBEGIN\nt := 100 / y;\nRETURN t\nEND.\n";
+
+    // The location of the first error at every optimisation level
+    vector<vector<string>> reported(3);
+
+    for (OptimisationLevel level : {OptimisationLevel::O0, OptimisationLevel::O1, OptimisationLevel::O2}) {
+
+        Pljit jit{Pljit::defaultMaxNestingDepth, 0, level};
+        jit.registerFunction(callee, "f");
+
+        // The division before the call fails first, the statements of the called function must not be moved in front of it
+        auto before = jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN 1 / a + CALL f(b)\nEND.\n");
+        auto argument = jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN 1 / a + CALL f(10 / b)\nEND.\n");
+
+        // Nothing evaluated before the call may fail, so it is still inlined into the Ast
+        auto after = jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN CALL f(b) + 1 / a\nEND.\n");
+
+        for (Pljit::PljitHandle h : {before, argument, after}) {
+
+            testing::internal::CaptureStderr();
+            EXPECT_EQ(h({0, 0}), nullopt);
+            string error = testing::internal::GetCapturedStderr();
+            reported[static_cast<size_t>(level)].push_back(error.substr(0, error.find(':', error.find(':') + 1)));
+        }
+
+        EXPECT_EQ(before({1, 4}), 1 + 25);
+        EXPECT_EQ(after({1, 4}), 25 + 1);
+
+        if (level != OptimisationLevel::O0) {
+
+            vector<PassStatistics> statistics = jit.getPassStatistics(after);
+            ASSERT_EQ(statistics[1].name, "inlining");
+            EXPECT_EQ(statistics[1].changes, 1u);
+        }
+    }
+
+    EXPECT_EQ(reported[0], (vector<string>{"3:12", "3:12", "3:8"}));
+    EXPECT_EQ(reported[1], reported[0]);
+    EXPECT_EQ(reported[2], reported[0]);
+}
+
+TEST(Pljit, Compose) {
+
+    for (OptimisationLevel level : {OptimisationLevel::O0, OptimisationLevel::O1, OptimisationLevel::O2}) {
+
+        Pljit jit{Pljit::defaultMaxNestingDepth, 0, level};
+
+        auto base = jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN a * 3 + b\nEND.\n");
+        auto scale = jit.registerFunction("PARAM f, x;\nBEGIN\nRETURN (x * f) / 4\nEND.\n");
+        auto clamp = jit.registerFunction("PARAM x, d;\nBEGIN\nRETURN x - x / d\nEND.\n");
+
+        // base(a, b) is passed to parameter x of scale, its result to parameter x of clamp. The pipeline takes a, b, f and d
+        auto h = jit.compose({base, scale, clamp}, {1, 0});
+
+        for (int64_t a = -3; a <= 3; ++a) {
+            for (int64_t d = -2; d <= 2; ++d) {
+                int64_t x = (a * 3 + 5) * 7 / 4;
+                EXPECT_EQ(h({a, 5, 7, d}), d == 0 ? nullopt : optional<int64_t>{x - x / d});
+            }
+        }
+
+        EXPECT_EQ(h({1, 2, 3}), nullopt);
+
+        // Pipelines can be specialised and composed further
+        auto specialised = jit.specialize(h, {{2, 4}, {3, 1}});
+        EXPECT_EQ(specialised({2, 1}), 0);
+
+        auto nested = jit.compose({h, base}, {1});
+        EXPECT_EQ(nested({1, 5, 4, 3, 10}), 10 * 3 + (8 - 8 / 3));
+
+        // A pipeline of a single function behaves like the function
+        EXPECT_EQ(jit.compose({base}, {})({2, 1}), 7);
+
+        // Constant stages make the pipeline constant
+        auto constant = jit.compose({jit.registerFunction("BEGIN\nRETURN 6\nEND.\n"), jit.registerFunction("PARAM x;\nBEGIN\nRETURN x / 2\nEND.\n")}, {0});
+        EXPECT_EQ(constant({}), 3);
+        EXPECT_EQ(jit.isConstant(constant), level != OptimisationLevel::O0);
+    }
+}
+
+TEST(Pljit, ComposeErrors) {
+
+    Pljit jit{};
+    Pljit other{};
+
+    auto base = jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN a * 3 + b\nEND.\n");
+    auto invalid = jit.registerFunction("BEGIN\nRETURN x\nEND.\n");
+
+    EXPECT_EQ(jit.compose({}, {})({}), nullopt);
+    EXPECT_EQ(jit.compose({base, base}, {})({1, 2, 3}), nullopt);
+    EXPECT_EQ(jit.compose({base, base}, {2})({1, 2, 3}), nullopt);
+    EXPECT_EQ(jit.compose({base, invalid}, {0})({1, 2}), nullopt);
+    EXPECT_EQ(jit.compose({base, other.registerFunction("PARAM a;\nBEGIN\nRETURN a\nEND.\n")}, {0})({1, 2}), nullopt);
+    EXPECT_TRUE(jit.getPassStatistics(jit.compose({base, base}, {2})).empty());
+}
+
+TEST(Pljit, MultipleResults) {
+
+    string code = "PARAM a, b, c;\nVAR s;\nBEGIN\ns := (a + b) * (b + c);\nRETURN s + 1, s / c, s * 2 - a\nEND.\n";
+
+    for (OptimisationLevel level : {OptimisationLevel::O0, OptimisationLevel::O1, OptimisationLevel::O2}) {
+
+        Pljit jit{Pljit::defaultMaxNestingDepth, 2, level};
+        auto h = jit.registerFunction(code, "triple");
+
+        vector<int64_t> results{};
+
+        for (int64_t c = -2; c <= 2; ++c) {
+
+            int64_t s = (3 + 4) * (4 + c);
+
+            // A failing value makes the whole call fail
+            if (c == 0) {
+                EXPECT_FALSE(h({3, 4, c}, results));
+                EXPECT_EQ(h({3, 4, c}), nullopt);
+                continue;
+            }
+
+            ASSERT_TRUE(h({3, 4, c}, results));
+            EXPECT_EQ(results, (vector<int64_t>{s + 1, s / c, s * 2 - 3}));
+        }
+
+        // The results of the guarded function (the calls above have been profiled)
+        ASSERT_TRUE(h({3, 4, 1}, results));
+        EXPECT_EQ(results, (vector<int64_t>{36, 35, 67}));
+
+        EXPECT_FALSE(h({3, 4}, results));
+
+        // Specialised and composed functions return all values of the (last) function
+        ASSERT_TRUE(jit.specialize(h, {{0, 1}})({1, 1}, results));
+        EXPECT_EQ(results, (vector<int64_t>{5, 4, 7}));
+
+        auto pipeline = jit.compose({h, h}, {2});
+        ASSERT_TRUE(pipeline({1, 1, 1, 2, 3}, results));
+        EXPECT_EQ(results, (vector<int64_t>{41, 8, 78}));
+
+        // A single value is returned by the ()-operator with a single argument
+        EXPECT_EQ(pipeline({1, 1, 1, 2, 3}), 41);
+
+        // A function returning several values cannot be called
+        EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN CALL triple(1, 2, 3)\nEND.\n")({}), nullopt);
+    }
+}
+
+TEST(Pljit, Conditionals) {
+
+    string clamp = "PARAM x, lo, hi;\nBEGIN\nRETURN MIN(MAX(x, lo), hi)\nEND.\n";
+    string code = "PARAM a, b;\n"
+                  "VAR q;\n"
+                  "BEGIN\n"
+                  "q := IF b = 0 THEN 0 ELSE a / b;\n"
+                  "RETURN CALL clamp(q, -5, 5) + (IF a < b THEN ABS(a - b) ELSE CALL divide(a, b - 2))\n"
+                  "END.\n";
+
+    int64_t min = numeric_limits<int64_t>::min();
+
+    for (OptimisationLevel level : {OptimisationLevel::O0, OptimisationLevel::O1, OptimisationLevel::O2}) {
+
+        Pljit jit{Pljit::defaultMaxNestingDepth, 0, level};
+
+        jit.registerFunction(clamp, "clamp");
+        jit.registerFunction("PARAM a, b;\nBEGIN\nRETURN a / b\nEND.\n", "divide");
+
+        auto h = jit.registerFunction(code);
+
+        // Only the selected alternative can fail
+        for (int64_t a = -4; a <= 4; ++a) {
+            for (int64_t b = -4; b <= 4; ++b) {
+                int64_t q = b == 0 ? 0 : a / b;
+                int64_t clamped = q < -5 ? -5 : (q > 5 ? 5 : q);
+                optional<int64_t> expected{};
+                if (a < b)
+                    expected = clamped + (b - a);
+                else if (b != 2)
+                    expected = clamped + a / (b - 2);
+                EXPECT_EQ(h({a, b}), expected);
+            }
+        }
+
+        // The absolute value of the minimal value wraps around
+        EXPECT_EQ(jit.registerFunction("PARAM a;\nBEGIN\nRETURN ABS(a)\nEND.\n")({min}), min);
+
+        auto hconst = jit.registerFunction("BEGIN\nRETURN IF MAX(3, 4) <= ABS(-4) THEN MIN(1, 2) ELSE 1 / 0\nEND.\n");
+        EXPECT_EQ(hconst({}), 1);
+        if (level != OptimisationLevel::O0) {
+            EXPECT_TRUE(jit.isConstant(hconst));
+        }
+
+        // Wrong numbers of arguments of intrinsics are errors
+        EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN ABS(1, 2)\nEND.\n")({}), nullopt);
+        EXPECT_EQ(jit.registerFunction("BEGIN\nRETURN MAX(1)\nEND.\n")({}), nullopt);
+    }
+}
+
+} // namespace jit::Tester_Pljit
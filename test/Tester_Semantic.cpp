@@ -215,7 +215,7 @@ TEST(SemanticAnalysis, TestAst) {
     // RETURN b * c
     s = st.statements[2].get();
     EXPECT_EQ(s->subtype, AstStatement::SubType::AstReturn);
-    ae = static_cast<AstReturn*>(s)->returnvalue.get();
+    ae = static_cast<AstReturn*>(s)->returnvalues.front().get();
     ASSERT_EQ(ae->subtype, AstArithmeticExpression::Subtype::Binary);
     EXPECT_EQ(static_cast<AstBinaryArithmeticExpression*>(ae)->op, AstBinaryArithmeticExpression::ArithmeticOperation::Mul);
 